@@ -0,0 +1,56 @@
+#pragma once
+
+#include <cstddef>
+
+namespace toolbox
+{
+namespace detail
+{
+
+/** Restores output to its size on construction unless dismissed, so that a
+ * decoder which throws part way through leaves what it appends to as is */
+template <typename Output>
+class AppendGuard
+{
+public:
+    explicit AppendGuard(Output& output);
+
+    AppendGuard(const AppendGuard&) = delete;
+
+    AppendGuard& operator=(const AppendGuard&) = delete;
+
+    ~AppendGuard();
+
+    /** Keep what was appended, once the decoder has succeeded */
+    void dismiss();
+
+private:
+    Output* output_;
+    std::size_t size_;
+};
+
+/********************************IMPLEMENTATION********************************/
+
+template <typename Output>
+AppendGuard<Output>::AppendGuard(Output& output)
+    : output_(&output), size_(output.size())
+{
+}
+
+template <typename Output>
+AppendGuard<Output>::~AppendGuard()
+{
+    if (output_)
+    {
+        output_->resize(size_);
+    }
+}
+
+template <typename Output>
+void AppendGuard<Output>::dismiss()
+{
+    output_ = nullptr;
+}
+
+} // namespace detail
+} // namespace toolbox
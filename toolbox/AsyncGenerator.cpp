@@ -0,0 +1 @@
+#include <toolbox/AsyncGenerator.h>
@@ -0,0 +1,383 @@
+#pragma once
+
+#include <coroutine>
+#include <cstddef>
+#include <exception>
+#include <iterator>
+#include <memory>
+#include <toolbox/FramePool.h>
+#include <type_traits>
+#include <utility>
+
+namespace toolbox
+{
+
+/** A lazily evaluated sequence produced by a coroutine which may co_await
+ * between values, e.g. to read the next page of a paginated source
+ *
+ * The consumer must itself be a coroutine: begin() and operator++ are
+ * awaited. Control passes between consumer and producer by symmetric
+ * transfer, so neither side grows the stack. While the producer is suspended
+ * on I/O the thread is free to do other work, and the consumer resumes as
+ * soon as the next value is yielded. Coroutine frames are recycled through
+ * FramePool
+ *
+ * Example:
+ * for (auto it = co_await pages.begin(); it != pages.end(); co_await ++it)
+ */
+template <typename T>
+class AsyncGenerator
+{
+public:
+    using value_type = std::remove_cvref_t<T>;
+    using reference =
+        std::conditional_t<std::is_reference<T>::value, T, T&>;
+    using pointer = std::add_pointer_t<reference>;
+
+    class promise_type;
+
+    using handle_type = std::coroutine_handle<promise_type>;
+
+    /** Resumes the consumer once the producer yields or finishes */
+    struct YieldAwaiter
+    {
+        bool await_ready() const noexcept;
+
+        std::coroutine_handle<> await_suspend(handle_type producer) noexcept;
+
+        void await_resume() const noexcept;
+    };
+
+    class promise_type : public PooledPromise
+    {
+    public:
+        AsyncGenerator get_return_object() noexcept;
+
+        std::suspend_always initial_suspend() const noexcept;
+
+        YieldAwaiter final_suspend() const noexcept;
+
+        YieldAwaiter yield_value(std::remove_reference_t<T>& value) noexcept;
+
+        YieldAwaiter yield_value(std::remove_reference_t<T>&& value) noexcept;
+
+        void return_void() noexcept;
+
+        void unhandled_exception() noexcept;
+
+        reference value() const noexcept;
+
+        void rethrow();
+
+        /** The coroutine awaiting the next value */
+        std::coroutine_handle<> consumer() const noexcept;
+
+        void consumer(std::coroutine_handle<> value) noexcept;
+
+    private:
+        pointer value_ = nullptr;
+        std::exception_ptr exception_;
+        std::coroutine_handle<> consumer_;
+    };
+
+    class iterator;
+
+    /** Resumes the producer on behalf of an awaiting consumer */
+    class AdvanceAwaiter
+    {
+    public:
+        explicit AdvanceAwaiter(handle_type producer) noexcept;
+
+        bool await_ready() const noexcept;
+
+        std::coroutine_handle<>
+        await_suspend(std::coroutine_handle<> consumer) noexcept;
+
+        iterator await_resume();
+
+    private:
+        handle_type producer_;
+    };
+
+    /** Input iterator over the yielded values */
+    class iterator
+    {
+    public:
+        using iterator_category = std::input_iterator_tag;
+        using value_type = AsyncGenerator::value_type;
+        using difference_type = std::ptrdiff_t;
+        using reference = AsyncGenerator::reference;
+        using pointer = AsyncGenerator::pointer;
+
+        iterator() noexcept = default;
+
+        explicit iterator(handle_type coroutine) noexcept;
+
+        /** Advance to the next value; must be awaited */
+        AdvanceAwaiter operator++() noexcept;
+
+        reference operator*() const noexcept;
+
+        pointer operator->() const noexcept;
+
+        bool operator==(const iterator& rhs) const noexcept;
+
+        bool operator!=(const iterator& rhs) const noexcept;
+
+    private:
+        handle_type coroutine_;
+
+        bool done() const noexcept;
+    };
+
+    AsyncGenerator() noexcept = default;
+
+    AsyncGenerator(const AsyncGenerator&) = delete;
+
+    AsyncGenerator(AsyncGenerator&& rhs) noexcept;
+
+    AsyncGenerator& operator=(const AsyncGenerator&) = delete;
+
+    AsyncGenerator& operator=(AsyncGenerator&& rhs) noexcept;
+
+    ~AsyncGenerator();
+
+    /** Run the coroutine to its first co_yield; must be awaited
+     *
+     * May be called at most once */
+    AdvanceAwaiter begin() noexcept;
+
+    iterator end() noexcept;
+
+private:
+    explicit AsyncGenerator(handle_type coroutine) noexcept;
+
+    handle_type coroutine_;
+};
+
+/********************************IMPLEMENTATION********************************/
+
+template <typename T>
+bool AsyncGenerator<T>::YieldAwaiter::await_ready() const noexcept
+{
+    return false;
+}
+
+template <typename T>
+std::coroutine_handle<>
+AsyncGenerator<T>::YieldAwaiter::await_suspend(handle_type producer) noexcept
+{
+    return producer.promise().consumer();
+}
+
+template <typename T>
+void AsyncGenerator<T>::YieldAwaiter::await_resume() const noexcept
+{
+}
+
+template <typename T>
+AsyncGenerator<T> AsyncGenerator<T>::promise_type::get_return_object() noexcept
+{
+    return AsyncGenerator(handle_type::from_promise(*this));
+}
+
+template <typename T>
+std::suspend_always
+AsyncGenerator<T>::promise_type::initial_suspend() const noexcept
+{
+    return {};
+}
+
+template <typename T>
+typename AsyncGenerator<T>::YieldAwaiter
+AsyncGenerator<T>::promise_type::final_suspend() const noexcept
+{
+    return {};
+}
+
+template <typename T>
+typename AsyncGenerator<T>::YieldAwaiter
+AsyncGenerator<T>::promise_type::yield_value(
+    std::remove_reference_t<T>& value) noexcept
+{
+    value_ = std::addressof(value);
+    return {};
+}
+
+template <typename T>
+typename AsyncGenerator<T>::YieldAwaiter
+AsyncGenerator<T>::promise_type::yield_value(
+    std::remove_reference_t<T>&& value) noexcept
+{
+    value_ = std::addressof(value);
+    return {};
+}
+
+template <typename T>
+void AsyncGenerator<T>::promise_type::return_void() noexcept
+{
+}
+
+template <typename T>
+void AsyncGenerator<T>::promise_type::unhandled_exception() noexcept
+{
+    exception_ = std::current_exception();
+}
+
+template <typename T>
+typename AsyncGenerator<T>::reference
+AsyncGenerator<T>::promise_type::value() const noexcept
+{
+    return static_cast<reference>(*value_);
+}
+
+template <typename T>
+void AsyncGenerator<T>::promise_type::rethrow()
+{
+    if (exception_)
+    {
+        std::rethrow_exception(std::exchange(exception_, nullptr));
+    }
+}
+
+template <typename T>
+std::coroutine_handle<>
+AsyncGenerator<T>::promise_type::consumer() const noexcept
+{
+    return consumer_;
+}
+
+template <typename T>
+void AsyncGenerator<T>::promise_type::consumer(
+    std::coroutine_handle<> value) noexcept
+{
+    consumer_ = value;
+}
+
+template <typename T>
+AsyncGenerator<T>::AdvanceAwaiter::AdvanceAwaiter(
+    handle_type producer) noexcept
+    : producer_(producer)
+{
+}
+
+template <typename T>
+bool AsyncGenerator<T>::AdvanceAwaiter::await_ready() const noexcept
+{
+    return !producer_;
+}
+
+template <typename T>
+std::coroutine_handle<> AsyncGenerator<T>::AdvanceAwaiter::await_suspend(
+    std::coroutine_handle<> consumer) noexcept
+{
+    producer_.promise().consumer(consumer);
+    return producer_;
+}
+
+template <typename T>
+typename AsyncGenerator<T>::iterator
+AsyncGenerator<T>::AdvanceAwaiter::await_resume()
+{
+    if (producer_)
+    {
+        producer_.promise().rethrow();
+    }
+    return iterator(producer_);
+}
+
+template <typename T>
+AsyncGenerator<T>::iterator::iterator(handle_type coroutine) noexcept
+    : coroutine_(coroutine)
+{
+}
+
+template <typename T>
+bool AsyncGenerator<T>::iterator::done() const noexcept
+{
+    return !coroutine_ || coroutine_.done();
+}
+
+template <typename T>
+typename AsyncGenerator<T>::AdvanceAwaiter
+AsyncGenerator<T>::iterator::operator++() noexcept
+{
+    return AdvanceAwaiter(coroutine_);
+}
+
+template <typename T>
+typename AsyncGenerator<T>::reference
+AsyncGenerator<T>::iterator::operator*() const noexcept
+{
+    return coroutine_.promise().value();
+}
+
+template <typename T>
+typename AsyncGenerator<T>::pointer
+AsyncGenerator<T>::iterator::operator->() const noexcept
+{
+    return std::addressof(**this);
+}
+
+template <typename T>
+bool AsyncGenerator<T>::iterator::operator==(const iterator& rhs) const
+    noexcept
+{
+    return done() ? rhs.done() : coroutine_ == rhs.coroutine_;
+}
+
+template <typename T>
+bool AsyncGenerator<T>::iterator::operator!=(const iterator& rhs) const
+    noexcept
+{
+    return !(*this == rhs);
+}
+
+template <typename T>
+AsyncGenerator<T>::AsyncGenerator(handle_type coroutine) noexcept
+    : coroutine_(coroutine)
+{
+}
+
+template <typename T>
+AsyncGenerator<T>::AsyncGenerator(AsyncGenerator&& rhs) noexcept
+    : coroutine_(std::exchange(rhs.coroutine_, nullptr))
+{
+}
+
+template <typename T>
+AsyncGenerator<T>& AsyncGenerator<T>::operator=(AsyncGenerator&& rhs) noexcept
+{
+    if (this != &rhs)
+    {
+        if (coroutine_)
+        {
+            coroutine_.destroy();
+        }
+        coroutine_ = std::exchange(rhs.coroutine_, nullptr);
+    }
+    return *this;
+}
+
+template <typename T>
+AsyncGenerator<T>::~AsyncGenerator()
+{
+    if (coroutine_)
+    {
+        coroutine_.destroy();
+    }
+}
+
+template <typename T>
+typename AsyncGenerator<T>::AdvanceAwaiter AsyncGenerator<T>::begin() noexcept
+{
+    return AdvanceAwaiter(coroutine_);
+}
+
+template <typename T>
+typename AsyncGenerator<T>::iterator AsyncGenerator<T>::end() noexcept
+{
+    return iterator();
+}
+
+} // namespace toolbox
@@ -0,0 +1,84 @@
+#include <toolbox/BufferPool.h>
+#include <utility>
+#include <vector>
+
+namespace toolbox
+{
+
+namespace
+{
+
+thread_local std::vector<std::string> idle_buffers;
+
+} // namespace
+
+PooledBuffer::PooledBuffer() : buffer_(BufferPool::take())
+{
+}
+
+PooledBuffer::PooledBuffer(PooledBuffer&& rhs) noexcept
+    : buffer_(std::move(rhs.buffer_))
+{
+}
+
+PooledBuffer& PooledBuffer::operator=(PooledBuffer&& rhs) noexcept
+{
+    buffer_.swap(rhs.buffer_);
+    return *this;
+}
+
+PooledBuffer::~PooledBuffer()
+{
+    BufferPool::give(std::move(buffer_));
+}
+
+std::string& PooledBuffer::operator*() noexcept
+{
+    return buffer_;
+}
+
+const std::string& PooledBuffer::operator*() const noexcept
+{
+    return buffer_;
+}
+
+std::string* PooledBuffer::operator->() noexcept
+{
+    return &buffer_;
+}
+
+const std::string* PooledBuffer::operator->() const noexcept
+{
+    return &buffer_;
+}
+
+PooledBuffer BufferPool::acquire()
+{
+    return PooledBuffer();
+}
+
+std::string BufferPool::take()
+{
+    if (idle_buffers.empty())
+    {
+        return std::string();
+    }
+    auto result = std::move(idle_buffers.back());
+    idle_buffers.pop_back();
+    return result;
+}
+
+void BufferPool::give(std::string buffer)
+{
+    /** Moved-from and never-grown buffers own no heap memory worth keeping */
+    auto capacity = buffer.capacity();
+    if (capacity <= std::string().capacity() || capacity > max_capacity ||
+        idle_buffers.size() >= max_idle)
+    {
+        return;
+    }
+    buffer.clear();
+    idle_buffers.push_back(std::move(buffer));
+}
+
+} // namespace toolbox
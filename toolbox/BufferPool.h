@@ -0,0 +1,66 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+namespace toolbox
+{
+
+/** A byte buffer borrowed from BufferPool which is returned on destruction
+ *
+ * The buffer keeps the capacity it grew to while borrowed, so the next
+ * borrower on the same thread can fill it without allocating */
+class PooledBuffer
+{
+public:
+    PooledBuffer();
+
+    PooledBuffer(const PooledBuffer&) = delete;
+
+    PooledBuffer(PooledBuffer&& rhs) noexcept;
+
+    PooledBuffer& operator=(const PooledBuffer&) = delete;
+
+    PooledBuffer& operator=(PooledBuffer&& rhs) noexcept;
+
+    ~PooledBuffer();
+
+    std::string& operator*() noexcept;
+
+    const std::string& operator*() const noexcept;
+
+    std::string* operator->() noexcept;
+
+    const std::string* operator->() const noexcept;
+
+private:
+    std::string buffer_;
+};
+
+/** Recycles output buffers through thread-local free lists
+ *
+ * Buffers are handed out empty and returned with their capacity intact.
+ * Buffers which grew beyond max_capacity are freed rather than retained, so
+ * one oversized message doesn't pin its memory indefinitely. A buffer may be
+ * returned on a different thread from the one which acquired it
+ */
+class BufferPool
+{
+public:
+    /** Largest capacity which is retained */
+    static constexpr std::size_t max_capacity = 1 << 20;
+
+    /** Maximum number of idle buffers retained per thread */
+    static constexpr std::size_t max_idle = 16;
+
+    /** Borrow an empty buffer */
+    static PooledBuffer acquire();
+
+    /** Take an idle buffer, or an empty one if there are none */
+    static std::string take();
+
+    /** Return a buffer to the current thread's free list */
+    static void give(std::string buffer);
+};
+
+} // namespace toolbox
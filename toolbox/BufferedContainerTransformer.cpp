@@ -0,0 +1 @@
+#include <toolbox/BufferedContainerTransformer.h>
@@ -0,0 +1,641 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+#include <numeric>
+#include <optional>
+#include <toolbox/ContainerTransformer.h>
+#include <toolbox/IteratorTransformer.h>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace toolbox
+{
+
+namespace detail
+{
+
+/** A write to an ordered container which has yet to be applied */
+template <typename Container>
+struct BufferedWrite
+{
+    enum class Kind
+    {
+        insert, /**< Insert unless the key is already present */
+        assign, /**< Insert, replacing any value with the same key */
+        erase   /**< Remove the key */
+    };
+
+    typename Container::key_type key;
+    Kind kind;
+    std::optional<typename Container::value_type> value;
+};
+
+/** Iterates over an ordered container and a sorted buffer of writes to it as
+ * though the writes had been applied */
+template <typename Container>
+class MergeIterator
+{
+public:
+    using write_type = BufferedWrite<Container>;
+    using buffer_iterator =
+        typename std::vector<write_type>::const_iterator;
+    using container_iterator = typename Container::const_iterator;
+    using iterator_category = std::input_iterator_tag;
+    using value_type = typename Container::value_type;
+    using difference_type = std::ptrdiff_t;
+    using reference = const value_type&;
+    using pointer = const value_type*;
+
+    MergeIterator() = default;
+
+    MergeIterator(container_iterator it,
+                  container_iterator end,
+                  buffer_iterator write,
+                  buffer_iterator write_end,
+                  typename Container::key_compare compare);
+
+    MergeIterator& operator++();
+
+    reference operator*() const;
+
+    pointer operator->() const;
+
+    bool operator==(const MergeIterator& rhs) const;
+
+    bool operator!=(const MergeIterator& rhs) const;
+
+private:
+    /** Where the current value comes from */
+    enum class Source
+    {
+        container,
+        write,
+        container_over_write, /**< Same key, write is an ignored insert */
+        write_over_container  /**< Same key, write replaces the value */
+    };
+
+    container_iterator it_;
+    container_iterator end_;
+    buffer_iterator write_;
+    buffer_iterator write_end_;
+    typename Container::key_compare compare_;
+    Source source_ = Source::container;
+
+    /** Skip erased keys and select the source of the next value */
+    void settle();
+};
+
+} // namespace detail
+
+/** A ContainerTransformer over an ordered container which buffers writes
+ *
+ * Inserts and erases are encoded immediately but appended to a flat buffer
+ * instead of the container. Once the buffer holds threshold writes, or on
+ * flush(), the buffer is sorted, collapsed so that each key has one write,
+ * and merged into the container in key order using hinted insertion. find,
+ * size and iteration see buffered writes by merging them on the fly.
+ *
+ * Any write invalidates iterators, since it may compact or flush the buffer.
+ * Even const access isn't thread safe, since find, size and iteration
+ * compact the buffer in place.
+ *
+ * Writes still buffered on destruction are flushed, so the container must
+ * outlive the transformer. Errors from that flush are swallowed, so call
+ * flush() explicitly to see them. Moving a transformer hands its buffer
+ * over, but copies are not allowed since both would later merge the same
+ * writes
+ */
+template <typename Container, typename Transform>
+class BufferedContainerTransformer
+{
+private:
+    Container* container_;
+    Transform transform_;
+
+public:
+    static_assert(detail::is_ordered_container<Container>::value,
+                  "BufferedContainerTransformer needs an ordered container");
+
+    using container_type = Container;
+    using value_type = std::decay_t<decltype(
+        transform_.second(typename container_type::value_type()))>;
+    using key_type = std::decay_t<decltype(
+        transform_.second(typename container_type::key_type()))>;
+    using size_type = typename container_type::size_type;
+    using const_iterator =
+        IteratorTransformer<typename Transform::second_type,
+                            detail::MergeIterator<Container>>;
+    using iterator = const_iterator;
+
+    explicit BufferedContainerTransformer(Container& container,
+                                          Transform transform = Transform(),
+                                          size_type threshold = 1024);
+
+    BufferedContainerTransformer(const BufferedContainerTransformer&) = delete;
+
+    BufferedContainerTransformer(BufferedContainerTransformer&& other);
+
+    BufferedContainerTransformer&
+    operator=(const BufferedContainerTransformer&) = delete;
+
+    /** Flush buffered writes, then take over those of other */
+    BufferedContainerTransformer&
+    operator=(BufferedContainerTransformer&& other);
+
+    /** Flush buffered writes into the container, ignoring any error */
+    ~BufferedContainerTransformer();
+
+    const_iterator begin() const;
+
+    const_iterator end() const;
+
+    const_iterator cbegin() const;
+
+    const_iterator cend() const;
+
+    const container_type& container() const;
+
+    /** Determine whether the container is empty, including buffered writes */
+    bool empty() const;
+
+    /** Get the number of values, including buffered writes */
+    size_type size() const;
+
+    /** Remove all values, discarding buffered writes */
+    void clear();
+
+    /** Buffer the insertion of an element */
+    void insert(const value_type& value);
+
+    /** Buffer the removal of an element */
+    void erase(const key_type& key);
+
+    /** Find an element, including buffered writes */
+    const_iterator find(const key_type& key) const;
+
+    /** Merge all buffered writes into the container
+     *
+     * If merging throws, the writes already merged are dropped from the
+     * buffer and the rest kept, so flushing again carries on from there */
+    void flush();
+
+    /** Get the number of buffered writes */
+    size_type buffered() const;
+
+    /** Get the number of buffered writes which triggers a flush */
+    size_type threshold() const;
+
+private:
+    using write_type = detail::BufferedWrite<Container>;
+    using kind_type = typename write_type::Kind;
+
+    mutable std::vector<write_type> buffer_;
+    mutable size_type sorted_; /**< Length of the sorted, collapsed prefix */
+    size_type threshold_;
+
+    void append(write_type write);
+
+    /** Sort the buffer and collapse it to one write per key */
+    void compact() const;
+
+    /** Position in the compacted buffer of the first write not before key */
+    typename std::vector<write_type>::const_iterator
+    lowerBound(const typename container_type::key_type& key) const;
+
+    const_iterator makeIterator(
+        typename container_type::const_iterator it,
+        typename std::vector<write_type>::const_iterator write) const;
+};
+
+/********************************IMPLEMENTATION********************************/
+
+namespace detail
+{
+
+template <typename Container>
+MergeIterator<Container>::MergeIterator(
+    container_iterator it,
+    container_iterator end,
+    buffer_iterator write,
+    buffer_iterator write_end,
+    typename Container::key_compare compare)
+    : it_(std::move(it)), end_(std::move(end)), write_(std::move(write)),
+      write_end_(std::move(write_end)), compare_(std::move(compare))
+{
+    settle();
+}
+
+template <typename Container>
+void MergeIterator<Container>::settle()
+{
+    source_ = Source::container;
+    while (write_ != write_end_)
+    {
+        auto has_value = it_ != end_;
+        if (has_value && compare_(key_of<Container>(*it_), write_->key))
+        {
+            return;
+        }
+        auto same =
+            has_value && !compare_(write_->key, key_of<Container>(*it_));
+        switch (write_->kind)
+        {
+            case write_type::Kind::erase:
+                ++write_;
+                if (same)
+                {
+                    ++it_;
+                }
+                break;
+            case write_type::Kind::assign:
+                source_ = same ? Source::write_over_container : Source::write;
+                return;
+            case write_type::Kind::insert:
+                source_ = same ? Source::container_over_write : Source::write;
+                return;
+        }
+    }
+}
+
+template <typename Container>
+MergeIterator<Container>& MergeIterator<Container>::operator++()
+{
+    switch (source_)
+    {
+        case Source::container:
+            ++it_;
+            break;
+        case Source::write:
+            ++write_;
+            break;
+        default:
+            ++it_;
+            ++write_;
+            break;
+    }
+    settle();
+    return *this;
+}
+
+template <typename Container>
+typename MergeIterator<Container>::reference
+MergeIterator<Container>::operator*() const
+{
+    auto from_write =
+        source_ == Source::write || source_ == Source::write_over_container;
+    return from_write ? *write_->value : *it_;
+}
+
+template <typename Container>
+typename MergeIterator<Container>::pointer
+MergeIterator<Container>::operator->() const
+{
+    return &**this;
+}
+
+template <typename Container>
+bool MergeIterator<Container>::operator==(const MergeIterator& rhs) const
+{
+    return it_ == rhs.it_ && write_ == rhs.write_;
+}
+
+template <typename Container>
+bool MergeIterator<Container>::operator!=(const MergeIterator& rhs) const
+{
+    return !(*this == rhs);
+}
+
+} // namespace detail
+
+template <typename Container, typename Transform>
+BufferedContainerTransformer<Container, Transform>::
+    BufferedContainerTransformer(Container& container,
+                                 Transform transform,
+                                 size_type threshold)
+    : container_(&container), transform_(std::move(transform)), sorted_(0),
+      threshold_(threshold)
+{
+    buffer_.reserve(threshold_);
+}
+
+template <typename Container, typename Transform>
+BufferedContainerTransformer<Container, Transform>::
+    BufferedContainerTransformer(BufferedContainerTransformer&& other)
+    : container_(std::exchange(other.container_, nullptr)),
+      transform_(std::move(other.transform_)),
+      buffer_(std::move(other.buffer_)),
+      sorted_(std::exchange(other.sorted_, 0)), threshold_(other.threshold_)
+{
+    other.buffer_.clear();
+}
+
+template <typename Container, typename Transform>
+BufferedContainerTransformer<Container, Transform>&
+BufferedContainerTransformer<Container, Transform>::operator=(
+    BufferedContainerTransformer&& other)
+{
+    if (this != &other)
+    {
+        if (container_)
+        {
+            flush();
+        }
+        container_ = std::exchange(other.container_, nullptr);
+        transform_ = std::move(other.transform_);
+        buffer_ = std::move(other.buffer_);
+        other.buffer_.clear();
+        sorted_ = std::exchange(other.sorted_, 0);
+        threshold_ = other.threshold_;
+    }
+    return *this;
+}
+
+template <typename Container, typename Transform>
+BufferedContainerTransformer<Container,
+                             Transform>::~BufferedContainerTransformer()
+{
+    /** A moved from transformer has no container and nothing to flush */
+    if (container_)
+    {
+        try
+        {
+            flush();
+        }
+        catch (...)
+        {
+            /** Destructors mustn't throw, so writes which can't be merged
+             * are lost */
+        }
+    }
+}
+
+template <typename Container, typename Transform>
+typename BufferedContainerTransformer<Container, Transform>::const_iterator
+BufferedContainerTransformer<Container, Transform>::makeIterator(
+    typename container_type::const_iterator it,
+    typename std::vector<write_type>::const_iterator write) const
+{
+    return const_iterator(
+        detail::MergeIterator<Container>(it, container_->cend(), write,
+                                         buffer_.cend(),
+                                         container_->key_comp()),
+        transform_.second);
+}
+
+template <typename Container, typename Transform>
+typename BufferedContainerTransformer<Container, Transform>::const_iterator
+BufferedContainerTransformer<Container, Transform>::cbegin() const
+{
+    compact();
+    return makeIterator(container_->cbegin(), buffer_.cbegin());
+}
+
+template <typename Container, typename Transform>
+typename BufferedContainerTransformer<Container, Transform>::const_iterator
+BufferedContainerTransformer<Container, Transform>::cend() const
+{
+    compact();
+    return makeIterator(container_->cend(), buffer_.cend());
+}
+
+template <typename Container, typename Transform>
+typename BufferedContainerTransformer<Container, Transform>::const_iterator
+BufferedContainerTransformer<Container, Transform>::begin() const
+{
+    return cbegin();
+}
+
+template <typename Container, typename Transform>
+typename BufferedContainerTransformer<Container, Transform>::const_iterator
+BufferedContainerTransformer<Container, Transform>::end() const
+{
+    return cend();
+}
+
+template <typename Container, typename Transform>
+const typename BufferedContainerTransformer<Container,
+                                            Transform>::container_type&
+BufferedContainerTransformer<Container, Transform>::container() const
+{
+    return *container_;
+}
+
+template <typename Container, typename Transform>
+bool BufferedContainerTransformer<Container, Transform>::empty() const
+{
+    return size() == 0;
+}
+
+template <typename Container, typename Transform>
+typename BufferedContainerTransformer<Container, Transform>::size_type
+BufferedContainerTransformer<Container, Transform>::size() const
+{
+    compact();
+    auto result = container_->size();
+    for (const auto& write : buffer_)
+    {
+        auto present = container_->find(write.key) != container_->end();
+        if (write.kind == kind_type::erase && present)
+        {
+            --result;
+        }
+        else if (write.kind != kind_type::erase && !present)
+        {
+            ++result;
+        }
+    }
+    return result;
+}
+
+template <typename Container, typename Transform>
+void BufferedContainerTransformer<Container, Transform>::clear()
+{
+    buffer_.clear();
+    sorted_ = 0;
+    container_->clear();
+}
+
+template <typename Container, typename Transform>
+void BufferedContainerTransformer<Container, Transform>::insert(
+    const value_type& value)
+{
+    typename container_type::value_type encoded(transform_.first(value));
+    auto key = detail::key_of<Container>(encoded);
+    append(write_type{std::move(key), kind_type::insert, std::move(encoded)});
+}
+
+template <typename Container, typename Transform>
+void BufferedContainerTransformer<Container, Transform>::erase(
+    const key_type& key)
+{
+    append(write_type{transform_.first(key), kind_type::erase, std::nullopt});
+}
+
+template <typename Container, typename Transform>
+void BufferedContainerTransformer<Container, Transform>::append(
+    write_type write)
+{
+    buffer_.push_back(std::move(write));
+    if (buffer_.size() >= threshold_)
+    {
+        flush();
+    }
+}
+
+template <typename Container, typename Transform>
+typename BufferedContainerTransformer<Container, Transform>::const_iterator
+BufferedContainerTransformer<Container, Transform>::find(
+    const key_type& key) const
+{
+    compact();
+    auto encoded = transform_.first(key);
+    auto compare = container_->key_comp();
+    auto result = makeIterator(container_->lower_bound(encoded),
+                               lowerBound(encoded));
+    auto end = cend();
+    if (result != end &&
+        compare(encoded, detail::key_of<Container>(*result.get())))
+    {
+        result = end;
+    }
+    return result;
+}
+
+template <typename Container, typename Transform>
+void BufferedContainerTransformer<Container, Transform>::flush()
+{
+    compact();
+    auto compare = container_->key_comp();
+    auto end = container_->end();
+    auto key = [](const auto& value) -> decltype(auto) {
+        return detail::key_of<Container>(value);
+    };
+    /** Writes are in key order, so the position following the previous write
+     * is usually the lower bound of the next and needn't be searched for */
+    auto hint = container_->begin();
+    auto applied = std::size_t(0);
+    try
+    {
+        for (; applied < buffer_.size(); ++applied)
+        {
+            auto& write = buffer_[applied];
+            if (hint != end && compare(key(*hint), write.key))
+            {
+                hint = container_->lower_bound(write.key);
+            }
+            auto present = hint != end && !compare(write.key, key(*hint));
+            if (write.kind == kind_type::insert && present)
+            {
+                ++hint;
+                continue;
+            }
+            if (present)
+            {
+                hint = container_->erase(hint);
+            }
+            if (write.kind != kind_type::erase)
+            {
+                hint = container_->insert(hint, std::move(*write.value));
+                ++hint;
+            }
+        }
+    }
+    catch (...)
+    {
+        /** Values of merged writes may have been moved from, so they mustn't
+         * be merged again */
+        auto first = std::next(buffer_.begin(),
+                               static_cast<std::ptrdiff_t>(applied));
+        buffer_ = std::vector<write_type>(std::make_move_iterator(first),
+                                          std::make_move_iterator(
+                                              buffer_.end()));
+        sorted_ = buffer_.size();
+        throw;
+    }
+    buffer_.clear();
+    sorted_ = 0;
+}
+
+template <typename Container, typename Transform>
+typename BufferedContainerTransformer<Container, Transform>::size_type
+BufferedContainerTransformer<Container, Transform>::buffered() const
+{
+    return buffer_.size();
+}
+
+template <typename Container, typename Transform>
+typename BufferedContainerTransformer<Container, Transform>::size_type
+BufferedContainerTransformer<Container, Transform>::threshold() const
+{
+    return threshold_;
+}
+
+template <typename Container, typename Transform>
+void BufferedContainerTransformer<Container, Transform>::compact() const
+{
+    if (sorted_ == buffer_.size())
+    {
+        return;
+    }
+    auto compare = container_->key_comp();
+    auto order = std::vector<size_type>(buffer_.size());
+    std::iota(order.begin(), order.end(), size_type(0));
+    auto by_key = [this, &compare](size_type lhs, size_type rhs) {
+        return compare(buffer_[lhs].key, buffer_[rhs].key);
+    };
+    auto middle =
+        std::next(order.begin(), static_cast<std::ptrdiff_t>(sorted_));
+    std::stable_sort(middle, order.end(), by_key);
+    std::inplace_merge(order.begin(), middle, order.end(), by_key);
+
+    /** Collapse the writes to each key, oldest first, into one write */
+    auto result = std::vector<write_type>();
+    result.reserve(std::max(threshold_, buffer_.size()));
+    for (auto first = order.begin(); first != order.end();)
+    {
+        auto last = std::find_if(first, order.end(), [&](size_type index) {
+            return by_key(*first, index);
+        });
+        auto kind = buffer_[*first].kind;
+        auto source = *first;
+        for (auto it = std::next(first); it != last; ++it)
+        {
+            auto next = buffer_[*it].kind;
+            if (next == kind_type::erase)
+            {
+                kind = kind_type::erase;
+                source = *it;
+            }
+            else if (kind == kind_type::erase)
+            {
+                kind = kind_type::assign;
+                source = *it;
+            }
+        }
+        auto& write = buffer_[source];
+        result.push_back(
+            write_type{std::move(write.key), kind, std::move(write.value)});
+        first = last;
+    }
+    buffer_ = std::move(result);
+    sorted_ = buffer_.size();
+}
+
+template <typename Container, typename Transform>
+auto BufferedContainerTransformer<Container, Transform>::lowerBound(
+    const typename container_type::key_type& key) const ->
+    typename std::vector<write_type>::const_iterator
+{
+    using encoded_key_type = typename container_type::key_type;
+    auto compare = container_->key_comp();
+    auto before = [&compare](const write_type& write,
+                             const encoded_key_type& value) {
+        return compare(write.key, value);
+    };
+    return std::lower_bound(buffer_.cbegin(), buffer_.cend(), key, before);
+}
+
+} // namespace toolbox
@@ -1,7 +1,30 @@
 #pragma once
 
+#include <ranges>
+#include <type_traits>
 #include <utility>
 
+namespace toolbox
+{
+namespace detail
+{
+
+/** A Decoder which declares static constexpr bool views_input = true returns
+ * results that refer into the input they were decoded from */
+template <typename Decoder, typename = void>
+struct views_input : std::false_type
+{
+};
+
+template <typename Decoder>
+struct views_input<Decoder, std::void_t<decltype(Decoder::views_input)>>
+    : std::bool_constant<Decoder::views_input>
+{
+};
+
+} // namespace detail
+} // namespace toolbox
+
 template <typename Encoder, typename Decoder>
 class Codec
 {
@@ -31,6 +54,25 @@ public:
     {
         return decoder_(input);
     }
+
+    /** Decode with every allocation of the result made from arena, e.g. a
+     * std::pmr::monotonic_buffer_resource, so that it is freed in one shot */
+    template <typename Input, typename Arena>
+    auto decode(const Input& input, Arena& arena)
+        -> decltype(decoder_(input, arena))
+    {
+        return decoder_(input, arena);
+    }
+
+    /** The result of a decoder which views its input would dangle if the
+     * input were a temporary owning its contents. Temporary views, such as
+     * std::string_view, are borrowed ranges and may be decoded */
+    template <typename Input,
+              typename = std::enable_if_t<
+                  !std::is_lvalue_reference_v<Input> &&
+                  !std::ranges::borrowed_range<Input> &&
+                  toolbox::detail::views_input<Decoder>::value>>
+    void decode(Input&& input) = delete;
 };
 
 template <typename Encoder, typename Decoder>
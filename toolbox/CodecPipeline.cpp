@@ -0,0 +1 @@
+#include <toolbox/CodecPipeline.h>
@@ -0,0 +1,278 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <span>
+#include <string>
+#include <string_view>
+#include <toolbox/Codec.h>
+#include <toolbox/StreamCodec.h>
+#include <tuple>
+#include <utility>
+
+namespace toolbox
+{
+
+/** Runs several streams one after another over small chunks
+ *
+ * Each chunk of input passes through every stage before the next chunk is
+ * read, so it stays in cache from the first stage to the last. Stages pass
+ * their output to the next through a buffer per stage boundary, which holds
+ * one chunk's worth of output and keeps its capacity between chunks and
+ * messages, so no stage materialises a whole intermediate message unless it
+ * has to see one, as with MessageStream.
+ *
+ * A CodecPipeline is itself a stream and also an Encoder or Decoder mapping
+ * a std::string_view to a std::string
+ */
+template <typename... Stages>
+class CodecPipeline
+{
+    static_assert(sizeof...(Stages) > 0, "A pipeline needs a stage");
+
+public:
+    using size_type = std::size_t;
+
+    /** Default number of input bytes which pass through the stages at once */
+    static constexpr size_type default_chunk_size = 1 << 14;
+
+    explicit CodecPipeline(std::tuple<Stages...> stages = {},
+                           size_type chunk_size = default_chunk_size);
+
+    void update(std::span<const char> input, std::string& output);
+
+    void finish(std::string& output);
+
+    size_type estimate(size_type input_size) const;
+
+    /** Discard any partial message held by the stages, such as after one
+     * threw */
+    void reset();
+
+    std::string operator()(std::string_view input);
+
+    void operator()(std::string_view input, std::string& output);
+
+    const std::tuple<Stages...>& stages() const;
+
+    size_type chunk_size() const;
+
+    /** Set the number of input bytes which pass through the stages at once */
+    void chunk_size(size_type value);
+
+private:
+    static constexpr size_type count = sizeof...(Stages);
+
+    std::tuple<Stages...> stages_;
+    std::array<std::string, count - 1> buffers_;
+    size_type chunk_size_;
+
+    /** Pass input through stage I and those after it */
+    template <std::size_t I>
+    void push(std::span<const char> input, std::string& output);
+
+    /** Finish stage I, passing what it flushes through those after it */
+    template <std::size_t I>
+    void drain(std::string& output);
+
+    template <std::size_t I>
+    size_type estimate(size_type input_size) const;
+
+    /** Reset stage I and those after it, and the buffers between them */
+    template <std::size_t I>
+    void reset();
+};
+
+namespace detail
+{
+
+template <typename... Stages>
+std::tuple<Stages...> stagesOf(const CodecPipeline<Stages...>& pipeline)
+{
+    return pipeline.stages();
+}
+
+template <typename Functor>
+auto stagesOf(const Functor& functor)
+{
+    return std::make_tuple(makeStream(functor));
+}
+
+template <typename... Stages>
+CodecPipeline<Stages...> makePipeline(std::tuple<Stages...> stages)
+{
+    return CodecPipeline<Stages...>(std::move(stages));
+}
+
+} // namespace detail
+
+/********************************IMPLEMENTATION********************************/
+
+template <typename... Stages>
+CodecPipeline<Stages...>::CodecPipeline(std::tuple<Stages...> stages,
+                                        size_type chunk_size)
+    : stages_(std::move(stages)),
+      chunk_size_(std::max<size_type>(chunk_size, 1))
+{
+}
+
+template <typename... Stages>
+template <std::size_t I>
+void CodecPipeline<Stages...>::push(std::span<const char> input,
+                                    std::string& output)
+{
+    if constexpr (I + 1 == count)
+    {
+        std::get<I>(stages_).update(input, output);
+    }
+    else
+    {
+        auto& buffer = buffers_[I];
+        std::get<I>(stages_).update(input, buffer);
+        if (!buffer.empty())
+        {
+            push<I + 1>(buffer, output);
+            buffer.clear();
+        }
+    }
+}
+
+template <typename... Stages>
+template <std::size_t I>
+void CodecPipeline<Stages...>::drain(std::string& output)
+{
+    if constexpr (I + 1 == count)
+    {
+        std::get<I>(stages_).finish(output);
+    }
+    else
+    {
+        auto& buffer = buffers_[I];
+        std::get<I>(stages_).finish(buffer);
+        if (!buffer.empty())
+        {
+            push<I + 1>(buffer, output);
+            buffer.clear();
+        }
+        drain<I + 1>(output);
+    }
+}
+
+template <typename... Stages>
+template <std::size_t I>
+typename CodecPipeline<Stages...>::size_type
+CodecPipeline<Stages...>::estimate(size_type input_size) const
+{
+    auto result = std::get<I>(stages_).estimate(input_size);
+    if constexpr (I + 1 == count)
+    {
+        return result;
+    }
+    else
+    {
+        return estimate<I + 1>(result);
+    }
+}
+
+template <typename... Stages>
+template <std::size_t I>
+void CodecPipeline<Stages...>::reset()
+{
+    using stage_type = std::tuple_element_t<I, std::tuple<Stages...>>;
+    if constexpr (detail::has_reset<stage_type>::value)
+    {
+        std::get<I>(stages_).reset();
+    }
+    if constexpr (I + 1 < count)
+    {
+        buffers_[I].clear();
+        reset<I + 1>();
+    }
+}
+
+template <typename... Stages>
+void CodecPipeline<Stages...>::update(std::span<const char> input,
+                                      std::string& output)
+{
+    while (!input.empty())
+    {
+        auto chunk = input.first(std::min(chunk_size_, input.size()));
+        push<0>(chunk, output);
+        input = input.subspan(chunk.size());
+    }
+}
+
+template <typename... Stages>
+void CodecPipeline<Stages...>::finish(std::string& output)
+{
+    drain<0>(output);
+}
+
+template <typename... Stages>
+typename CodecPipeline<Stages...>::size_type
+CodecPipeline<Stages...>::estimate(size_type input_size) const
+{
+    return estimate<0>(input_size);
+}
+
+template <typename... Stages>
+void CodecPipeline<Stages...>::reset()
+{
+    reset<0>();
+}
+
+template <typename... Stages>
+std::string CodecPipeline<Stages...>::operator()(std::string_view input)
+{
+    auto result = std::string();
+    (*this)(input, result);
+    return result;
+}
+
+template <typename... Stages>
+void CodecPipeline<Stages...>::operator()(std::string_view input,
+                                          std::string& output)
+{
+    process(*this, input, output);
+}
+
+template <typename... Stages>
+const std::tuple<Stages...>& CodecPipeline<Stages...>::stages() const
+{
+    return stages_;
+}
+
+template <typename... Stages>
+typename CodecPipeline<Stages...>::size_type
+CodecPipeline<Stages...>::chunk_size() const
+{
+    return chunk_size_;
+}
+
+template <typename... Stages>
+void CodecPipeline<Stages...>::chunk_size(size_type value)
+{
+    chunk_size_ = std::max<size_type>(value, 1);
+}
+
+} // namespace toolbox
+
+/** Chain two Codecs of bytes into one which encodes with lhs then rhs, and
+ * decodes with rhs then lhs, running the stages together over small chunks
+ *
+ * Chains of chains are flattened into a single CodecPipeline */
+template <typename LhsEncoder,
+          typename LhsDecoder,
+          typename RhsEncoder,
+          typename RhsDecoder>
+auto operator|(Codec<LhsEncoder, LhsDecoder> lhs,
+               Codec<RhsEncoder, RhsDecoder> rhs)
+{
+    using toolbox::detail::stagesOf;
+    auto encoder = toolbox::detail::makePipeline(
+        std::tuple_cat(stagesOf(lhs.encoder()), stagesOf(rhs.encoder())));
+    auto decoder = toolbox::detail::makePipeline(
+        std::tuple_cat(stagesOf(rhs.decoder()), stagesOf(lhs.decoder())));
+    return makeCodec(std::move(encoder), std::move(decoder));
+}
@@ -0,0 +1,809 @@
+#include <array>
+#include <bit>
+#include <cstring>
+#include <stdexcept>
+#include <toolbox/AppendGuard.h>
+#include <toolbox/Codecs.h>
+#include <toolbox/Simd.h>
+
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+#define TOOLBOX_X86_SIMD 1
+#include <immintrin.h>
+#endif
+
+namespace toolbox
+{
+
+namespace
+{
+
+const char* base64Alphabet(Base64Alphabet alphabet)
+{
+    return alphabet == Base64Alphabet::url
+               ? "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz"
+                 "0123456789-_"
+               : "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz"
+                 "0123456789+/";
+}
+
+/** Maps characters to their 6 bit values, or 0xff where invalid */
+using DecodeTable = std::array<unsigned char, 256>;
+
+DecodeTable makeDecodeTable(const char* alphabet, std::size_t size)
+{
+    auto result = DecodeTable();
+    result.fill(0xff);
+    for (std::size_t i = 0; i < size; ++i)
+    {
+        result[static_cast<unsigned char>(alphabet[i])] =
+            static_cast<unsigned char>(i);
+    }
+    return result;
+}
+
+const DecodeTable& base64DecodeTable(Base64Alphabet alphabet)
+{
+    static const auto standard =
+        makeDecodeTable(base64Alphabet(Base64Alphabet::standard), 64);
+    static const auto url =
+        makeDecodeTable(base64Alphabet(Base64Alphabet::url), 64);
+    return alphabet == Base64Alphabet::url ? url : standard;
+}
+
+const DecodeTable& hexDecodeTable()
+{
+    static const auto result = [] {
+        auto table = makeDecodeTable("0123456789abcdef", 16);
+        for (auto c = 'A'; c <= 'F'; ++c)
+        {
+            table[static_cast<unsigned char>(c)] =
+                static_cast<unsigned char>(c - 'A' + 10);
+        }
+        return table;
+    }();
+    return result;
+}
+
+const char hex_digits[] = "0123456789abcdef";
+
+/** Grow output by size bytes and get a pointer to the first of them */
+char* extend(std::string& output, std::size_t size)
+{
+    auto offset = output.size();
+    output.resize(offset + size);
+    return output.data() + offset;
+}
+
+/** Shrink output to end at end, which points into it */
+void truncate(std::string& output, const char* end)
+{
+    output.resize(static_cast<std::size_t>(end - output.data()));
+}
+
+#if defined(TOOLBOX_X86_SIMD)
+
+/** Vectorised kernels process whole blocks from the front of their input
+ * and return the number of input bytes consumed, leaving the tail and any
+ * invalid block for the scalar code to finish or report */
+
+__attribute__((target("ssse3"))) __m128i load128(const char* input)
+{
+    return _mm_loadu_si128(reinterpret_cast<const __m128i*>(input));
+}
+
+__attribute__((target("avx2"))) __m256i load256(const char* input)
+{
+    return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(input));
+}
+
+__attribute__((target("ssse3"))) __m128i
+base64Lookup(__m128i indices, Base64Alphabet alphabet)
+{
+    auto c62 = alphabet == Base64Alphabet::url ? '-' : '+';
+    auto c63 = alphabet == Base64Alphabet::url ? '_' : '/';
+    auto offsets = _mm_setr_epi8(
+        'a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+        '0' - 52, '0' - 52, '0' - 52, '0' - 52, static_cast<char>(c62 - 62),
+        static_cast<char>(c63 - 63), 'A', 0, 0);
+    /** 0-25 select 13, 26-51 select 0, 52-63 select 1-12 */
+    auto result = _mm_subs_epu8(indices, _mm_set1_epi8(51));
+    auto upper = _mm_cmpgt_epi8(_mm_set1_epi8(26), indices);
+    result = _mm_or_si128(result, _mm_and_si128(upper, _mm_set1_epi8(13)));
+    return _mm_add_epi8(_mm_shuffle_epi8(offsets, result), indices);
+}
+
+/** Spread 12 bytes into 16 lanes of 6 bits */
+__attribute__((target("ssse3"))) __m128i base64Split(__m128i input)
+{
+    auto split =
+        _mm_setr_epi8(1, 0, 2, 1, 4, 3, 5, 4, 7, 6, 8, 7, 10, 9, 11, 10);
+    input = _mm_shuffle_epi8(input, split);
+    auto high =
+        _mm_mulhi_epu16(_mm_and_si128(input, _mm_set1_epi32(0x0fc0fc00)),
+                        _mm_set1_epi32(0x04000040));
+    auto low =
+        _mm_mullo_epi16(_mm_and_si128(input, _mm_set1_epi32(0x003f03f0)),
+                        _mm_set1_epi32(0x01000010));
+    return _mm_or_si128(high, low);
+}
+
+__attribute__((target("ssse3"))) std::size_t encodeBase64Ssse3(
+    const char* input, std::size_t size, char* output, Base64Alphabet alphabet)
+{
+    std::size_t i = 0;
+    for (; size - i >= 16; i += 12, output += 16)
+    {
+        auto block = load128(input + i);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(output),
+                         base64Lookup(base64Split(block), alphabet));
+    }
+    return i;
+}
+
+__attribute__((target("avx2"))) std::size_t encodeBase64Avx2(
+    const char* input, std::size_t size, char* output, Base64Alphabet alphabet)
+{
+    auto c62 = alphabet == Base64Alphabet::url ? '-' : '+';
+    auto c63 = alphabet == Base64Alphabet::url ? '_' : '/';
+    auto offsets = _mm256_broadcastsi128_si256(_mm_setr_epi8(
+        'a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+        '0' - 52, '0' - 52, '0' - 52, '0' - 52, static_cast<char>(c62 - 62),
+        static_cast<char>(c63 - 63), 'A', 0, 0));
+    auto split = _mm256_broadcastsi128_si256(
+        _mm_setr_epi8(1, 0, 2, 1, 4, 3, 5, 4, 7, 6, 8, 7, 10, 9, 11, 10));
+    std::size_t i = 0;
+    /** Each lane takes 12 bytes, so the second load overlaps the first */
+    for (; size - i >= 28; i += 24, output += 32)
+    {
+        auto low = load128(input + i);
+        auto high = load128(input + i + 12);
+        auto block = _mm256_shuffle_epi8(
+            _mm256_inserti128_si256(_mm256_castsi128_si256(low), high, 1),
+            split);
+        auto indices = _mm256_or_si256(
+            _mm256_mulhi_epu16(
+                _mm256_and_si256(block, _mm256_set1_epi32(0x0fc0fc00)),
+                _mm256_set1_epi32(0x04000040)),
+            _mm256_mullo_epi16(
+                _mm256_and_si256(block, _mm256_set1_epi32(0x003f03f0)),
+                _mm256_set1_epi32(0x01000010)));
+        auto select = _mm256_subs_epu8(indices, _mm256_set1_epi8(51));
+        auto upper = _mm256_cmpgt_epi8(_mm256_set1_epi8(26), indices);
+        select = _mm256_or_si256(
+            select, _mm256_and_si256(upper, _mm256_set1_epi8(13)));
+        auto result =
+            _mm256_add_epi8(_mm256_shuffle_epi8(offsets, select), indices);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(output), result);
+    }
+    return i;
+}
+
+/** Mask of the bytes of input in [low, high] */
+__attribute__((target("ssse3"))) __m128i inRange(__m128i input,
+                                                 char low,
+                                                 char high)
+{
+    return _mm_and_si128(
+        _mm_cmpgt_epi8(input, _mm_set1_epi8(static_cast<char>(low - 1))),
+        _mm_cmpgt_epi8(_mm_set1_epi8(static_cast<char>(high + 1)), input));
+}
+
+__attribute__((target("avx2"))) __m256i inRange(__m256i input,
+                                                char low,
+                                                char high)
+{
+    return _mm256_and_si256(
+        _mm256_cmpgt_epi8(input, _mm256_set1_epi8(static_cast<char>(low - 1))),
+        _mm256_cmpgt_epi8(_mm256_set1_epi8(static_cast<char>(high + 1)),
+                          input));
+}
+
+/** Convert base64 characters to their 6 bit values, returning false if any
+ * is invalid */
+__attribute__((target("ssse3"))) bool
+base64Values(__m128i& block, Base64Alphabet alphabet)
+{
+    auto c62 = alphabet == Base64Alphabet::url ? '-' : '+';
+    auto c63 = alphabet == Base64Alphabet::url ? '_' : '/';
+    auto upper = inRange(block, 'A', 'Z');
+    auto lower = inRange(block, 'a', 'z');
+    auto digit = inRange(block, '0', '9');
+    auto is62 = _mm_cmpeq_epi8(block, _mm_set1_epi8(c62));
+    auto is63 = _mm_cmpeq_epi8(block, _mm_set1_epi8(c63));
+    auto valid = _mm_or_si128(_mm_or_si128(upper, lower),
+                              _mm_or_si128(digit, _mm_or_si128(is62, is63)));
+    if (_mm_movemask_epi8(valid) != 0xffff)
+    {
+        return false;
+    }
+    auto shift = _mm_or_si128(
+        _mm_or_si128(_mm_and_si128(upper, _mm_set1_epi8(-'A')),
+                     _mm_and_si128(lower, _mm_set1_epi8(26 - 'a'))),
+        _mm_or_si128(
+            _mm_and_si128(digit, _mm_set1_epi8(52 - '0')),
+            _mm_or_si128(
+                _mm_and_si128(is62,
+                              _mm_set1_epi8(static_cast<char>(62 - c62))),
+                _mm_and_si128(is63,
+                              _mm_set1_epi8(static_cast<char>(63 - c63))))));
+    block = _mm_add_epi8(block, shift);
+    return true;
+}
+
+__attribute__((target("avx2"))) bool base64Values(__m256i& block,
+                                                  Base64Alphabet alphabet)
+{
+    auto c62 = alphabet == Base64Alphabet::url ? '-' : '+';
+    auto c63 = alphabet == Base64Alphabet::url ? '_' : '/';
+    auto upper = inRange(block, 'A', 'Z');
+    auto lower = inRange(block, 'a', 'z');
+    auto digit = inRange(block, '0', '9');
+    auto is62 = _mm256_cmpeq_epi8(block, _mm256_set1_epi8(c62));
+    auto is63 = _mm256_cmpeq_epi8(block, _mm256_set1_epi8(c63));
+    auto valid = _mm256_or_si256(
+        _mm256_or_si256(upper, lower),
+        _mm256_or_si256(digit, _mm256_or_si256(is62, is63)));
+    if (_mm256_movemask_epi8(valid) != -1)
+    {
+        return false;
+    }
+    auto shift = _mm256_or_si256(
+        _mm256_or_si256(_mm256_and_si256(upper, _mm256_set1_epi8(-'A')),
+                        _mm256_and_si256(lower, _mm256_set1_epi8(26 - 'a'))),
+        _mm256_or_si256(
+            _mm256_and_si256(digit, _mm256_set1_epi8(52 - '0')),
+            _mm256_or_si256(
+                _mm256_and_si256(
+                    is62, _mm256_set1_epi8(static_cast<char>(62 - c62))),
+                _mm256_and_si256(
+                    is63, _mm256_set1_epi8(static_cast<char>(63 - c63))))));
+    block = _mm256_add_epi8(block, shift);
+    return true;
+}
+
+__attribute__((target("ssse3"))) std::size_t decodeBase64Ssse3(
+    const char* input, std::size_t size, char* output, Base64Alphabet alphabet)
+{
+    /** Merge 4 lanes of 6 bits into 3 bytes in the low end of each dword */
+    auto pack = _mm_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1,
+                              -1, -1);
+    alignas(16) char packed[16];
+    std::size_t i = 0;
+    for (; size - i >= 16; i += 16, output += 12)
+    {
+        auto block = load128(input + i);
+        if (!base64Values(block, alphabet))
+        {
+            break;
+        }
+        block = _mm_maddubs_epi16(block, _mm_set1_epi32(0x01400140));
+        block = _mm_madd_epi16(block, _mm_set1_epi32(0x00011000));
+        _mm_store_si128(reinterpret_cast<__m128i*>(packed),
+                        _mm_shuffle_epi8(block, pack));
+        std::memcpy(output, packed, 12);
+    }
+    return i;
+}
+
+__attribute__((target("avx2"))) std::size_t decodeBase64Avx2(
+    const char* input, std::size_t size, char* output, Base64Alphabet alphabet)
+{
+    auto pack = _mm256_broadcastsi128_si256(_mm_setr_epi8(
+        2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1));
+    alignas(32) char packed[32];
+    std::size_t i = 0;
+    for (; size - i >= 32; i += 32, output += 24)
+    {
+        auto block = load256(input + i);
+        if (!base64Values(block, alphabet))
+        {
+            break;
+        }
+        block = _mm256_maddubs_epi16(block, _mm256_set1_epi32(0x01400140));
+        block = _mm256_madd_epi16(block, _mm256_set1_epi32(0x00011000));
+        _mm256_store_si256(reinterpret_cast<__m256i*>(packed),
+                           _mm256_shuffle_epi8(block, pack));
+        std::memcpy(output, packed, 12);
+        std::memcpy(output + 12, packed + 16, 12);
+    }
+    return i;
+}
+
+__attribute__((target("ssse3"))) std::size_t
+encodeHexSsse3(const char* input, std::size_t size, char* output)
+{
+    auto digits = load128(hex_digits);
+    auto nibble = _mm_set1_epi8(0x0f);
+    std::size_t i = 0;
+    for (; size - i >= 16; i += 16, output += 32)
+    {
+        auto block = load128(input + i);
+        auto high = _mm_shuffle_epi8(
+            digits, _mm_and_si128(_mm_srli_epi16(block, 4), nibble));
+        auto low = _mm_shuffle_epi8(digits, _mm_and_si128(block, nibble));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(output),
+                         _mm_unpacklo_epi8(high, low));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(output + 16),
+                         _mm_unpackhi_epi8(high, low));
+    }
+    return i;
+}
+
+__attribute__((target("avx2"))) std::size_t
+encodeHexAvx2(const char* input, std::size_t size, char* output)
+{
+    auto digits = _mm256_broadcastsi128_si256(load128(hex_digits));
+    auto nibble = _mm256_set1_epi8(0x0f);
+    std::size_t i = 0;
+    for (; size - i >= 32; i += 32, output += 64)
+    {
+        auto block = load256(input + i);
+        auto high = _mm256_shuffle_epi8(
+            digits, _mm256_and_si256(_mm256_srli_epi16(block, 4), nibble));
+        auto low =
+            _mm256_shuffle_epi8(digits, _mm256_and_si256(block, nibble));
+        /** Interleaving works within lanes, so reorder the lanes after */
+        auto first = _mm256_unpacklo_epi8(high, low);
+        auto second = _mm256_unpackhi_epi8(high, low);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(output),
+                            _mm256_permute2x128_si256(first, second, 0x20));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(output + 32),
+                            _mm256_permute2x128_si256(first, second, 0x31));
+    }
+    return i;
+}
+
+__attribute__((target("ssse3"))) std::size_t
+decodeHexSsse3(const char* input, std::size_t size, char* output)
+{
+    std::size_t i = 0;
+    for (; size - i >= 16; i += 16, output += 8)
+    {
+        auto block = load128(input + i);
+        auto digit = inRange(block, '0', '9');
+        auto lower = inRange(block, 'a', 'f');
+        auto upper = inRange(block, 'A', 'F');
+        auto valid = _mm_or_si128(digit, _mm_or_si128(lower, upper));
+        if (_mm_movemask_epi8(valid) != 0xffff)
+        {
+            break;
+        }
+        auto shift = _mm_or_si128(
+            _mm_and_si128(digit, _mm_set1_epi8(-'0')),
+            _mm_or_si128(_mm_and_si128(lower, _mm_set1_epi8(10 - 'a')),
+                         _mm_and_si128(upper, _mm_set1_epi8(10 - 'A'))));
+        block = _mm_add_epi8(block, shift);
+        /** Each pair of nibbles becomes high * 16 + low in a word */
+        block = _mm_maddubs_epi16(block, _mm_set1_epi16(0x0110));
+        _mm_storel_epi64(reinterpret_cast<__m128i*>(output),
+                         _mm_packus_epi16(block, block));
+    }
+    return i;
+}
+
+__attribute__((target("avx2"))) std::size_t
+decodeHexAvx2(const char* input, std::size_t size, char* output)
+{
+    std::size_t i = 0;
+    for (; size - i >= 32; i += 32, output += 16)
+    {
+        auto block = load256(input + i);
+        auto digit = inRange(block, '0', '9');
+        auto lower = inRange(block, 'a', 'f');
+        auto upper = inRange(block, 'A', 'F');
+        auto valid = _mm256_or_si256(digit, _mm256_or_si256(lower, upper));
+        if (_mm256_movemask_epi8(valid) != -1)
+        {
+            break;
+        }
+        auto shift = _mm256_or_si256(
+            _mm256_and_si256(digit, _mm256_set1_epi8(-'0')),
+            _mm256_or_si256(
+                _mm256_and_si256(lower, _mm256_set1_epi8(10 - 'a')),
+                _mm256_and_si256(upper, _mm256_set1_epi8(10 - 'A'))));
+        block = _mm256_add_epi8(block, shift);
+        block = _mm256_maddubs_epi16(block, _mm256_set1_epi16(0x0110));
+        /** Packing works within lanes, so gather each lane's low half */
+        block = _mm256_permute4x64_epi64(_mm256_packus_epi16(block, block),
+                                         0x08);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(output),
+                         _mm256_castsi256_si128(block));
+    }
+    return i;
+}
+
+#endif
+
+} // namespace
+
+Base64Encoder::Base64Encoder(Base64Alphabet alphabet, bool padding)
+    : alphabet_(alphabet), padding_(padding)
+{
+}
+
+std::string Base64Encoder::operator()(std::string_view input) const
+{
+    auto result = std::string();
+    (*this)(input, result);
+    return result;
+}
+
+void Base64Encoder::operator()(std::string_view input,
+                               std::string& output) const
+{
+    auto out = extend(output, max_size(input.size()));
+    auto data = input.data();
+    auto size = input.size();
+    std::size_t i = 0;
+#if defined(TOOLBOX_X86_SIMD)
+    auto level = simdLevel();
+    if (level >= SimdLevel::avx2)
+    {
+        auto consumed = encodeBase64Avx2(data, size, out, alphabet_);
+        out += consumed / 3 * 4;
+        i += consumed;
+    }
+    if (level >= SimdLevel::ssse3)
+    {
+        auto consumed = encodeBase64Ssse3(data + i, size - i, out, alphabet_);
+        out += consumed / 3 * 4;
+        i += consumed;
+    }
+#endif
+    auto alphabet = base64Alphabet(alphabet_);
+    auto byte = [data](std::size_t index) {
+        return static_cast<unsigned char>(data[index]);
+    };
+    for (; size - i >= 3; i += 3)
+    {
+        auto triple = byte(i) << 16 | byte(i + 1) << 8 | byte(i + 2);
+        *out++ = alphabet[triple >> 18 & 0x3f];
+        *out++ = alphabet[triple >> 12 & 0x3f];
+        *out++ = alphabet[triple >> 6 & 0x3f];
+        *out++ = alphabet[triple & 0x3f];
+    }
+    if (i < size)
+    {
+        auto remaining = size - i;
+        auto triple = byte(i) << 16 | (remaining > 1 ? byte(i + 1) << 8 : 0);
+        *out++ = alphabet[triple >> 18 & 0x3f];
+        *out++ = alphabet[triple >> 12 & 0x3f];
+        if (remaining > 1)
+        {
+            *out++ = alphabet[triple >> 6 & 0x3f];
+        }
+        if (padding_)
+        {
+            *out++ = '=';
+            if (remaining == 1)
+            {
+                *out++ = '=';
+            }
+        }
+    }
+    truncate(output, out);
+}
+
+std::size_t Base64Encoder::max_size(std::size_t size) const
+{
+    return (size + 2) / 3 * 4;
+}
+
+Base64Decoder::Base64Decoder(Base64Alphabet alphabet) : alphabet_(alphabet)
+{
+}
+
+std::string Base64Decoder::operator()(std::string_view input) const
+{
+    auto result = std::string();
+    (*this)(input, result);
+    return result;
+}
+
+void Base64Decoder::operator()(std::string_view input,
+                               std::string& output) const
+{
+    auto padding = std::size_t(0);
+    while (padding < 2 && !input.empty() && input.back() == '=')
+    {
+        input.remove_suffix(1);
+        ++padding;
+    }
+    if ((padding > 0 && (input.size() + padding) % 4 != 0) ||
+        input.size() % 4 == 1)
+    {
+        throw std::invalid_argument("Base64Decoder: invalid length");
+    }
+    auto guard = detail::AppendGuard(output);
+    auto out = extend(output, max_size(input.size()));
+    auto data = input.data();
+    auto size = input.size();
+    std::size_t i = 0;
+#if defined(TOOLBOX_X86_SIMD)
+    auto level = simdLevel();
+    if (level >= SimdLevel::avx2)
+    {
+        auto consumed = decodeBase64Avx2(data, size, out, alphabet_);
+        out += consumed / 4 * 3;
+        i += consumed;
+    }
+    if (level >= SimdLevel::ssse3)
+    {
+        auto consumed = decodeBase64Ssse3(data + i, size - i, out, alphabet_);
+        out += consumed / 4 * 3;
+        i += consumed;
+    }
+#endif
+    const auto& table = base64DecodeTable(alphabet_);
+    auto value = [&table, data](std::size_t index) {
+        auto result = table[static_cast<unsigned char>(data[index])];
+        if (result > 63)
+        {
+            throw std::invalid_argument("Base64Decoder: invalid character");
+        }
+        return static_cast<unsigned>(result);
+    };
+    for (; size - i >= 4; i += 4)
+    {
+        auto quad = value(i) << 18 | value(i + 1) << 12 | value(i + 2) << 6 |
+                    value(i + 3);
+        *out++ = static_cast<char>(quad >> 16);
+        *out++ = static_cast<char>(quad >> 8);
+        *out++ = static_cast<char>(quad);
+    }
+    if (i < size)
+    {
+        auto remaining = size - i;
+        auto quad = value(i) << 18 | value(i + 1) << 12 |
+                    (remaining > 2 ? value(i + 2) << 6 : 0);
+        *out++ = static_cast<char>(quad >> 16);
+        if (remaining > 2)
+        {
+            *out++ = static_cast<char>(quad >> 8);
+        }
+    }
+    truncate(output, out);
+    guard.dismiss();
+}
+
+std::size_t Base64Decoder::max_size(std::size_t size) const
+{
+    return (size + 3) / 4 * 3;
+}
+
+std::string HexEncoder::operator()(std::string_view input) const
+{
+    auto result = std::string();
+    (*this)(input, result);
+    return result;
+}
+
+void HexEncoder::operator()(std::string_view input, std::string& output) const
+{
+    auto out = extend(output, max_size(input.size()));
+    auto data = input.data();
+    auto size = input.size();
+    std::size_t i = 0;
+#if defined(TOOLBOX_X86_SIMD)
+    auto level = simdLevel();
+    if (level >= SimdLevel::avx2)
+    {
+        auto consumed = encodeHexAvx2(data, size, out);
+        out += 2 * consumed;
+        i += consumed;
+    }
+    if (level >= SimdLevel::ssse3)
+    {
+        auto consumed = encodeHexSsse3(data + i, size - i, out);
+        out += 2 * consumed;
+        i += consumed;
+    }
+#endif
+    for (; i < size; ++i)
+    {
+        auto byte = static_cast<unsigned char>(data[i]);
+        *out++ = hex_digits[byte >> 4];
+        *out++ = hex_digits[byte & 0xf];
+    }
+}
+
+std::size_t HexEncoder::max_size(std::size_t size) const
+{
+    return 2 * size;
+}
+
+std::string HexDecoder::operator()(std::string_view input) const
+{
+    auto result = std::string();
+    (*this)(input, result);
+    return result;
+}
+
+void HexDecoder::operator()(std::string_view input, std::string& output) const
+{
+    if (input.size() % 2 != 0)
+    {
+        throw std::invalid_argument("HexDecoder: odd length");
+    }
+    auto guard = detail::AppendGuard(output);
+    auto out = extend(output, max_size(input.size()));
+    auto data = input.data();
+    auto size = input.size();
+    std::size_t i = 0;
+#if defined(TOOLBOX_X86_SIMD)
+    auto level = simdLevel();
+    if (level >= SimdLevel::avx2)
+    {
+        auto consumed = decodeHexAvx2(data, size, out);
+        out += consumed / 2;
+        i += consumed;
+    }
+    if (level >= SimdLevel::ssse3)
+    {
+        auto consumed = decodeHexSsse3(data + i, size - i, out);
+        out += consumed / 2;
+        i += consumed;
+    }
+#endif
+    const auto& table = hexDecodeTable();
+    for (; i < size; i += 2)
+    {
+        auto high = table[static_cast<unsigned char>(data[i])];
+        auto low = table[static_cast<unsigned char>(data[i + 1])];
+        if ((high | low) > 15)
+        {
+            throw std::invalid_argument("HexDecoder: invalid character");
+        }
+        *out++ = static_cast<char>(high << 4 | low);
+    }
+    guard.dismiss();
+}
+
+std::size_t HexDecoder::max_size(std::size_t size) const
+{
+    return size / 2;
+}
+
+std::string VarintEncoder::operator()(std::uint64_t value) const
+{
+    auto result = std::string();
+    (*this)(value, result);
+    return result;
+}
+
+void VarintEncoder::operator()(std::uint64_t value, std::string& output) const
+{
+    char buffer[max_length];
+    auto length = std::size_t(0);
+    for (; value >= 0x80; value >>= 7)
+    {
+        buffer[length++] = static_cast<char>(value | 0x80);
+    }
+    buffer[length++] = static_cast<char>(value);
+    output.append(buffer, length);
+}
+
+void VarintEncoder::operator()(std::span<const std::uint64_t> values,
+                               std::string& output) const
+{
+    auto out = extend(output, max_length * values.size());
+    for (auto value : values)
+    {
+        for (; value >= 0x80; value >>= 7)
+        {
+            *out++ = static_cast<char>(value | 0x80);
+        }
+        *out++ = static_cast<char>(value);
+    }
+    truncate(output, out);
+}
+
+std::uint64_t VarintDecoder::operator()(std::string_view input) const
+{
+    auto result = std::uint64_t(0);
+    auto consumed = (*this)(input, result);
+    if (consumed == 0 || consumed != input.size())
+    {
+        throw std::invalid_argument("VarintDecoder: not a single varint");
+    }
+    return result;
+}
+
+std::size_t VarintDecoder::operator()(std::string_view input,
+                                      std::uint64_t& value) const
+{
+    auto data = reinterpret_cast<const unsigned char*>(input.data());
+    auto size = input.size();
+    if constexpr (std::endian::native == std::endian::little)
+    {
+        /** Find the terminating byte among the next 8 at once, then gather
+         * their 7 bit groups with shifts rather than a loop */
+        if (size >= 8)
+        {
+            auto word = std::uint64_t();
+            std::memcpy(&word, data, sizeof(word));
+            auto stops = ~word & 0x8080808080808080ull;
+            if (stops != 0)
+            {
+                auto length =
+                    static_cast<std::size_t>(std::countr_zero(stops)) / 8 + 1;
+                if (length < 8)
+                {
+                    word &= (std::uint64_t(1) << (8 * length)) - 1;
+                }
+                word &= 0x7f7f7f7f7f7f7f7full;
+                word = (word & 0x007f007f007f007full) |
+                       (word & 0x7f007f007f007f00ull) >> 1;
+                word = (word & 0x00003fff00003fffull) |
+                       (word & 0x3fff00003fff0000ull) >> 2;
+                word = (word & 0x000000000fffffffull) |
+                       (word & 0x0fffffff00000000ull) >> 4;
+                value = word;
+                return length;
+            }
+        }
+    }
+    auto result = std::uint64_t(0);
+    for (std::size_t i = 0; i < size && i < VarintEncoder::max_length; ++i)
+    {
+        if (i == VarintEncoder::max_length - 1 && data[i] > 1)
+        {
+            throw std::invalid_argument("VarintDecoder: overflow");
+        }
+        result |= std::uint64_t(data[i] & 0x7f) << (7 * i);
+        if ((data[i] & 0x80) == 0)
+        {
+            value = result;
+            return i + 1;
+        }
+    }
+    if (size >= VarintEncoder::max_length)
+    {
+        throw std::invalid_argument("VarintDecoder: overflow");
+    }
+    return 0;
+}
+
+std::size_t VarintDecoder::operator()(std::string_view input,
+                                      std::vector<std::uint64_t>& values) const
+{
+    auto guard = detail::AppendGuard(values);
+    auto consumed = std::size_t(0);
+    auto value = std::uint64_t(0);
+    while (consumed < input.size())
+    {
+        auto length = (*this)(input.substr(consumed), value);
+        if (length == 0)
+        {
+            break;
+        }
+        values.push_back(value);
+        consumed += length;
+    }
+    guard.dismiss();
+    return consumed;
+}
+
+Codec<Base64Encoder, Base64Decoder> makeBase64Codec(Base64Alphabet alphabet,
+                                                    bool padding)
+{
+    return makeCodec(Base64Encoder(alphabet, padding),
+                     Base64Decoder(alphabet));
+}
+
+Codec<HexEncoder, HexDecoder> makeHexCodec()
+{
+    return makeCodec(HexEncoder(), HexDecoder());
+}
+
+Codec<VarintEncoder, VarintDecoder> makeVarintCodec()
+{
+    return makeCodec(VarintEncoder(), VarintDecoder());
+}
+
+Codec<ZigzagEncoder, ZigzagDecoder> makeZigzagCodec()
+{
+    return makeCodec(ZigzagEncoder(), ZigzagDecoder());
+}
+
+} // namespace toolbox
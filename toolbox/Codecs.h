@@ -0,0 +1,164 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string>
+#include <string_view>
+#include <toolbox/Codec.h>
+#include <vector>
+
+namespace toolbox
+{
+
+/** Built-in Encoders and Decoders for use with makeCodec
+ *
+ * Text codecs convert between binary and text held in std::string. Each has
+ * an operator() which returns a new string and one which appends to an
+ * existing string, along with max_size(n) and the block_size in which
+ * makeStream drives it through ChunkStream.
+ *
+ * Base64 and hex process 16 or 32 bytes at a time with SSSE3 or AVX2, chosen
+ * at run time by simdLevel(), and fall back to scalar code elsewhere.
+ * Decoders throw std::invalid_argument on malformed input
+ */
+
+/** The two characters which differ between base64 alphabets */
+enum class Base64Alphabet
+{
+    standard, /**< RFC 4648 section 4, '+' and '/' */
+    url       /**< RFC 4648 section 5, '-' and '_' */
+};
+
+class Base64Encoder
+{
+public:
+    static constexpr std::size_t block_size = 3;
+
+    explicit Base64Encoder(Base64Alphabet alphabet = Base64Alphabet::standard,
+                           bool padding = true);
+
+    std::string operator()(std::string_view input) const;
+
+    void operator()(std::string_view input, std::string& output) const;
+
+    /** Get the length of the encoding of size bytes */
+    std::size_t max_size(std::size_t size) const;
+
+private:
+    Base64Alphabet alphabet_;
+    bool padding_;
+};
+
+/** Decodes base64 with or without trailing padding */
+class Base64Decoder
+{
+public:
+    static constexpr std::size_t block_size = 4;
+
+    explicit Base64Decoder(Base64Alphabet alphabet = Base64Alphabet::standard);
+
+    std::string operator()(std::string_view input) const;
+
+    void operator()(std::string_view input, std::string& output) const;
+
+    std::size_t max_size(std::size_t size) const;
+
+private:
+    Base64Alphabet alphabet_;
+};
+
+/** Encodes each byte as two lower case hex digits */
+class HexEncoder
+{
+public:
+    static constexpr std::size_t block_size = 1;
+
+    std::string operator()(std::string_view input) const;
+
+    void operator()(std::string_view input, std::string& output) const;
+
+    std::size_t max_size(std::size_t size) const;
+};
+
+/** Decodes pairs of hex digits of either case */
+class HexDecoder
+{
+public:
+    static constexpr std::size_t block_size = 2;
+
+    std::string operator()(std::string_view input) const;
+
+    void operator()(std::string_view input, std::string& output) const;
+
+    std::size_t max_size(std::size_t size) const;
+};
+
+/** Encodes unsigned integers as LEB128 varints: 7 bits per byte, least
+ * significant first, with the top bit set on all but the last byte */
+class VarintEncoder
+{
+public:
+    /** Longest encoding of a 64 bit value */
+    static constexpr std::size_t max_length = 10;
+
+    std::string operator()(std::uint64_t value) const;
+
+    void operator()(std::uint64_t value, std::string& output) const;
+
+    /** Append the encoding of each of values */
+    void operator()(std::span<const std::uint64_t> values,
+                    std::string& output) const;
+};
+
+class VarintDecoder
+{
+public:
+    /** Decode a buffer holding exactly one varint */
+    std::uint64_t operator()(std::string_view input) const;
+
+    /** Decode the varint at the start of input into value
+     *
+     * Returns the number of bytes consumed, or 0 if input ends within the
+     * varint */
+    std::size_t operator()(std::string_view input, std::uint64_t& value) const;
+
+    /** Decode consecutive varints, appending them to values
+     *
+     * Returns the number of bytes consumed, which is short of input.size()
+     * if input ends within a varint */
+    std::size_t operator()(std::string_view input,
+                           std::vector<std::uint64_t>& values) const;
+};
+
+/** Maps signed integers to unsigned so that small magnitudes stay small,
+ * e.g. for varint encoding: 0, -1, 1, -2 become 0, 1, 2, 3 */
+struct ZigzagEncoder
+{
+    constexpr std::uint64_t operator()(std::int64_t value) const
+    {
+        return (static_cast<std::uint64_t>(value) << 1) ^
+               static_cast<std::uint64_t>(value >> 63);
+    }
+};
+
+struct ZigzagDecoder
+{
+    constexpr std::int64_t operator()(std::uint64_t value) const
+    {
+        return static_cast<std::int64_t>(value >> 1) ^
+               -static_cast<std::int64_t>(value & 1);
+    }
+};
+
+Codec<Base64Encoder, Base64Decoder>
+makeBase64Codec(Base64Alphabet alphabet = Base64Alphabet::standard,
+                bool padding = true);
+
+Codec<HexEncoder, HexDecoder> makeHexCodec();
+
+Codec<VarintEncoder, VarintDecoder> makeVarintCodec();
+
+Codec<ZigzagEncoder, ZigzagDecoder> makeZigzagCodec();
+
+} // namespace toolbox
@@ -0,0 +1 @@
+#include <toolbox/Composition.h>
@@ -0,0 +1,91 @@
+#pragma once
+
+#include <utility>
+
+namespace toolbox
+{
+
+/** Function composition of two Callables
+ *
+ * Composition<Outer, Inner>()(x) == Outer()(Inner()(x))
+ * The intermediate result is passed straight from Inner to Outer without
+ * being stored
+ */
+template <typename Outer, typename Inner>
+class Composition
+{
+public:
+    using outer_type = Outer;
+    using inner_type = Inner;
+
+    explicit Composition(Outer outer = Outer(), Inner inner = Inner());
+
+    /** Apply the inner Callable then the outer Callable */
+    template <typename T>
+    auto operator()(T&& value)
+        -> decltype(std::declval<Outer&>()(
+            std::declval<Inner&>()(std::forward<T>(value))))
+    {
+        return outer_(inner_(std::forward<T>(value)));
+    }
+
+    template <typename T>
+    auto operator()(T&& value) const
+        -> decltype(std::declval<const Outer&>()(
+            std::declval<const Inner&>()(std::forward<T>(value))))
+    {
+        return outer_(inner_(std::forward<T>(value)));
+    }
+
+    const Outer& outer() const;
+
+    const Inner& inner() const;
+
+private:
+    Outer outer_;
+    Inner inner_;
+};
+
+/** Compose two Callables such that compose(f, g)(x) == f(g(x)) */
+template <typename Outer, typename Inner>
+Composition<Outer, Inner> compose(Outer outer, Inner inner);
+
+/** Compose several Callables such that compose(f, g, h)(x) == f(g(h(x))) */
+template <typename Outer, typename Middle, typename Inner, typename... Rest>
+auto compose(Outer outer, Middle middle, Inner inner, Rest... rest);
+
+/********************************IMPLEMENTATION********************************/
+
+template <typename Outer, typename Inner>
+Composition<Outer, Inner>::Composition(Outer outer, Inner inner)
+    : outer_(std::move(outer)), inner_(std::move(inner))
+{
+}
+
+template <typename Outer, typename Inner>
+const Outer& Composition<Outer, Inner>::outer() const
+{
+    return outer_;
+}
+
+template <typename Outer, typename Inner>
+const Inner& Composition<Outer, Inner>::inner() const
+{
+    return inner_;
+}
+
+template <typename Outer, typename Inner>
+Composition<Outer, Inner> compose(Outer outer, Inner inner)
+{
+    return Composition<Outer, Inner>(std::move(outer), std::move(inner));
+}
+
+template <typename Outer, typename Middle, typename Inner, typename... Rest>
+auto compose(Outer outer, Middle middle, Inner inner, Rest... rest)
+{
+    return compose(std::move(outer),
+                   compose(std::move(middle), std::move(inner),
+                           std::move(rest)...));
+}
+
+} // namespace toolbox
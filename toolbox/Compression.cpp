@@ -0,0 +1,601 @@
+#include <algorithm>
+#include <bit>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+#include <toolbox/AppendGuard.h>
+#include <toolbox/Codecs.h>
+#include <toolbox/Compression.h>
+#include <unordered_map>
+#include <utility>
+
+namespace toolbox
+{
+
+namespace
+{
+
+constexpr std::size_t min_match = 4;
+
+constexpr std::size_t max_distance = 65535;
+
+/** Length of the substrings counted when training a dictionary */
+constexpr std::size_t gram_size = 8;
+
+/** Inputs are compressed in slices of at most this many bytes so that
+ * positions fit in the match index */
+constexpr std::size_t max_slice = std::size_t(1) << 30;
+
+constexpr auto no_position = std::numeric_limits<std::uint32_t>::max();
+
+constexpr std::size_t table_size = std::size_t(1) << LzContext::hash_bits;
+
+std::uint32_t read32(const char* data)
+{
+    auto result = std::uint32_t();
+    std::memcpy(&result, data, sizeof(result));
+    return result;
+}
+
+std::uint32_t hash(const char* data)
+{
+    return (read32(data) * 2654435761u) >> (32 - LzContext::hash_bits);
+}
+
+/** Count the bytes which a and b have in common, reading b up to b_end and
+ * a as far as b */
+std::size_t common(const char* a, const char* b, const char* b_end)
+{
+    auto start = b;
+    if constexpr (std::endian::native == std::endian::little)
+    {
+        while (b_end - b >= 8)
+        {
+            auto x = std::uint64_t();
+            auto y = std::uint64_t();
+            std::memcpy(&x, a, sizeof(x));
+            std::memcpy(&y, b, sizeof(y));
+            if (x != y)
+            {
+                return static_cast<std::size_t>(b - start) +
+                       static_cast<std::size_t>(std::countr_zero(x ^ y)) / 8;
+            }
+            a += 8;
+            b += 8;
+        }
+    }
+    while (b < b_end && *a == *b)
+    {
+        ++a;
+        ++b;
+    }
+    return static_cast<std::size_t>(b - start);
+}
+
+/** Write the part of a length beyond what its token holds */
+char* putLength(char* out, std::size_t length)
+{
+    while (length >= 255)
+    {
+        *out++ = static_cast<char>(255);
+        length -= 255;
+    }
+    *out++ = static_cast<char>(length);
+    return out;
+}
+
+std::size_t getLength(const char*& in, const char* end)
+{
+    auto result = std::size_t(0);
+    auto byte = 0u;
+    do
+    {
+        if (in == end)
+        {
+            throw std::invalid_argument("LzDecoder: truncated input");
+        }
+        byte = static_cast<unsigned char>(*in++);
+        result += byte;
+    } while (byte == 255);
+    return result;
+}
+
+/** Write a sequence of literals followed by a match, or by nothing if
+ * length is 0 */
+char* putSequence(char* out,
+                  const char* literals,
+                  std::size_t literal_length,
+                  std::size_t distance,
+                  std::size_t length)
+{
+    auto token = out++;
+    auto high = std::min<std::size_t>(literal_length, 15) << 4;
+    if (literal_length >= 15)
+    {
+        out = putLength(out, literal_length - 15);
+    }
+    std::memcpy(out, literals, literal_length);
+    out += literal_length;
+    if (length == 0)
+    {
+        *token = static_cast<char>(high);
+        return out;
+    }
+    length -= min_match;
+    *token = static_cast<char>(high | std::min<std::size_t>(length, 15));
+    *out++ = static_cast<char>(distance & 0xff);
+    *out++ = static_cast<char>(distance >> 8);
+    if (length >= 15)
+    {
+        out = putLength(out, length - 15);
+    }
+    return out;
+}
+
+/** Compress input, which follows dictionary, recording its positions in
+ * table offset by base */
+char* compress(std::string_view dictionary,
+               const std::uint32_t* dictionary_table,
+               std::string_view input,
+               std::uint32_t* table,
+               std::uint32_t base,
+               char* out)
+{
+    auto begin = input.data();
+    auto end = begin + input.size();
+    auto dictionary_end = dictionary.data() + dictionary.size();
+    auto anchor = begin;
+    auto p = begin;
+    while (end - p >= static_cast<std::ptrdiff_t>(min_match))
+    {
+        auto h = hash(p);
+        auto current = static_cast<std::uint32_t>(p - begin);
+        auto stored = table[h];
+        table[h] = base + current;
+        auto distance = std::size_t(0);
+        auto length = std::size_t(0);
+        if (stored >= base && stored - base < current &&
+            current - (stored - base) <= max_distance &&
+            read32(begin + (stored - base)) == read32(p))
+        {
+            auto source = begin + (stored - base);
+            distance = static_cast<std::size_t>(p - source);
+            length =
+                min_match + common(source + min_match, p + min_match, end);
+        }
+        else if (dictionary_table && dictionary_table[h] != no_position)
+        {
+            /** The dictionary is treated as ending where input begins */
+            auto source = dictionary.data() + dictionary_table[h];
+            distance = static_cast<std::size_t>(dictionary_end - source) +
+                       current;
+            if (distance <= max_distance && read32(source) == read32(p))
+            {
+                auto limit = std::min(dictionary_end - source, end - p);
+                length = min_match + common(source + min_match, p + min_match,
+                                            p + limit);
+                if (source + length == dictionary_end)
+                {
+                    length += common(begin, p + length, end);
+                }
+            }
+        }
+        if (length == 0)
+        {
+            /** Step further the longer nothing has matched */
+            p += 1 + ((p - anchor) >> 6);
+            continue;
+        }
+        out = putSequence(out, anchor, static_cast<std::size_t>(p - anchor),
+                          distance, length);
+        p += length;
+        anchor = p;
+    }
+    if (anchor < end)
+    {
+        out = putSequence(out, anchor, static_cast<std::size_t>(end - anchor),
+                          0, 0);
+    }
+    return out;
+}
+
+} // namespace
+
+struct CompressionDictionary::Data
+{
+    std::string content;
+    std::vector<std::uint32_t> table;
+};
+
+CompressionDictionary::CompressionDictionary(std::string_view content)
+{
+    if (content.size() > max_size)
+    {
+        content = content.substr(content.size() - max_size);
+    }
+    auto data = std::make_shared<Data>();
+    data->content = content;
+    data->table.assign(table_size, no_position);
+    /** Later positions overwrite earlier ones, favouring shorter distances */
+    for (std::size_t i = 0; i + min_match <= content.size(); ++i)
+    {
+        data->table[hash(content.data() + i)] = static_cast<std::uint32_t>(i);
+    }
+    data_ = std::move(data);
+}
+
+CompressionDictionary
+CompressionDictionary::train(std::span<const std::string> samples,
+                             std::size_t size)
+{
+    struct Gram
+    {
+        std::size_t count = 0;
+        const char* sample_end = nullptr;
+        bool used = false;
+    };
+    /** Keys view the first occurrence of each gram */
+    auto grams = std::unordered_map<std::string_view, Gram>();
+    for (const auto& sample : samples)
+    {
+        for (std::size_t i = 0; i + gram_size <= sample.size(); ++i)
+        {
+            auto& gram = grams[std::string_view(sample).substr(i, gram_size)];
+            if (gram.count++ == 0)
+            {
+                gram.sample_end = sample.data() + sample.size();
+            }
+        }
+    }
+    auto ranked = std::vector<std::pair<std::string_view, Gram*>>();
+    for (auto& [key, gram] : grams)
+    {
+        if (gram.count > 1)
+        {
+            ranked.emplace_back(key, &gram);
+        }
+    }
+    std::sort(ranked.begin(), ranked.end(), [](const auto& a, const auto& b) {
+        return a.second->count != b.second->count
+                   ? a.second->count > b.second->count
+                   : a.first < b.first;
+    });
+    size = std::min(size, max_size);
+    /** Grow each frequent gram into a segment by following its first
+     * occurrence for as long as the next gram also recurs */
+    auto segments = std::vector<std::string_view>();
+    auto total = std::size_t(0);
+    for (const auto& [key, gram] : ranked)
+    {
+        if (total >= size)
+        {
+            break;
+        }
+        if (gram->used)
+        {
+            continue;
+        }
+        gram->used = true;
+        auto length = gram_size;
+        auto next = key;
+        while (total + length < size &&
+               next.data() + gram_size < gram->sample_end)
+        {
+            next = std::string_view(next.data() + 1, gram_size);
+            auto it = grams.find(next);
+            if (it == grams.end() || it->second.count < 2 || it->second.used)
+            {
+                break;
+            }
+            it->second.used = true;
+            ++length;
+        }
+        length = std::min(length, size - total);
+        segments.emplace_back(key.data(), length);
+        total += length;
+    }
+    /** The most frequent segments go last, closest to the input */
+    auto content = std::string();
+    content.reserve(total);
+    for (auto it = segments.rbegin(); it != segments.rend(); ++it)
+    {
+        content += *it;
+    }
+    return CompressionDictionary(content);
+}
+
+std::string_view CompressionDictionary::content() const
+{
+    return data_ ? std::string_view(data_->content) : std::string_view();
+}
+
+bool CompressionDictionary::empty() const
+{
+    return !data_ || data_->content.empty();
+}
+
+const std::uint32_t* CompressionDictionary::table() const
+{
+    return data_ ? data_->table.data() : nullptr;
+}
+
+LzContext::LzContext() : table_(table_size, 0), base_(0)
+{
+}
+
+LzEncoder::LzEncoder(CompressionDictionary dictionary)
+    : dictionary_(std::move(dictionary))
+{
+}
+
+std::string LzEncoder::operator()(std::string_view input) const
+{
+    auto result = std::string();
+    (*this)(input, result);
+    return result;
+}
+
+void LzEncoder::operator()(std::string_view input, std::string& output) const
+{
+    thread_local auto context = LzContext();
+    (*this)(input, output, context);
+}
+
+void LzEncoder::operator()(std::string_view input,
+                           std::string& output,
+                           LzContext& context) const
+{
+    VarintEncoder()(input.size(), output);
+    auto offset = output.size();
+    output.resize(offset + max_size(input.size()));
+    auto out = output.data() + offset;
+    auto dictionary = dictionary_.content();
+    auto dictionary_table =
+        dictionary_.empty() ? nullptr : dictionary_.table();
+    do
+    {
+        auto slice = input.substr(0, max_slice);
+        if (context.base_ > no_position - max_slice - 1)
+        {
+            std::fill(context.table_.begin(), context.table_.end(), 0);
+            context.base_ = 0;
+        }
+        out = compress(dictionary, dictionary_table, slice,
+                       context.table_.data(), context.base_, out);
+        /** Positions recorded by this call now fall below the base */
+        context.base_ += static_cast<std::uint32_t>(slice.size()) + 1;
+        input.remove_prefix(slice.size());
+        dictionary = {};
+        dictionary_table = nullptr;
+    } while (!input.empty());
+    output.resize(static_cast<std::size_t>(out - output.data()));
+}
+
+std::size_t LzEncoder::max_size(std::size_t size) const
+{
+    return VarintEncoder::max_length + size + size / 255 + 16;
+}
+
+const CompressionDictionary& LzEncoder::dictionary() const
+{
+    return dictionary_;
+}
+
+LzDecoder::LzDecoder(CompressionDictionary dictionary)
+    : dictionary_(std::move(dictionary))
+{
+}
+
+std::string LzDecoder::operator()(std::string_view input) const
+{
+    auto result = std::string();
+    (*this)(input, result);
+    return result;
+}
+
+void LzDecoder::operator()(std::string_view input, std::string& output) const
+{
+    auto size = std::uint64_t(0);
+    auto consumed = VarintDecoder()(input, size);
+    if (consumed == 0)
+    {
+        throw std::invalid_argument("LzDecoder: truncated input");
+    }
+    auto in = input.data() + consumed;
+    auto in_end = input.data() + input.size();
+    /** No sequence expands by more than a factor of 255 */
+    if (size / 255 > static_cast<std::uint64_t>(in_end - in))
+    {
+        throw std::invalid_argument("LzDecoder: invalid length");
+    }
+    auto guard = detail::AppendGuard(output);
+    auto offset = output.size();
+    output.resize(offset + size);
+    auto begin = output.data() + offset;
+    auto out = begin;
+    auto out_end = begin + size;
+    auto dictionary = dictionary_.content();
+    while (in < in_end)
+    {
+        auto token = static_cast<unsigned char>(*in++);
+        auto literal_length = std::size_t(token >> 4);
+        if (literal_length == 15)
+        {
+            literal_length += getLength(in, in_end);
+        }
+        if (literal_length > static_cast<std::size_t>(in_end - in) ||
+            literal_length > static_cast<std::size_t>(out_end - out))
+        {
+            throw std::invalid_argument("LzDecoder: corrupt input");
+        }
+        std::memcpy(out, in, literal_length);
+        in += literal_length;
+        out += literal_length;
+        if (in == in_end)
+        {
+            break;
+        }
+        if (in_end - in < 2)
+        {
+            throw std::invalid_argument("LzDecoder: truncated input");
+        }
+        auto distance = std::size_t(static_cast<unsigned char>(in[0])) |
+                        std::size_t(static_cast<unsigned char>(in[1])) << 8;
+        in += 2;
+        auto length = std::size_t(token & 15) + min_match;
+        if (length == 15 + min_match)
+        {
+            length += getLength(in, in_end);
+        }
+        auto produced = static_cast<std::size_t>(out - begin);
+        if (distance == 0 || distance > produced + dictionary.size() ||
+            length > static_cast<std::size_t>(out_end - out))
+        {
+            throw std::invalid_argument("LzDecoder: corrupt input");
+        }
+        if (distance > produced)
+        {
+            /** The match starts in the dictionary and may run on into the
+             * start of the output */
+            auto back = distance - produced;
+            auto count = std::min(back, length);
+            std::memcpy(out, dictionary.data() + dictionary.size() - back,
+                        count);
+            out += count;
+            length -= count;
+            for (std::size_t i = 0; i < length; ++i)
+            {
+                out[i] = begin[i];
+            }
+        }
+        else if (distance >= length)
+        {
+            std::memcpy(out, out - distance, length);
+        }
+        else
+        {
+            /** Overlapping matches repeat their own output */
+            for (std::size_t i = 0; i < length; ++i)
+            {
+                out[i] = out[i - distance];
+            }
+        }
+        out += length;
+    }
+    if (out != out_end)
+    {
+        throw std::invalid_argument("LzDecoder: wrong length");
+    }
+    guard.dismiss();
+}
+
+const CompressionDictionary& LzDecoder::dictionary() const
+{
+    return dictionary_;
+}
+
+std::string RleEncoder::operator()(std::string_view input) const
+{
+    auto result = std::string();
+    (*this)(input, result);
+    return result;
+}
+
+void RleEncoder::operator()(std::string_view input, std::string& output) const
+{
+    auto offset = output.size();
+    output.resize(offset + max_size(input.size()));
+    auto out = output.data() + offset;
+    auto putLiterals = [&out](const char* literals, std::size_t count) {
+        while (count > 0)
+        {
+            auto chunk = std::min<std::size_t>(count, 128);
+            *out++ = static_cast<char>(chunk - 1);
+            std::memcpy(out, literals, chunk);
+            out += chunk;
+            literals += chunk;
+            count -= chunk;
+        }
+    };
+    auto data = input.data();
+    auto size = input.size();
+    auto literals = std::size_t(0);
+    auto i = std::size_t(0);
+    while (i < size)
+    {
+        auto run = std::size_t(1);
+        while (run < 130 && i + run < size && data[i + run] == data[i])
+        {
+            ++run;
+        }
+        if (run >= 3)
+        {
+            putLiterals(data + literals, i - literals);
+            *out++ = static_cast<char>(128 + run - 3);
+            *out++ = data[i];
+            literals = i + run;
+        }
+        i += run;
+    }
+    putLiterals(data + literals, size - literals);
+    output.resize(static_cast<std::size_t>(out - output.data()));
+}
+
+std::size_t RleEncoder::max_size(std::size_t size) const
+{
+    return size + size / 128 + 1;
+}
+
+std::string RleDecoder::operator()(std::string_view input) const
+{
+    auto result = std::string();
+    (*this)(input, result);
+    return result;
+}
+
+void RleDecoder::operator()(std::string_view input, std::string& output) const
+{
+    /** Size the output first so that it grows once */
+    auto size = std::size_t(0);
+    for (std::size_t i = 0; i < input.size();)
+    {
+        auto control = static_cast<unsigned char>(input[i]);
+        auto count = control < 128 ? std::size_t(control) + 1 : 1;
+        size += control < 128 ? count : control - 125;
+        i += 1 + count;
+        if (i > input.size())
+        {
+            throw std::invalid_argument("RleDecoder: truncated input");
+        }
+    }
+    auto offset = output.size();
+    output.resize(offset + size);
+    auto out = output.data() + offset;
+    for (std::size_t i = 0; i < input.size();)
+    {
+        auto control = static_cast<unsigned char>(input[i++]);
+        if (control < 128)
+        {
+            std::memcpy(out, input.data() + i, control + 1u);
+            out += control + 1u;
+            i += control + 1u;
+        }
+        else
+        {
+            std::memset(out, input[i++], control - 125u);
+            out += control - 125u;
+        }
+    }
+}
+
+Codec<LzEncoder, LzDecoder> makeLzCodec(CompressionDictionary dictionary)
+{
+    return makeCodec(LzEncoder(dictionary), LzDecoder(dictionary));
+}
+
+Codec<RleEncoder, RleDecoder> makeRleCodec()
+{
+    return makeCodec(RleEncoder(), RleDecoder());
+}
+
+} // namespace toolbox
@@ -0,0 +1,146 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <string>
+#include <string_view>
+#include <toolbox/Codec.h>
+#include <vector>
+
+namespace toolbox
+{
+
+/** Content which compressor and decompressor both treat as though it
+ * preceded every input, so that even tiny records find matches
+ *
+ * Only the last max_size bytes are kept, since matches can't reach further
+ * back. Copies share the content and its precomputed match index, so a
+ * dictionary can be handed to any number of encoders and decoders cheaply
+ */
+class CompressionDictionary
+{
+public:
+    static constexpr std::size_t max_size = 65535;
+
+    CompressionDictionary() = default;
+
+    explicit CompressionDictionary(std::string_view content);
+
+    /** Build a dictionary of up to size bytes from the substrings which
+     * recur most often across samples, most frequent last */
+    static CompressionDictionary train(std::span<const std::string> samples,
+                                       std::size_t size = 4096);
+
+    std::string_view content() const;
+
+    bool empty() const;
+
+    /** Positions in content() by hash of the 4 bytes found there */
+    const std::uint32_t* table() const;
+
+private:
+    struct Data;
+
+    std::shared_ptr<const Data> data_;
+};
+
+/** Reusable working memory for LzEncoder
+ *
+ * Holds the match index, which is invalidated between calls by advancing
+ * a base position rather than by clearing, so a context compresses any
+ * number of inputs without allocating or touching its whole table. A
+ * context must not be used by two threads at once
+ */
+class LzContext
+{
+public:
+    static constexpr unsigned hash_bits = 12;
+
+    LzContext();
+
+private:
+    friend class LzEncoder;
+
+    std::vector<std::uint32_t> table_;
+    std::uint32_t base_;
+};
+
+/** A byte-oriented LZ77 compressor in the style of LZ4, tuned for speed
+ *
+ * The output is the varint length of the input followed by sequences, each
+ * a token holding the lengths of a run of literals and of a match, the
+ * literals, and the match's 16 bit distance back. Matches are found through
+ * a single hash probe per position, skipping ahead faster the longer no
+ * match is found, so incompressible input costs little
+ */
+class LzEncoder
+{
+public:
+    explicit LzEncoder(CompressionDictionary dictionary = {});
+
+    std::string operator()(std::string_view input) const;
+
+    /** Compress with a context owned by the calling thread */
+    void operator()(std::string_view input, std::string& output) const;
+
+    void operator()(std::string_view input,
+                    std::string& output,
+                    LzContext& context) const;
+
+    std::size_t max_size(std::size_t size) const;
+
+    const CompressionDictionary& dictionary() const;
+
+private:
+    CompressionDictionary dictionary_;
+};
+
+/** Decompresses the output of an LzEncoder with the same dictionary
+ *
+ * Throws std::invalid_argument on malformed input */
+class LzDecoder
+{
+public:
+    explicit LzDecoder(CompressionDictionary dictionary = {});
+
+    std::string operator()(std::string_view input) const;
+
+    void operator()(std::string_view input, std::string& output) const;
+
+    const CompressionDictionary& dictionary() const;
+
+private:
+    CompressionDictionary dictionary_;
+};
+
+/** Run-length encoding for values dominated by repeated bytes
+ *
+ * A control byte below 128 introduces that many plus one literal bytes, and
+ * one from 128 repeats the following byte 3 to 130 times */
+class RleEncoder
+{
+public:
+    std::string operator()(std::string_view input) const;
+
+    void operator()(std::string_view input, std::string& output) const;
+
+    std::size_t max_size(std::size_t size) const;
+};
+
+/** Throws std::invalid_argument on malformed input */
+class RleDecoder
+{
+public:
+    std::string operator()(std::string_view input) const;
+
+    void operator()(std::string_view input, std::string& output) const;
+};
+
+Codec<LzEncoder, LzDecoder>
+makeLzCodec(CompressionDictionary dictionary = {});
+
+Codec<RleEncoder, RleDecoder> makeRleCodec();
+
+} // namespace toolbox
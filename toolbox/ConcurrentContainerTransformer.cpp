@@ -0,0 +1 @@
+#include <toolbox/ConcurrentContainerTransformer.h>
@@ -0,0 +1,307 @@
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <mutex>
+#include <optional>
+#include <shared_mutex>
+#include <toolbox/ContainerTransformer.h>
+#include <toolbox/Parallel.h>
+#include <toolbox/Shards.h>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace toolbox
+{
+
+/** Applies a Transform to a set of AssociativeContainers which can be shared
+ * between threads
+ *
+ * Values are spread across a fixed number of shards, each a Container
+ * guarded by its own reader-writer lock, by a hash of their encoded key.
+ * Readers of a shard proceed in parallel and writers only contend with
+ * threads which touch the same shard, so throughput grows with the number of
+ * threads until they collide on shards.
+ *
+ * Encoding and decoding happen outside any lock: insert and erase encode
+ * before locking, and find copies the stored element under a shared lock
+ * then decodes the copy. Both functors of Transform are therefore called
+ * concurrently and must be safe to do so.
+ *
+ * Since a shard may change as soon as its lock is released, results are
+ * returned by value rather than as iterators
+ */
+template <typename Container,
+          typename Transform,
+          typename Hash = std::hash<typename Container::key_type>>
+class ConcurrentContainerTransformer
+{
+private:
+    Transform transform_;
+    Hash hash_;
+
+public:
+    using container_type = Container;
+    using value_type = std::decay_t<decltype(
+        transform_.second(typename container_type::value_type()))>;
+    using key_type = std::decay_t<decltype(
+        transform_.second(typename container_type::key_type()))>;
+    using size_type = typename container_type::size_type;
+
+    /** Default number of shards, a few per hardware thread */
+    static size_type default_shard_count();
+
+    explicit ConcurrentContainerTransformer(
+        size_type shard_count = default_shard_count(),
+        Transform transform = Transform(),
+        Hash hash = Hash());
+
+    ConcurrentContainerTransformer(const ConcurrentContainerTransformer&) =
+        delete;
+
+    ConcurrentContainerTransformer&
+    operator=(const ConcurrentContainerTransformer&) = delete;
+
+    /** Get the number of shards */
+    size_type shard_count() const;
+
+    /** Determine whether every shard is empty */
+    bool empty() const;
+
+    /** Get the number of values stored across all shards
+     *
+     * Shards are counted one at a time, so concurrent writes may or may not
+     * be reflected */
+    size_type size() const;
+
+    /** Remove all values */
+    void clear();
+
+    /** Insert an element, returning whether it was inserted */
+    bool insert(const value_type& value);
+
+    /** Insert a range of values
+     *
+     * Values are encoded in parallel batches before any lock is taken, then
+     * grouped by shard so that each shard is locked once */
+    template <typename InputIterator>
+    void insert(InputIterator first, InputIterator last);
+
+    /** Remove an element */
+    size_type erase(const key_type& key);
+
+    /** Find an element, decoding a copy of it outside the shard's lock */
+    std::optional<value_type> find(const key_type& key) const;
+
+    /** Determine whether an element is present without decoding it */
+    bool contains(const key_type& key) const;
+
+    /** Call f with each decoded value
+     *
+     * Each shard is read under a shared lock which is held while f runs, so f
+     * mustn't write to this */
+    template <typename F>
+    void for_each(F f) const;
+
+private:
+    struct Shard
+    {
+        mutable std::shared_mutex mutex;
+        container_type container;
+    };
+
+    detail::Shards<Shard> shards_;
+
+    /** Select the shard which holds an encoded key */
+    size_type route(const typename container_type::key_type& key) const;
+
+    Shard& shard(const typename container_type::key_type& key) const;
+};
+
+/********************************IMPLEMENTATION********************************/
+
+template <typename Container, typename Transform, typename Hash>
+typename ConcurrentContainerTransformer<Container, Transform, Hash>::size_type
+ConcurrentContainerTransformer<Container, Transform, Hash>::
+    default_shard_count()
+{
+    return detail::defaultShardCount();
+}
+
+template <typename Container, typename Transform, typename Hash>
+ConcurrentContainerTransformer<Container, Transform, Hash>::
+    ConcurrentContainerTransformer(size_type shard_count,
+                                   Transform transform,
+                                   Hash hash)
+    : transform_(std::move(transform)), hash_(std::move(hash)),
+      shards_(shard_count)
+{
+}
+
+template <typename Container, typename Transform, typename Hash>
+typename ConcurrentContainerTransformer<Container, Transform, Hash>::size_type
+ConcurrentContainerTransformer<Container, Transform, Hash>::shard_count() const
+{
+    return shards_.size();
+}
+
+template <typename Container, typename Transform, typename Hash>
+typename ConcurrentContainerTransformer<Container, Transform, Hash>::size_type
+ConcurrentContainerTransformer<Container, Transform, Hash>::route(
+    const typename container_type::key_type& key) const
+{
+    return static_cast<size_type>(shards_.route(hash_(key)));
+}
+
+template <typename Container, typename Transform, typename Hash>
+typename ConcurrentContainerTransformer<Container, Transform, Hash>::Shard&
+ConcurrentContainerTransformer<Container, Transform, Hash>::shard(
+    const typename container_type::key_type& key) const
+{
+    return shards_[route(key)];
+}
+
+template <typename Container, typename Transform, typename Hash>
+bool ConcurrentContainerTransformer<Container, Transform, Hash>::empty() const
+{
+    return size() == 0;
+}
+
+template <typename Container, typename Transform, typename Hash>
+typename ConcurrentContainerTransformer<Container, Transform, Hash>::size_type
+ConcurrentContainerTransformer<Container, Transform, Hash>::size() const
+{
+    auto result = size_type(0);
+    for (size_type i = 0; i < shards_.size(); ++i)
+    {
+        std::shared_lock<std::shared_mutex> lock(shards_[i].mutex);
+        result += shards_[i].container.size();
+    }
+    return result;
+}
+
+template <typename Container, typename Transform, typename Hash>
+void ConcurrentContainerTransformer<Container, Transform, Hash>::clear()
+{
+    for (size_type i = 0; i < shards_.size(); ++i)
+    {
+        std::unique_lock<std::shared_mutex> lock(shards_[i].mutex);
+        shards_[i].container.clear();
+    }
+}
+
+template <typename Container, typename Transform, typename Hash>
+bool ConcurrentContainerTransformer<Container, Transform, Hash>::insert(
+    const value_type& value)
+{
+    typename container_type::value_type encoded(transform_.first(value));
+    auto& target = shard(detail::key_of<Container>(encoded));
+    std::unique_lock<std::shared_mutex> lock(target.mutex);
+    return target.container.insert(std::move(encoded)).second;
+}
+
+template <typename Container, typename Transform, typename Hash>
+template <typename InputIterator>
+void ConcurrentContainerTransformer<Container, Transform, Hash>::insert(
+    InputIterator first, InputIterator last)
+{
+    using encoder_type = typename Transform::first_type;
+    using encoded_type = std::decay_t<decltype(
+        std::declval<encoder_type&>()(*std::declval<InputIterator&>()))>;
+    auto encoded = std::vector<encoded_type>();
+    using category =
+        typename std::iterator_traits<InputIterator>::iterator_category;
+    if constexpr (std::is_base_of<std::random_access_iterator_tag,
+                                  category>::value)
+    {
+        encoded.resize(static_cast<std::size_t>(std::distance(first, last)));
+        parallelTransform(first, last, encoded.begin(), transform_.first);
+    }
+    else
+    {
+        auto encoder = transform_.first;
+        for (; first != last; ++first)
+        {
+            encoded.push_back(encoder(*first));
+        }
+    }
+    auto routed = std::vector<std::vector<encoded_type*>>(shards_.size());
+    for (auto& value : encoded)
+    {
+        routed[route(detail::key_of<Container>(value))].push_back(&value);
+    }
+    for (size_type i = 0; i < shards_.size(); ++i)
+    {
+        if (routed[i].empty())
+        {
+            continue;
+        }
+        std::unique_lock<std::shared_mutex> lock(shards_[i].mutex);
+        for (auto value : routed[i])
+        {
+            shards_[i].container.insert(std::move(*value));
+        }
+    }
+}
+
+template <typename Container, typename Transform, typename Hash>
+typename ConcurrentContainerTransformer<Container, Transform, Hash>::size_type
+ConcurrentContainerTransformer<Container, Transform, Hash>::erase(
+    const key_type& key)
+{
+    typename container_type::key_type encoded(transform_.first(key));
+    auto& target = shard(encoded);
+    std::unique_lock<std::shared_mutex> lock(target.mutex);
+    return target.container.erase(encoded);
+}
+
+template <typename Container, typename Transform, typename Hash>
+std::optional<
+    typename ConcurrentContainerTransformer<Container, Transform, Hash>::
+        value_type>
+ConcurrentContainerTransformer<Container, Transform, Hash>::find(
+    const key_type& key) const
+{
+    typename container_type::key_type encoded(transform_.first(key));
+    auto& target = shard(encoded);
+    std::optional<typename container_type::value_type> stored;
+    {
+        std::shared_lock<std::shared_mutex> lock(target.mutex);
+        auto it = target.container.find(encoded);
+        if (it == target.container.end())
+        {
+            return std::nullopt;
+        }
+        stored.emplace(*it);
+    }
+    return std::optional<value_type>(transform_.second(*stored));
+}
+
+template <typename Container, typename Transform, typename Hash>
+bool ConcurrentContainerTransformer<Container, Transform, Hash>::contains(
+    const key_type& key) const
+{
+    typename container_type::key_type encoded(transform_.first(key));
+    auto& target = shard(encoded);
+    std::shared_lock<std::shared_mutex> lock(target.mutex);
+    return target.container.find(encoded) != target.container.end();
+}
+
+template <typename Container, typename Transform, typename Hash>
+template <typename F>
+void ConcurrentContainerTransformer<Container, Transform, Hash>::for_each(
+    F f) const
+{
+    for (size_type i = 0; i < shards_.size(); ++i)
+    {
+        std::shared_lock<std::shared_mutex> lock(shards_[i].mutex);
+        for (const auto& stored : shards_[i].container)
+        {
+            f(transform_.second(stored));
+        }
+    }
+}
+
+} // namespace toolbox
@@ -1,12 +1,141 @@
 #pragma once
 
+#include <algorithm>
+#include <iterator>
 #include <memory>
 #include <toolbox/IteratorTransformer.h>
+#include <toolbox/Parallel.h>
 #include <type_traits>
+#include <vector>
 
 namespace toolbox
 {
 
+namespace detail
+{
+
+/** Ordered associative containers declare a key comparison */
+template <typename Container, typename = void>
+struct is_ordered_container : std::false_type
+{
+};
+
+template <typename Container>
+struct is_ordered_container<Container,
+                            std::void_t<typename Container::key_compare>>
+    : std::true_type
+{
+};
+
+template <typename Container, typename = void>
+struct is_reservable_container : std::false_type
+{
+};
+
+template <typename Container>
+struct is_reservable_container<
+    Container,
+    std::void_t<decltype(std::declval<Container&>().reserve(0))>>
+    : std::true_type
+{
+};
+
+/** Get the key of a key or value which is stored in a Container */
+template <typename Container, typename Value>
+const auto& key_of(const Value& value)
+{
+    if constexpr (std::is_convertible<Value,
+                                      typename Container::key_type>::value)
+    {
+        return value;
+    }
+    else
+    {
+        return value.first;
+    }
+}
+
+/** An encoder has a lookup projection if encoder.project(key) yields a value
+ * which can be looked up in the container in place of the encoded key */
+template <typename Encoder, typename Key, typename = void>
+struct has_projection : std::false_type
+{
+};
+
+template <typename Encoder, typename Key>
+struct has_projection<Encoder,
+                      Key,
+                      std::void_t<decltype(std::declval<const Encoder&>()
+                                               .project(std::declval<
+                                                        const Key&>()))>>
+    : std::true_type
+{
+};
+
+/** An encoder can encode into a buffer if encoder(key, encoded) overwrites
+ * encoded with the encoding of key */
+template <typename Encoder, typename Key, typename Encoded, typename = void>
+struct can_encode_into : std::false_type
+{
+};
+
+template <typename Encoder, typename Key, typename Encoded>
+struct can_encode_into<Encoder,
+                       Key,
+                       Encoded,
+                       std::void_t<decltype(std::declval<const Encoder&>()(
+                           std::declval<const Key&>(),
+                           std::declval<Encoded&>()))>> : std::true_type
+{
+};
+
+/** An encoder which declares static constexpr bool concurrent = true may be
+ * called through copies of it on several threads at once */
+template <typename Encoder, typename = void>
+struct is_concurrent : std::false_type
+{
+};
+
+template <typename Encoder>
+struct is_concurrent<Encoder, std::void_t<decltype(Encoder::concurrent)>>
+    : std::bool_constant<Encoder::concurrent>
+{
+};
+
+/** A decoder caches decoded values if decoder.invalidate(stored) discards
+ * the value decoded from a stored element */
+template <typename Decoder, typename Stored, typename = void>
+struct has_invalidate : std::false_type
+{
+};
+
+template <typename Decoder, typename Stored>
+struct has_invalidate<Decoder,
+                      Stored,
+                      std::void_t<decltype(std::declval<const Decoder&>()
+                                               .invalidate(std::declval<
+                                                           const Stored&>()))>>
+    : std::true_type
+{
+};
+
+/** A decoder can discard every cached value at once if it has
+ * decoder.invalidate() */
+template <typename Decoder, typename = void>
+struct has_invalidate_all : std::false_type
+{
+};
+
+template <typename Decoder>
+struct has_invalidate_all<
+    Decoder,
+    std::void_t<decltype(std::declval<const Decoder&>().invalidate())>>
+    : std::true_type
+{
+};
+
+} // namespace detail
+
 /** Applies a Transform to an AssociativeContainer
  *
  * Transform is a bijective pair of functors
@@ -14,6 +143,24 @@ namespace toolbox
  * internal data type
  * Transform::second_type converts from the internal data type to the external
  * data type
+ *
+ * Lookups by key, including bulk erase and find_many, avoid encoding a
+ * complete key where Transform::first_type allows, in order of preference:
+ * - project(key) returns a lookup key, such as a view of key, which the
+ *   container can compare against its keys, typically through a transparent
+ *   comparator such as std::less<>
+ * - operator()(key, encoded) encodes key into an existing buffer, which is
+ *   then reused by every lookup on the same thread
+ *
+ * Inserting a range encodes on the calling thread unless
+ * Transform::first_type declares static constexpr bool concurrent = true, in
+ * which case large ranges are split into batches encoded in parallel, each
+ * by a copy of it. Only declare it where such copies don't share
+ * unsynchronised state.
+ *
+ * If Transform::second_type caches decoded values, such as CachingDecoder,
+ * insert, erase and clear invalidate the affected entries. Modifying the
+ * underlying container directly bypasses this invalidation
  */
 template <typename Container, typename Transform>
 class ContainerTransformer
@@ -24,8 +171,12 @@ private:
 
 public:
     using container_type = Container;
-    using value_type =
-    decltype(transform_.second(typename container_type::value_type()));
+    using value_type = std::decay_t<detail::transform_result_t<
+        typename Transform::second_type,
+        decltype(transform_.second(typename container_type::value_type()))>>;
+    using key_type = std::decay_t<detail::transform_result_t<
+        typename Transform::second_type,
+        decltype(transform_.second(typename container_type::key_type()))>>;
     using size_type = typename container_type::size_type;
     using difference_type = typename container_type::difference_type;
     using allocator_type = typename container_type::allocator_type;
@@ -74,13 +225,63 @@ public:
     /** Insert an element */
     std::pair<iterator, bool> insert(const value_type& value);
 
+    /** Insert a range of values
+     *
+     * Values are encoded in parallel batches if Transform::first_type is
+     * concurrent. An ordered container receives
+     * them in sorted order with a hint, so each insertion is amortised
+     * constant time where it lands next to the previous one. An unordered
+     * container is reserved up front */
+    template <typename InputIterator>
+    void insert(InputIterator first, InputIterator last);
+
     /** Remove an element */
-    size_type erase(const decltype(transform_.second(
-        typename container_type::key_type()))& key);
+    size_type erase(const key_type& key);
+
+    /** Remove the elements with each of a range of keys
+     *
+     * Each key is looked up as by erase(key), so is only encoded where
+     * Transform offers no cheaper way. Returns the number of elements
+     * removed */
+    template <typename InputIterator>
+    size_type erase(InputIterator first, InputIterator last);
 
     /** Find an element */
-    const_iterator find(const decltype(transform_.second(
-        typename container_type::key_type()))& key) const;
+    const_iterator find(const key_type& key) const;
+
+    /** Find the elements with each of a range of keys
+     *
+     * Each key is looked up as by find(key). Writes one const_iterator per
+     * key to out, which is cend() where the key is absent, and returns the
+     * end of the output */
+    template <typename InputIterator, typename OutputIterator>
+    OutputIterator find_many(InputIterator first,
+                             InputIterator last,
+                             OutputIterator out) const;
+
+private:
+    /** Encode a range of values with transform_.first */
+    template <typename InputIterator>
+    auto encode(InputIterator first, InputIterator last) const;
+
+    /** Sort encoded values into the container's order */
+    template <typename Encoded>
+    void sort(std::vector<Encoded>& encoded) const;
+
+    /** Per-thread buffer for keys which are encoded in place */
+    static typename container_type::key_type& scratch();
+
+    /** Convert an external key into a key which can be looked up in the
+     * container, encoding it only where Transform offers no cheaper way */
+    template <typename Key>
+    decltype(auto) lookup(const Key& key) const;
+
+    /** Remove the elements matching a key produced by lookup() */
+    template <typename Key>
+    size_type eraseLookup(const Key& key);
+
+    /** Discard any value decoded from a stored element */
+    void invalidate(const typename container_type::value_type& stored) const;
 };
 
 template <typename Container, typename Transform>
@@ -148,6 +349,20 @@ ContainerTransformer<Container, Transform>::size() const
 template <typename Container, typename Transform>
 void ContainerTransformer<Container, Transform>::clear()
 {
+    using decoder_type = typename Transform::second_type;
+    if constexpr (detail::has_invalidate_all<decoder_type>::value)
+    {
+        transform_.second.invalidate();
+    }
+    else if constexpr (detail::has_invalidate<
+                           decoder_type,
+                           typename container_type::value_type>::value)
+    {
+        for (const auto& stored : *container_)
+        {
+            invalidate(stored);
+        }
+    }
     container_->clear();
 }
 
@@ -158,24 +373,219 @@ ContainerTransformer<Container, Transform>::insert(
                                         Transform>::value_type& value)
 {
     auto result = container_->insert(transform_.first(value));
-    return std::make_pair(iterator(result.first), result.second);
+    if (result.second)
+    {
+        invalidate(*result.first);
+    }
+    return std::make_pair(iterator(result.first, transform_.second),
+                          result.second);
 }
 
 template <typename Container, typename Transform>
+template <typename InputIterator>
+void ContainerTransformer<Container, Transform>::insert(InputIterator first,
+                                                        InputIterator last)
+{
+    auto values = encode(first, last);
+    if constexpr (detail::is_ordered_container<Container>::value)
+    {
+        sort(values);
+        auto hint = container_->end();
+        for (auto& value : values)
+        {
+            auto inserted = container_->insert(hint, std::move(value));
+            invalidate(*inserted);
+            hint = std::next(inserted);
+        }
+    }
+    else
+    {
+        using decoder_type = typename Transform::second_type;
+        if constexpr (detail::is_reservable_container<Container>::value)
+        {
+            container_->reserve(container_->size() + values.size());
+        }
+        if constexpr (detail::has_invalidate<
+                          decoder_type,
+                          typename container_type::value_type>::value)
+        {
+            for (auto& value : values)
+            {
+                auto result = container_->insert(std::move(value));
+                if (result.second)
+                {
+                    invalidate(*result.first);
+                }
+            }
+        }
+        else
+        {
+            container_->insert(std::make_move_iterator(values.begin()),
+                               std::make_move_iterator(values.end()));
+        }
+    }
+}
+
+template <typename Container, typename Transform>
+typename ContainerTransformer<Container, Transform>::size_type
+ContainerTransformer<Container, Transform>::erase(const key_type& key)
+{
+    return eraseLookup(lookup(key));
+}
+
+template <typename Container, typename Transform>
+template <typename InputIterator>
 typename ContainerTransformer<Container, Transform>::size_type
-ContainerTransformer<Container, Transform>::erase(
-    const decltype(transform_.second(typename container_type::key_type()))& key)
+ContainerTransformer<Container, Transform>::erase(InputIterator first,
+                                                  InputIterator last)
 {
-    return container_->erase(transform_.first(key));
+    auto result = size_type(0);
+    for (; first != last; ++first)
+    {
+        result += eraseLookup(lookup(*first));
+    }
+    return result;
 }
 
 template <typename Container, typename Transform>
 typename ContainerTransformer<Container, Transform>::const_iterator
-ContainerTransformer<Container, Transform>::find(
-    const decltype(transform_.second(
-        typename container_type::key_type()))& key) const
+ContainerTransformer<Container, Transform>::find(const key_type& key) const
+{
+    return const_iterator(container_->find(lookup(key)), transform_.second);
+}
+
+template <typename Container, typename Transform>
+template <typename InputIterator, typename OutputIterator>
+OutputIterator ContainerTransformer<Container, Transform>::find_many(
+    InputIterator first, InputIterator last, OutputIterator out) const
+{
+    for (; first != last; ++first)
+    {
+        *out++ = const_iterator(container_->find(lookup(*first)),
+                                transform_.second);
+    }
+    return out;
+}
+
+template <typename Container, typename Transform>
+template <typename InputIterator>
+auto ContainerTransformer<Container, Transform>::encode(
+    InputIterator first, InputIterator last) const
+{
+    using encoder_type = typename Transform::first_type;
+    using encoded_type = std::decay_t<decltype(
+        std::declval<encoder_type&>()(*std::declval<InputIterator&>()))>;
+    auto result = std::vector<encoded_type>();
+    using category =
+        typename std::iterator_traits<InputIterator>::iterator_category;
+    if constexpr (detail::is_concurrent<encoder_type>::value &&
+                  std::is_base_of<std::random_access_iterator_tag,
+                                  category>::value)
+    {
+        result.resize(static_cast<std::size_t>(std::distance(first, last)));
+        parallelTransform(first, last, result.begin(), transform_.first);
+    }
+    else
+    {
+        auto encoder = transform_.first;
+        for (; first != last; ++first)
+        {
+            result.push_back(encoder(*first));
+        }
+    }
+    return result;
+}
+
+template <typename Container, typename Transform>
+template <typename Encoded>
+void ContainerTransformer<Container, Transform>::sort(
+    std::vector<Encoded>& encoded) const
+{
+    if constexpr (detail::is_ordered_container<Container>::value)
+    {
+        auto compare = container_->key_comp();
+        std::stable_sort(encoded.begin(), encoded.end(),
+                         [&compare](const Encoded& lhs, const Encoded& rhs) {
+                             return compare(
+                                 detail::key_of<Container>(lhs),
+                                 detail::key_of<Container>(rhs));
+                         });
+    }
+}
+
+template <typename Container, typename Transform>
+typename ContainerTransformer<Container, Transform>::container_type::key_type&
+ContainerTransformer<Container, Transform>::scratch()
+{
+    static thread_local typename container_type::key_type result;
+    return result;
+}
+
+template <typename Container, typename Transform>
+template <typename Key>
+decltype(auto)
+ContainerTransformer<Container, Transform>::lookup(const Key& key) const
+{
+    using encoder_type = typename Transform::first_type;
+    if constexpr (detail::has_projection<encoder_type, Key>::value)
+    {
+        return transform_.first.project(key);
+    }
+    else if constexpr (detail::can_encode_into<
+                           encoder_type, Key,
+                           typename container_type::key_type>::value)
+    {
+        auto& encoded = scratch();
+        transform_.first(key, encoded);
+        return static_cast<const typename container_type::key_type&>(encoded);
+    }
+    else
+    {
+        return transform_.first(key);
+    }
+}
+
+template <typename Container, typename Transform>
+template <typename Key>
+typename ContainerTransformer<Container, Transform>::size_type
+ContainerTransformer<Container, Transform>::eraseLookup(const Key& key)
+{
+    using decoder_type = typename Transform::second_type;
+    using stored_type = typename container_type::value_type;
+    if constexpr (detail::has_invalidate<decoder_type, stored_type>::value ||
+                  !std::is_same<Key, typename container_type::key_type>::value)
+    {
+        /** Heterogeneous keys can only be erased by position */
+        auto range = container_->equal_range(key);
+        auto result = size_type(0);
+        for (auto it = range.first; it != range.second; ++it, ++result)
+        {
+            invalidate(*it);
+        }
+        container_->erase(range.first, range.second);
+        return result;
+    }
+    else
+    {
+        return container_->erase(key);
+    }
+}
+
+template <typename Container, typename Transform>
+void ContainerTransformer<Container, Transform>::invalidate(
+    const typename container_type::value_type& stored) const
 {
-    return const_iterator(container_->find(transform_.first(key)));
+    using decoder_type = typename Transform::second_type;
+    if constexpr (detail::has_invalidate<
+                      decoder_type,
+                      typename container_type::value_type>::value)
+    {
+        transform_.second.invalidate(stored);
+    }
+    else
+    {
+        (void)stored;
+    }
 }
 
 } // namespace toolbox
@@ -0,0 +1 @@
+#include <toolbox/DecodeCache.h>
@@ -0,0 +1,221 @@
+#pragma once
+
+#include <cstddef>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+
+namespace toolbox
+{
+
+/** Bounded least-recently-used cache of decoded values, keyed by the address
+ * of the stored element they were decoded from
+ *
+ * Values are handed out as shared pointers, so one evicted or invalidated
+ * while still referenced lives until its last pointer goes. Members may be
+ * called concurrently; values are decoded outside the cache's lock
+ */
+template <typename Value>
+class DecodeCache
+{
+public:
+    using value_type = Value;
+    using pointer = std::shared_ptr<const Value>;
+    using size_type = std::size_t;
+
+    /** Hold up to capacity values, or any number if capacity is 0 */
+    explicit DecodeCache(size_type capacity = 1024);
+
+    /** Get the value decoded from element, calling decode() on a miss */
+    template <typename Decode>
+    pointer get(const void* element, Decode&& decode);
+
+    /** Discard the value decoded from element, if any */
+    void invalidate(const void* element);
+
+    /** Discard every value */
+    void invalidate();
+
+    size_type size() const;
+
+    size_type capacity() const;
+
+private:
+    using entry_type = std::pair<const void*, pointer>;
+    using list_type = std::list<entry_type>;
+
+    size_type capacity_;
+    mutable std::mutex mutex_;
+    list_type entries_; /**< Most recently used first */
+    std::unordered_map<const void*, typename list_type::iterator> index_;
+};
+
+/** Decoder which caches the values decoded by another Decoder
+ *
+ * Values come from a DecodeCache which is shared by every copy of the
+ * CachingDecoder, including those held by iterators. Used as the second
+ * functor of a ContainerTransformer's Transform, the cache is invalidated by
+ * insert, erase and clear.
+ *
+ * A decoded value is returned pinned by a shared pointer, which an
+ * IteratorTransformer holds, so a reference from dereferencing an iterator
+ * stays valid while the iterator does, even if the cache evicts the value.
+ * The cache is locked, so a const transformer may be read by several threads
+ */
+template <typename Decoder, typename Stored>
+class CachingDecoder
+{
+public:
+    using value_type = std::decay_t<decltype(
+        std::declval<const Decoder&>()(std::declval<const Stored&>()))>;
+    using cache_type = DecodeCache<value_type>;
+    using size_type = typename cache_type::size_type;
+
+    static constexpr bool pins_result = true;
+
+    /** Cache up to capacity values, or any number if capacity is 0 */
+    explicit CachingDecoder(Decoder decoder = Decoder(),
+                            size_type capacity = 1024);
+
+    typename cache_type::pointer operator()(const Stored& stored) const;
+
+    /** Decode anything other than a stored element, such as a key, without
+     * caching the result */
+    template <typename T>
+    auto operator()(const T& value) const -> decltype(
+        std::declval<const Decoder&>()(value))
+    {
+        return decoder_(value);
+    }
+
+    /** Discard the value decoded from stored */
+    void invalidate(const Stored& stored) const;
+
+    /** Discard every decoded value */
+    void invalidate() const;
+
+    const cache_type& cache() const;
+
+private:
+    Decoder decoder_;
+    std::shared_ptr<cache_type> cache_;
+};
+
+/** Replace the decoder of a Transform with a CachingDecoder */
+template <typename Transform, typename Stored>
+using CachedTransform =
+    std::pair<typename Transform::first_type,
+              CachingDecoder<typename Transform::second_type, Stored>>;
+
+/********************************IMPLEMENTATION********************************/
+
+template <typename Value>
+DecodeCache<Value>::DecodeCache(size_type capacity) : capacity_(capacity)
+{
+    index_.reserve(capacity_);
+}
+
+template <typename Value>
+template <typename Decode>
+typename DecodeCache<Value>::pointer
+DecodeCache<Value>::get(const void* element, Decode&& decode)
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+    auto found = index_.find(element);
+    if (found != index_.end())
+    {
+        entries_.splice(entries_.begin(), entries_, found->second);
+        return found->second->second;
+    }
+    lock.unlock();
+    auto value = std::make_shared<const Value>(decode());
+    lock.lock();
+    /** Another thread may have decoded the same element meanwhile */
+    found = index_.find(element);
+    if (found != index_.end())
+    {
+        entries_.splice(entries_.begin(), entries_, found->second);
+        return found->second->second;
+    }
+    if (capacity_ > 0 && entries_.size() >= capacity_)
+    {
+        index_.erase(entries_.back().first);
+        entries_.pop_back();
+    }
+    entries_.emplace_front(element, std::move(value));
+    index_.emplace(element, entries_.begin());
+    return entries_.front().second;
+}
+
+template <typename Value>
+void DecodeCache<Value>::invalidate(const void* element)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto found = index_.find(element);
+    if (found != index_.end())
+    {
+        entries_.erase(found->second);
+        index_.erase(found);
+    }
+}
+
+template <typename Value>
+void DecodeCache<Value>::invalidate()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    entries_.clear();
+    index_.clear();
+}
+
+template <typename Value>
+typename DecodeCache<Value>::size_type DecodeCache<Value>::size() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return entries_.size();
+}
+
+template <typename Value>
+typename DecodeCache<Value>::size_type DecodeCache<Value>::capacity() const
+{
+    return capacity_;
+}
+
+template <typename Decoder, typename Stored>
+CachingDecoder<Decoder, Stored>::CachingDecoder(Decoder decoder,
+                                                size_type capacity)
+    : decoder_(std::move(decoder)),
+      cache_(std::make_shared<cache_type>(capacity))
+{
+}
+
+template <typename Decoder, typename Stored>
+typename CachingDecoder<Decoder, Stored>::cache_type::pointer
+CachingDecoder<Decoder, Stored>::operator()(const Stored& stored) const
+{
+    return cache_->get(std::addressof(stored),
+                       [this, &stored]() { return decoder_(stored); });
+}
+
+template <typename Decoder, typename Stored>
+void CachingDecoder<Decoder, Stored>::invalidate(const Stored& stored) const
+{
+    cache_->invalidate(std::addressof(stored));
+}
+
+template <typename Decoder, typename Stored>
+void CachingDecoder<Decoder, Stored>::invalidate() const
+{
+    cache_->invalidate();
+}
+
+template <typename Decoder, typename Stored>
+const typename CachingDecoder<Decoder, Stored>::cache_type&
+CachingDecoder<Decoder, Stored>::cache() const
+{
+    return *cache_;
+}
+
+} // namespace toolbox
@@ -1,14 +1,25 @@
 #pragma once
 #include <memory>
 #include <type_traits>
+#include <utility>
 
 namespace toolbox
 {
 
+/** Customisation point for handle types which should be dereferenced like
+ * smart pointers, by dereference() and so by Value
+ *
+ * Specialise for a type with an element_type whose operator* gives the
+ * object it refers to */
+template <typename T>
+struct enable_smart_pointer : std::false_type
+{
+};
+
 namespace detail
 {
 template <typename T>
-struct is_smart_pointer_helper : std::false_type
+struct is_smart_pointer_helper : enable_smart_pointer<T>
 {
 };
 
@@ -35,10 +46,11 @@ struct is_smart_pointer
 {
 };
 
-/** Dereference a smart pointer */
+/** Dereference a smart pointer, as const if its operator* is */
 template <typename T>
-typename std::enable_if<is_smart_pointer<T>::value,
-                        typename T::element_type>::type&
+typename std::enable_if<
+    is_smart_pointer<T>::value,
+    std::remove_reference_t<decltype(*std::declval<T&>())>>::type&
 dereference(T& value)
 {
     return *value;
@@ -47,7 +59,7 @@ dereference(T& value)
 /** Dereference a raw pointer */
 template <typename T>
 typename std::enable_if<std::is_pointer<T>::value,
-                        std::remove_pointer<T>>::type&
+                        typename std::remove_pointer<T>::type>::type&
 dereference(T& value)
 {
     return *value;
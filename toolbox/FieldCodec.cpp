@@ -0,0 +1,121 @@
+#include <cstring>
+#include <stdexcept>
+#include <toolbox/Codecs.h>
+#include <toolbox/FieldCodec.h>
+
+namespace toolbox
+{
+
+namespace
+{
+
+template <typename Field>
+void encodeFields(std::span<const Field> fields, std::string& output)
+{
+    auto size = output.size();
+    for (const auto& field : fields)
+    {
+        size += VarintEncoder::max_length + field.size();
+    }
+    output.reserve(size);
+    for (const auto& field : fields)
+    {
+        VarintEncoder()(field.size(), output);
+        output.append(field);
+    }
+}
+
+/** Read the field at the front of input, removing it */
+std::string_view nextField(std::string_view& input)
+{
+    auto length = std::uint64_t(0);
+    auto consumed = VarintDecoder()(input, length);
+    if (consumed == 0 || length > input.size() - consumed)
+    {
+        throw std::invalid_argument("FieldDecoder: truncated field");
+    }
+    auto result = input.substr(consumed, length);
+    input.remove_prefix(consumed + length);
+    return result;
+}
+
+/** Append the fields of input to fields, which has room for them all */
+template <typename Vector>
+void decodeFields(std::string_view input, Vector& fields)
+{
+    while (!input.empty())
+    {
+        fields.push_back(nextField(input));
+    }
+}
+
+} // namespace
+
+std::string
+FieldEncoder::operator()(std::span<const std::string_view> fields) const
+{
+    auto result = std::string();
+    (*this)(fields, result);
+    return result;
+}
+
+std::string FieldEncoder::operator()(std::span<const std::string> fields) const
+{
+    auto result = std::string();
+    (*this)(fields, result);
+    return result;
+}
+
+void FieldEncoder::operator()(std::span<const std::string_view> fields,
+                              std::string& output) const
+{
+    encodeFields(fields, output);
+}
+
+void FieldEncoder::operator()(std::span<const std::string> fields,
+                              std::string& output) const
+{
+    encodeFields(fields, output);
+}
+
+std::vector<std::string_view>
+FieldDecoder::operator()(std::string_view input) const
+{
+    auto result = std::vector<std::string_view>();
+    result.reserve(size(input));
+    decodeFields(input, result);
+    return result;
+}
+
+std::pmr::vector<std::string_view>
+FieldDecoder::operator()(std::string_view input,
+                         std::pmr::memory_resource& arena) const
+{
+    auto result = std::pmr::vector<std::string_view>(&arena);
+    result.reserve(size(input));
+    if (!input.empty())
+    {
+        auto copy = static_cast<char*>(arena.allocate(input.size(), 1));
+        std::memcpy(copy, input.data(), input.size());
+        decodeFields(std::string_view(copy, input.size()), result);
+    }
+    return result;
+}
+
+std::size_t FieldDecoder::size(std::string_view input) const
+{
+    auto result = std::size_t(0);
+    while (!input.empty())
+    {
+        nextField(input);
+        ++result;
+    }
+    return result;
+}
+
+Codec<FieldEncoder, FieldDecoder> makeFieldCodec()
+{
+    return makeCodec(FieldEncoder(), FieldDecoder());
+}
+
+} // namespace toolbox
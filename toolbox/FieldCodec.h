@@ -0,0 +1,57 @@
+#pragma once
+
+#include <cstddef>
+#include <memory_resource>
+#include <span>
+#include <string>
+#include <string_view>
+#include <toolbox/Codec.h>
+#include <vector>
+
+namespace toolbox
+{
+
+/** Encodes a message as a sequence of fields, each a varint length followed
+ * by that many bytes. A field may itself hold an encoded message */
+class FieldEncoder
+{
+public:
+    std::string operator()(std::span<const std::string_view> fields) const;
+
+    std::string operator()(std::span<const std::string> fields) const;
+
+    void operator()(std::span<const std::string_view> fields,
+                    std::string& output) const;
+
+    void operator()(std::span<const std::string> fields,
+                    std::string& output) const;
+};
+
+/** Decodes the fields of a message without copying them
+ *
+ * Plain decoding returns views into the input, which must outlive them, and
+ * allocates only the vector which holds them. Decoding with an arena copies
+ * the input into it once, so the fields outlive the input and the whole
+ * result is released with the arena, after exactly two allocations however
+ * many fields there are. Nested messages can be decoded lazily from the
+ * fields which hold them.
+ *
+ * Throws std::invalid_argument if input ends within a field
+ */
+class FieldDecoder
+{
+public:
+    static constexpr bool views_input = true;
+
+    std::vector<std::string_view> operator()(std::string_view input) const;
+
+    std::pmr::vector<std::string_view>
+    operator()(std::string_view input, std::pmr::memory_resource& arena) const;
+
+    /** Count the fields of input */
+    std::size_t size(std::string_view input) const;
+};
+
+Codec<FieldEncoder, FieldDecoder> makeFieldCodec();
+
+} // namespace toolbox
@@ -0,0 +1 @@
+#include <toolbox/FixedSequencePredicate.h>
@@ -0,0 +1,237 @@
+#pragma once
+
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <utility>
+
+namespace toolbox
+{
+
+/** A SequencePredicate over a sequence known at compile time
+ *
+ * The sequence is a template parameter pack, compared with ==, so instead of
+ * walking iterators through a Compare each call tests the pair against the
+ * constants for each position, unrolled. The only state is the position, and
+ * everything is constexpr.
+ *
+ * Example:
+ * FixedSequencePredicate<'/', 'h', '/'>
+ * input = ('/', 'h')
+ * result = true
+ * */
+template <auto... Values>
+class FixedSequencePredicate
+{
+    static_assert(sizeof...(Values) > 0, "A sequence needs a value");
+
+public:
+    /** Type definitions */
+    using value_type = std::common_type_t<decltype(Values)...>;
+    using argument_type = std::pair<value_type, value_type>;
+    using result_type = bool;
+    using size_type = std::size_t;
+
+    static constexpr size_type size = sizeof...(Values);
+
+    static constexpr std::array<value_type, size> values = {Values...};
+
+    /** Operators */
+    constexpr result_type operator()(const argument_type& input);
+
+    /** Get the index in the sequence of the next pair to match */
+    constexpr size_type position() const;
+
+private:
+    template <std::size_t... I>
+    constexpr bool match(const argument_type& input,
+                         std::index_sequence<I...>) const;
+
+    /** Data */
+    size_type position_ = 0;
+};
+
+/** A StreamingSequencePredicate over a sequence known at compile time
+ *
+ * Matches with the bit-parallel Shift-And algorithm: bit i of the state is
+ * set while the last i + 1 inputs equal the first i + 1 values, and each
+ * input shifts the state and masks it with the positions holding the input,
+ * which is computed by comparing against each value in turn, unrolled. The
+ * state fits in one register, as the sequence may hold at most 64 values,
+ * and occurrences may overlap
+ * */
+template <auto... Values>
+class FixedStreamingSequencePredicate
+{
+    static_assert(sizeof...(Values) > 0, "A sequence needs a value");
+
+public:
+    /** Type definitions */
+    using value_type = std::common_type_t<decltype(Values)...>;
+    using argument_type = value_type;
+    using result_type = bool;
+    using size_type = std::size_t;
+
+    static constexpr size_type size = sizeof...(Values);
+
+    static_assert(size <= 64, "Use StreamingSequencePredicate beyond 64");
+
+    /** The smallest unsigned type with a bit per value */
+    using state_type = std::conditional_t<
+        (size <= 8),
+        std::uint8_t,
+        std::conditional_t<
+            (size <= 16),
+            std::uint16_t,
+            std::conditional_t<(size <= 32), std::uint32_t, std::uint64_t>>>;
+
+    static constexpr std::array<value_type, size> values = {Values...};
+
+    /** Returned by match_position() before any match */
+    static constexpr size_type npos = ~size_type(0);
+
+    /** Operators */
+    constexpr result_type operator()(const argument_type& input);
+
+    /** Whether the last input completed an occurrence */
+    constexpr bool matched() const;
+
+    /** Get the number of inputs since construction or reset() */
+    constexpr size_type position() const;
+
+    /** Get the position of the first input of the latest occurrence, or
+     * npos if there has been none */
+    constexpr size_type match_position() const;
+
+    /** Get the length of the partial match ending at the last input */
+    constexpr size_type progress() const;
+
+    /** Forget the inputs so far */
+    constexpr void reset();
+
+    /** Get the positions in the sequence which hold value */
+    static constexpr state_type mask(const value_type& value);
+
+private:
+    /** Data */
+    state_type state_ = 0;
+    size_type position_ = 0;
+    size_type match_position_ = npos;
+};
+
+namespace detail
+{
+
+template <auto Array, typename = std::make_index_sequence<Array.size()>>
+struct fixed_sequence;
+
+template <auto Array, std::size_t... I>
+struct fixed_sequence<Array, std::index_sequence<I...>>
+{
+    using predicate = FixedSequencePredicate<Array[I]...>;
+    using streaming = FixedStreamingSequencePredicate<Array[I]...>;
+};
+
+} // namespace detail
+
+/** The FixedSequencePredicate of the values of a constexpr std::array */
+template <auto Array>
+using FixedSequencePredicateOf =
+    typename detail::fixed_sequence<Array>::predicate;
+
+/** The FixedStreamingSequencePredicate of a constexpr std::array */
+template <auto Array>
+using FixedStreamingSequencePredicateOf =
+    typename detail::fixed_sequence<Array>::streaming;
+
+/********************************IMPLEMENTATION********************************/
+
+template <auto... Values>
+template <std::size_t... I>
+constexpr bool FixedSequencePredicate<Values...>::match(
+    const argument_type& input, std::index_sequence<I...>) const
+{
+    return ((position_ == I && input.first == values[I] &&
+             input.second == values[I + 1]) ||
+            ...);
+}
+
+template <auto... Values>
+constexpr typename FixedSequencePredicate<Values...>::result_type
+FixedSequencePredicate<Values...>::operator()(const argument_type& input)
+{
+    auto result = match(input, std::make_index_sequence<size - 1>());
+    position_ += result;
+    return result;
+}
+
+template <auto... Values>
+constexpr typename FixedSequencePredicate<Values...>::size_type
+FixedSequencePredicate<Values...>::position() const
+{
+    return position_;
+}
+
+template <auto... Values>
+constexpr typename FixedStreamingSequencePredicate<Values...>::state_type
+FixedStreamingSequencePredicate<Values...>::mask(const value_type& value)
+{
+    return [&value]<std::size_t... I>(std::index_sequence<I...>) {
+        return static_cast<state_type>(
+            ((value == values[I] ? state_type(1) << I : state_type(0)) | ... |
+             state_type(0)));
+    }(std::make_index_sequence<size>());
+}
+
+template <auto... Values>
+constexpr typename FixedStreamingSequencePredicate<Values...>::result_type
+FixedStreamingSequencePredicate<Values...>::operator()(
+    const argument_type& input)
+{
+    ++position_;
+    state_ = static_cast<state_type>((state_ << 1 | 1) & mask(input));
+    if (matched())
+    {
+        match_position_ = position_ - size;
+    }
+    return matched();
+}
+
+template <auto... Values>
+constexpr bool FixedStreamingSequencePredicate<Values...>::matched() const
+{
+    return (state_ >> (size - 1)) & 1;
+}
+
+template <auto... Values>
+constexpr typename FixedStreamingSequencePredicate<Values...>::size_type
+FixedStreamingSequencePredicate<Values...>::position() const
+{
+    return position_;
+}
+
+template <auto... Values>
+constexpr typename FixedStreamingSequencePredicate<Values...>::size_type
+FixedStreamingSequencePredicate<Values...>::match_position() const
+{
+    return match_position_;
+}
+
+template <auto... Values>
+constexpr typename FixedStreamingSequencePredicate<Values...>::size_type
+FixedStreamingSequencePredicate<Values...>::progress() const
+{
+    return static_cast<size_type>(std::bit_width(state_));
+}
+
+template <auto... Values>
+constexpr void FixedStreamingSequencePredicate<Values...>::reset()
+{
+    state_ = 0;
+    position_ = 0;
+    match_position_ = npos;
+}
+
+} // namespace toolbox
@@ -0,0 +1,100 @@
+#include <array>
+#include <new>
+#include <toolbox/FramePool.h>
+
+namespace toolbox
+{
+
+namespace
+{
+
+struct FreeFrame
+{
+    FreeFrame* next;
+};
+
+/** Idle frames owned by one thread */
+class FreeLists
+{
+public:
+    static constexpr std::size_t bucket_count =
+        FramePool::max_size / FramePool::alignment;
+
+    ~FreeLists()
+    {
+        for (auto& bucket : buckets_)
+        {
+            while (bucket.head)
+            {
+                auto frame = bucket.head;
+                bucket.head = frame->next;
+                ::operator delete(frame);
+            }
+        }
+    }
+
+    void* pop(std::size_t index)
+    {
+        auto& bucket = buckets_[index];
+        auto frame = bucket.head;
+        if (frame)
+        {
+            bucket.head = frame->next;
+            --bucket.size;
+        }
+        return frame;
+    }
+
+    bool push(std::size_t index, void* memory)
+    {
+        auto& bucket = buckets_[index];
+        auto result = bucket.size < FramePool::max_idle;
+        if (result)
+        {
+            auto frame = static_cast<FreeFrame*>(memory);
+            frame->next = bucket.head;
+            bucket.head = frame;
+            ++bucket.size;
+        }
+        return result;
+    }
+
+private:
+    struct Bucket
+    {
+        FreeFrame* head = nullptr;
+        std::size_t size = 0;
+    };
+
+    std::array<Bucket, bucket_count> buckets_;
+};
+
+thread_local FreeLists free_lists;
+
+std::size_t bucket(std::size_t size)
+{
+    return (size + FramePool::alignment - 1) / FramePool::alignment - 1;
+}
+
+} // namespace
+
+void* FramePool::allocate(std::size_t size)
+{
+    if (size == 0 || size > max_size)
+    {
+        return ::operator new(size);
+    }
+    auto index = bucket(size);
+    auto frame = free_lists.pop(index);
+    return frame ? frame : ::operator new((index + 1) * alignment);
+}
+
+void FramePool::deallocate(void* frame, std::size_t size)
+{
+    if (size == 0 || size > max_size || !free_lists.push(bucket(size), frame))
+    {
+        ::operator delete(frame);
+    }
+}
+
+} // namespace toolbox
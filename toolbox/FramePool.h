@@ -0,0 +1,49 @@
+#pragma once
+
+#include <cstddef>
+
+namespace toolbox
+{
+
+/** Recycles coroutine frames through thread-local free lists
+ *
+ * Frames are bucketed by size so that a coroutine which is repeatedly created
+ * and destroyed on the same thread, such as a Generator feeding a pipeline,
+ * reuses its previous frame instead of allocating a new one. Frames larger
+ * than max_size bypass the pool. A frame may be released on a different
+ * thread from the one which allocated it
+ */
+class FramePool
+{
+public:
+    /** Largest frame size which is pooled */
+    static constexpr std::size_t max_size = 1024;
+
+    /** Granularity of the size buckets */
+    static constexpr std::size_t alignment = 64;
+
+    /** Maximum number of idle frames retained per bucket and thread */
+    static constexpr std::size_t max_idle = 64;
+
+    /** Allocate a frame of at least size bytes */
+    static void* allocate(std::size_t size);
+
+    /** Return a frame obtained from allocate() with the same size */
+    static void deallocate(void* frame, std::size_t size);
+};
+
+/** Mixin which routes a coroutine promise's frame allocations to FramePool */
+struct PooledPromise
+{
+    static void* operator new(std::size_t size)
+    {
+        return FramePool::allocate(size);
+    }
+
+    static void operator delete(void* frame, std::size_t size)
+    {
+        FramePool::deallocate(frame, size);
+    }
+};
+
+} // namespace toolbox
@@ -0,0 +1,103 @@
+#include <toolbox/FramedCodec.h>
+
+namespace toolbox
+{
+
+void FrameIndex::put(std::string& output, std::uint64_t value)
+{
+    char bytes[8];
+    for (auto& byte : bytes)
+    {
+        byte = static_cast<char>(value & 0xff);
+        value >>= 8;
+    }
+    output.append(bytes, sizeof(bytes));
+}
+
+std::uint64_t FrameIndex::get(const char* input)
+{
+    auto result = std::uint64_t(0);
+    for (auto i = 8; i-- > 0;)
+    {
+        result = result << 8 | static_cast<unsigned char>(input[i]);
+    }
+    return result;
+}
+
+FrameIndex::FrameIndex(std::string_view framed,
+                       std::size_t max_decoded_size)
+    : framed_(framed)
+{
+    if (framed.size() < header_size || get(framed.data()) != magic)
+    {
+        throw std::invalid_argument("FrameIndex: missing header");
+    }
+    frame_size_ = get(framed.data() + 8);
+    decoded_size_ = get(framed.data() + 16);
+    size_ = get(framed.data() + 24);
+    /** Count frames without rounding up by addition, which could overflow */
+    if (frame_size_ == 0 ||
+        size_ != decoded_size_ / frame_size_ +
+                     (decoded_size_ % frame_size_ != 0) ||
+        (framed.size() - header_size) / entry_size < size_)
+    {
+        throw std::invalid_argument("FrameIndex: inconsistent header");
+    }
+    if (decoded_size_ > max_decoded_size)
+    {
+        throw std::invalid_argument("FrameIndex: decoded size too large");
+    }
+    auto payload = framed.size() - header_size - size_ * entry_size;
+    for (std::size_t i = 0; i < size_; ++i)
+    {
+        auto entry = framed.data() + header_size + i * entry_size;
+        auto offset = get(entry);
+        auto length = get(entry + 8);
+        if (offset > payload || length > payload - offset)
+        {
+            throw std::invalid_argument("FrameIndex: frame out of bounds");
+        }
+    }
+}
+
+std::size_t FrameIndex::size() const
+{
+    return size_;
+}
+
+std::size_t FrameIndex::frame_size() const
+{
+    return frame_size_;
+}
+
+std::size_t FrameIndex::decoded_size() const
+{
+    return decoded_size_;
+}
+
+std::string_view FrameIndex::frame(std::size_t i) const
+{
+    if (i >= size_)
+    {
+        throw std::out_of_range("FrameIndex: no such frame");
+    }
+    auto entry = framed_.data() + header_size + i * entry_size;
+    auto payload = header_size + size_ * entry_size;
+    return framed_.substr(payload + get(entry), get(entry + 8));
+}
+
+std::size_t FrameIndex::decoded_size(std::size_t i) const
+{
+    if (i >= size_)
+    {
+        throw std::out_of_range("FrameIndex: no such frame");
+    }
+    return std::min(frame_size_, decoded_size_ - i * frame_size_);
+}
+
+std::size_t FrameIndex::frame_at(std::size_t decoded_offset) const
+{
+    return decoded_offset / frame_size_;
+}
+
+} // namespace toolbox
@@ -0,0 +1,256 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <toolbox/Codec.h>
+#include <toolbox/Parallel.h>
+#include <toolbox/StreamCodec.h>
+#include <utility>
+#include <vector>
+
+namespace toolbox
+{
+
+/** The index of a buffer produced by FramedCodec
+ *
+ * The layout, with every integer a little endian uint64, is:
+ * - header: magic, frame size, decoded size, frame count
+ * - index: the offset of each encoded frame within the payload, and its size
+ * - payload: the encoded frames back to back
+ *
+ * Every frame but the last decodes to exactly frame size bytes, so the frame
+ * which holds a given decoded offset is found by division. The index refers
+ * into the buffer it was read from, which must outlive it. Throws
+ * std::invalid_argument if the buffer isn't well formed, or claims to decode
+ * to more than max_decoded_size bytes, which decoding allocates up front
+ */
+class FrameIndex
+{
+public:
+    static constexpr std::uint64_t magic = 0x314d415246425400; // "\0TBFRAM1"
+
+    static constexpr std::size_t header_size = 32;
+
+    static constexpr std::size_t entry_size = 16;
+
+    static constexpr std::size_t default_max_decoded_size = std::size_t(1)
+                                                            << 32;
+
+    explicit FrameIndex(
+        std::string_view framed,
+        std::size_t max_decoded_size = default_max_decoded_size);
+
+    /** Get the number of frames */
+    std::size_t size() const;
+
+    /** Get the number of bytes which each frame but the last decodes to */
+    std::size_t frame_size() const;
+
+    /** Get the number of bytes which the whole buffer decodes to */
+    std::size_t decoded_size() const;
+
+    /** Get the encoded bytes of frame i, throwing std::out_of_range unless
+     * i < size() */
+    std::string_view frame(std::size_t i) const;
+
+    /** Get the number of bytes which frame i decodes to, throwing
+     * std::out_of_range unless i < size() */
+    std::size_t decoded_size(std::size_t i) const;
+
+    /** Get the index of the frame holding a decoded offset */
+    std::size_t frame_at(std::size_t decoded_offset) const;
+
+    /** Append a header or index field to output */
+    static void put(std::string& output, std::uint64_t value);
+
+    /** Read a header or index field */
+    static std::uint64_t get(const char* input);
+
+private:
+    std::string_view framed_;
+    std::size_t frame_size_;
+    std::size_t decoded_size_;
+    std::size_t size_;
+};
+
+/** Encodes large buffers as independent frames on several threads
+ *
+ * Input is split into frames of frame_size bytes, which are encoded
+ * concurrently with parallelTransform, each thread using its own copy of
+ * the encoder. The result is framed with an index (see FrameIndex) so that
+ * decoding is also parallel and any single frame can be decoded on its own.
+ *
+ * Works with any Codec whose Encoder and Decoder map a std::string_view to
+ * a string, or append to one as ChunkStream accepts, and which can decode
+ * each frame independently of the others
+ */
+template <typename Encoder, typename Decoder>
+class FramedCodec
+{
+public:
+    using codec_type = Codec<Encoder, Decoder>;
+
+    static constexpr std::size_t default_frame_size = 1 << 20;
+
+    explicit FramedCodec(codec_type codec = codec_type(),
+                         std::size_t frame_size = default_frame_size,
+                         std::size_t max_decoded_size =
+                             FrameIndex::default_max_decoded_size);
+
+    codec_type& codec();
+
+    std::size_t frame_size() const;
+
+    /** Get the largest decoded size which decode accepts */
+    std::size_t max_decoded_size() const;
+
+    /** Encode input into a framed buffer */
+    std::string encode(std::string_view input);
+
+    /** Decode a whole framed buffer */
+    std::string decode(std::string_view framed);
+
+    /** Decode frame i of a framed buffer, throwing std::out_of_range unless
+     * i < index.size() */
+    std::string decode(const FrameIndex& index, std::size_t i);
+
+private:
+    codec_type codec_;
+    std::size_t frame_size_;
+    std::size_t max_decoded_size_;
+};
+
+template <typename Encoder, typename Decoder>
+FramedCodec<Encoder, Decoder>
+makeFramedCodec(Codec<Encoder, Decoder> codec,
+                std::size_t frame_size =
+                    FramedCodec<Encoder, Decoder>::default_frame_size,
+                std::size_t max_decoded_size =
+                    FrameIndex::default_max_decoded_size);
+
+/********************************IMPLEMENTATION********************************/
+
+template <typename Encoder, typename Decoder>
+FramedCodec<Encoder, Decoder>::FramedCodec(codec_type codec,
+                                           std::size_t frame_size,
+                                           std::size_t max_decoded_size)
+    : codec_(std::move(codec)),
+      frame_size_(std::max<std::size_t>(frame_size, 1)),
+      max_decoded_size_(max_decoded_size)
+{
+}
+
+template <typename Encoder, typename Decoder>
+typename FramedCodec<Encoder, Decoder>::codec_type&
+FramedCodec<Encoder, Decoder>::codec()
+{
+    return codec_;
+}
+
+template <typename Encoder, typename Decoder>
+std::size_t FramedCodec<Encoder, Decoder>::frame_size() const
+{
+    return frame_size_;
+}
+
+template <typename Encoder, typename Decoder>
+std::size_t FramedCodec<Encoder, Decoder>::max_decoded_size() const
+{
+    return max_decoded_size_;
+}
+
+template <typename Encoder, typename Decoder>
+std::string FramedCodec<Encoder, Decoder>::encode(std::string_view input)
+{
+    auto frames = std::vector<std::string_view>();
+    for (std::size_t offset = 0; offset < input.size(); offset += frame_size_)
+    {
+        frames.push_back(input.substr(offset, frame_size_));
+    }
+    auto encoded = std::vector<std::string>(frames.size());
+    parallelTransform(frames.begin(), frames.end(), encoded.begin(),
+                      [encoder = codec_.encoder()](
+                          std::string_view frame) mutable {
+                          auto result = std::string();
+                          detail::appendEncoded(encoder, frame, result);
+                          return result;
+                      },
+                      1);
+    auto payload = std::size_t(0);
+    for (const auto& frame : encoded)
+    {
+        payload += frame.size();
+    }
+    auto result = std::string();
+    result.reserve(FrameIndex::header_size +
+                   frames.size() * FrameIndex::entry_size + payload);
+    FrameIndex::put(result, FrameIndex::magic);
+    FrameIndex::put(result, frame_size_);
+    FrameIndex::put(result, input.size());
+    FrameIndex::put(result, frames.size());
+    auto offset = std::size_t(0);
+    for (const auto& frame : encoded)
+    {
+        FrameIndex::put(result, offset);
+        FrameIndex::put(result, frame.size());
+        offset += frame.size();
+    }
+    for (const auto& frame : encoded)
+    {
+        result += frame;
+    }
+    return result;
+}
+
+template <typename Encoder, typename Decoder>
+std::string FramedCodec<Encoder, Decoder>::decode(std::string_view framed)
+{
+    auto index = FrameIndex(framed, max_decoded_size_);
+    auto result = std::string(index.decoded_size(), '\0');
+    auto frames = std::vector<std::size_t>(index.size());
+    for (std::size_t i = 0; i < frames.size(); ++i)
+    {
+        frames[i] = i;
+    }
+    auto output = result.data();
+    /** Each frame decodes into its own slice of the result */
+    parallelTransform(frames.begin(), frames.end(), frames.begin(),
+                      [this, &index, output](std::size_t i) {
+                          auto decoded = decode(index, i);
+                          std::memcpy(output + i * index.frame_size(),
+                                      decoded.data(), decoded.size());
+                          return i;
+                      },
+                      1);
+    return result;
+}
+
+template <typename Encoder, typename Decoder>
+std::string FramedCodec<Encoder, Decoder>::decode(const FrameIndex& index,
+                                                  std::size_t i)
+{
+    auto decoder = codec_.decoder();
+    auto result = std::string();
+    detail::appendEncoded(decoder, index.frame(i), result);
+    if (result.size() != index.decoded_size(i))
+    {
+        throw std::invalid_argument("FramedCodec: frame has the wrong size");
+    }
+    return result;
+}
+
+template <typename Encoder, typename Decoder>
+FramedCodec<Encoder, Decoder> makeFramedCodec(Codec<Encoder, Decoder> codec,
+                                              std::size_t frame_size,
+                                              std::size_t max_decoded_size)
+{
+    return FramedCodec<Encoder, Decoder>(std::move(codec), frame_size,
+                                         max_decoded_size);
+}
+
+} // namespace toolbox
@@ -0,0 +1 @@
+#include <toolbox/Generator.h>
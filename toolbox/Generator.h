@@ -0,0 +1,304 @@
+#pragma once
+
+#include <coroutine>
+#include <cstddef>
+#include <exception>
+#include <iterator>
+#include <memory>
+#include <toolbox/FramePool.h>
+#include <type_traits>
+#include <utility>
+
+namespace toolbox
+{
+
+/** A lazily evaluated sequence produced by a coroutine with co_yield
+ *
+ * The coroutine runs until its next co_yield each time the iterator is
+ * incremented. Yielded values aren't copied: the iterator refers to the
+ * yielded object, which lives until the coroutine resumes. Coroutine frames
+ * are recycled through FramePool
+ *
+ * Example:
+ * Generator<int> count(int n)
+ * {
+ *     for (auto i = 0; i < n; ++i)
+ *     {
+ *         co_yield i;
+ *     }
+ * }
+ */
+template <typename T>
+class Generator
+{
+public:
+    using value_type = std::remove_cvref_t<T>;
+    using reference =
+        std::conditional_t<std::is_reference<T>::value, T, T&>;
+    using pointer = std::add_pointer_t<reference>;
+
+    class promise_type : public PooledPromise
+    {
+    public:
+        Generator get_return_object() noexcept;
+
+        std::suspend_always initial_suspend() const noexcept;
+
+        std::suspend_always final_suspend() const noexcept;
+
+        std::suspend_always
+        yield_value(std::remove_reference_t<T>& value) noexcept;
+
+        std::suspend_always
+        yield_value(std::remove_reference_t<T>&& value) noexcept;
+
+        void return_void() noexcept;
+
+        void unhandled_exception() noexcept;
+
+        /** Disallow co_await within a synchronous generator */
+        template <typename U>
+        std::suspend_never await_transform(U&& value) = delete;
+
+        reference value() const noexcept;
+
+        void rethrow();
+
+    private:
+        pointer value_ = nullptr;
+        std::exception_ptr exception_;
+    };
+
+    using handle_type = std::coroutine_handle<promise_type>;
+
+    /** Input iterator over the yielded values
+     *
+     * Copies of an iterator share the coroutine, so incrementing one advances
+     * them all. An iterator compares equal to end() once the coroutine has
+     * finished */
+    class iterator
+    {
+    public:
+        using iterator_category = std::input_iterator_tag;
+        using value_type = Generator::value_type;
+        using difference_type = std::ptrdiff_t;
+        using reference = Generator::reference;
+        using pointer = Generator::pointer;
+
+        iterator() noexcept = default;
+
+        explicit iterator(handle_type coroutine) noexcept;
+
+        iterator& operator++();
+
+        void operator++(int dummy);
+
+        reference operator*() const noexcept;
+
+        pointer operator->() const noexcept;
+
+        bool operator==(const iterator& rhs) const noexcept;
+
+        bool operator!=(const iterator& rhs) const noexcept;
+
+    private:
+        handle_type coroutine_;
+
+        bool done() const noexcept;
+    };
+
+    Generator() noexcept = default;
+
+    Generator(const Generator&) = delete;
+
+    Generator(Generator&& rhs) noexcept;
+
+    Generator& operator=(const Generator&) = delete;
+
+    Generator& operator=(Generator&& rhs) noexcept;
+
+    ~Generator();
+
+    /** Run the coroutine to its first co_yield
+     *
+     * May be called at most once */
+    iterator begin();
+
+    iterator end() noexcept;
+
+private:
+    explicit Generator(handle_type coroutine) noexcept;
+
+    handle_type coroutine_;
+};
+
+/********************************IMPLEMENTATION********************************/
+
+template <typename T>
+Generator<T> Generator<T>::promise_type::get_return_object() noexcept
+{
+    return Generator(handle_type::from_promise(*this));
+}
+
+template <typename T>
+std::suspend_always
+Generator<T>::promise_type::initial_suspend() const noexcept
+{
+    return {};
+}
+
+template <typename T>
+std::suspend_always Generator<T>::promise_type::final_suspend() const noexcept
+{
+    return {};
+}
+
+template <typename T>
+std::suspend_always Generator<T>::promise_type::yield_value(
+    std::remove_reference_t<T>& value) noexcept
+{
+    value_ = std::addressof(value);
+    return {};
+}
+
+template <typename T>
+std::suspend_always Generator<T>::promise_type::yield_value(
+    std::remove_reference_t<T>&& value) noexcept
+{
+    value_ = std::addressof(value);
+    return {};
+}
+
+template <typename T>
+void Generator<T>::promise_type::return_void() noexcept
+{
+}
+
+template <typename T>
+void Generator<T>::promise_type::unhandled_exception() noexcept
+{
+    exception_ = std::current_exception();
+}
+
+template <typename T>
+typename Generator<T>::reference
+Generator<T>::promise_type::value() const noexcept
+{
+    return static_cast<reference>(*value_);
+}
+
+template <typename T>
+void Generator<T>::promise_type::rethrow()
+{
+    if (exception_)
+    {
+        std::rethrow_exception(std::exchange(exception_, nullptr));
+    }
+}
+
+template <typename T>
+Generator<T>::iterator::iterator(handle_type coroutine) noexcept
+    : coroutine_(coroutine)
+{
+}
+
+template <typename T>
+bool Generator<T>::iterator::done() const noexcept
+{
+    return !coroutine_ || coroutine_.done();
+}
+
+template <typename T>
+typename Generator<T>::iterator& Generator<T>::iterator::operator++()
+{
+    coroutine_.resume();
+    coroutine_.promise().rethrow();
+    return *this;
+}
+
+template <typename T>
+void Generator<T>::iterator::operator++(int dummy)
+{
+    (void)dummy;
+    ++*this;
+}
+
+template <typename T>
+typename Generator<T>::reference Generator<T>::iterator::operator*() const
+    noexcept
+{
+    return coroutine_.promise().value();
+}
+
+template <typename T>
+typename Generator<T>::pointer Generator<T>::iterator::operator->() const
+    noexcept
+{
+    return std::addressof(**this);
+}
+
+template <typename T>
+bool Generator<T>::iterator::operator==(const iterator& rhs) const noexcept
+{
+    return done() ? rhs.done() : coroutine_ == rhs.coroutine_;
+}
+
+template <typename T>
+bool Generator<T>::iterator::operator!=(const iterator& rhs) const noexcept
+{
+    return !(*this == rhs);
+}
+
+template <typename T>
+Generator<T>::Generator(handle_type coroutine) noexcept
+    : coroutine_(coroutine)
+{
+}
+
+template <typename T>
+Generator<T>::Generator(Generator&& rhs) noexcept
+    : coroutine_(std::exchange(rhs.coroutine_, nullptr))
+{
+}
+
+template <typename T>
+Generator<T>& Generator<T>::operator=(Generator&& rhs) noexcept
+{
+    if (this != &rhs)
+    {
+        if (coroutine_)
+        {
+            coroutine_.destroy();
+        }
+        coroutine_ = std::exchange(rhs.coroutine_, nullptr);
+    }
+    return *this;
+}
+
+template <typename T>
+Generator<T>::~Generator()
+{
+    if (coroutine_)
+    {
+        coroutine_.destroy();
+    }
+}
+
+template <typename T>
+typename Generator<T>::iterator Generator<T>::begin()
+{
+    auto result = iterator(coroutine_);
+    if (coroutine_)
+    {
+        ++result;
+    }
+    return result;
+}
+
+template <typename T>
+typename Generator<T>::iterator Generator<T>::end() noexcept
+{
+    return iterator();
+}
+
+} // namespace toolbox
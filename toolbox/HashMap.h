@@ -1,7 +1,10 @@
 #pragma once
 
+#include <functional>
 #include <map>
+#include <memory_resource>
 #include <toolbox/LazyEvaluation.h>
+#include <type_traits>
 #include <utility>
 
 namespace toolbox
@@ -11,19 +14,22 @@ namespace toolbox
  * Hash function
  *
  * All iterators are const in order to preserve the invariant key = hash(value)
+ *
+ * The map's allocator may be passed on construction, e.g. to allocate every
+ * node from an ArenaResource through pmr::HashMap
  */
 template <typename T,
           typename Hash = std::hash<T>,
-          typename Map = std::map<typename Hash::result_type, T>>
+          typename Map = std::map<std::invoke_result_t<const Hash&, const T&>,
+                                  T>>
 class HashMap
 {
 public:
-    static_assert(std::is_same<typename Hash::result_type,
+    static_assert(std::is_same<std::invoke_result_t<const Hash&, const T&>,
                                typename Map::key_type>::value,
-                  "Hash::result_type != Map::key_type");
-    static_assert(std::is_same<typename Hash::argument_type,
-                               typename Map::mapped_type>::value,
-                  "Hash::argument_type != Map::mapped_type");
+                  "Hash result != Map::key_type");
+    static_assert(std::is_same<T, typename Map::mapped_type>::value,
+                  "T != Map::mapped_type");
 
     using key_type = typename Map::key_type;
     using mapped_type = typename Map::mapped_type;
@@ -41,6 +47,14 @@ public:
 
     explicit HashMap(Hash hash = Hash(), Map map = Map());
 
+    explicit HashMap(const allocator_type& allocator);
+
+    HashMap(Hash hash, const allocator_type& allocator);
+
+    HashMap(const HashMap& other, const allocator_type& allocator);
+
+    HashMap(HashMap&& other, const allocator_type& allocator);
+
     HashMap(const HashMap&) = default;
 
     HashMap(HashMap&&) noexcept = default;
@@ -77,6 +91,8 @@ public:
     const_iterator find(const key_type& key) const;
     const_iterator find(const mapped_type& value) const;
 
+    allocator_type get_allocator() const;
+
 private:
     Hash hash_;
     Map map_;
@@ -88,6 +104,32 @@ HashMap<T, Hash, Map>::HashMap(Hash hash, Map map)
 {
 }
 
+template <typename T, typename Hash, typename Map>
+HashMap<T, Hash, Map>::HashMap(const allocator_type& allocator)
+    : map_(allocator)
+{
+}
+
+template <typename T, typename Hash, typename Map>
+HashMap<T, Hash, Map>::HashMap(Hash hash, const allocator_type& allocator)
+    : hash_(std::move(hash)), map_(allocator)
+{
+}
+
+template <typename T, typename Hash, typename Map>
+HashMap<T, Hash, Map>::HashMap(const HashMap& other,
+                               const allocator_type& allocator)
+    : hash_(other.hash_), map_(other.map_, allocator)
+{
+}
+
+template <typename T, typename Hash, typename Map>
+HashMap<T, Hash, Map>::HashMap(HashMap&& other,
+                               const allocator_type& allocator)
+    : hash_(std::move(other.hash_)), map_(std::move(other.map_), allocator)
+{
+}
+
 template <typename T, typename Hash, typename Map>
 typename HashMap<T, Hash, Map>::iterator HashMap<T, Hash, Map>::begin()
 {
@@ -171,4 +213,23 @@ typename HashMap<T, Hash, Map>::const_iterator HashMap<T, Hash, Map>::find(
     return map_.find(key);
 }
 
+template <typename T, typename Hash, typename Map>
+typename HashMap<T, Hash, Map>::allocator_type
+HashMap<T, Hash, Map>::get_allocator() const
+{
+    return map_.get_allocator();
+}
+
+namespace pmr
+{
+
+/** A HashMap whose nodes come from a std::pmr::memory_resource */
+template <typename T, typename Hash = std::hash<T>>
+using HashMap = toolbox::HashMap<
+    T,
+    Hash,
+    std::pmr::map<std::invoke_result_t<const Hash&, const T&>, T>>;
+
+} // namespace pmr
+
 } // namespace toolbox
@@ -0,0 +1 @@
+#include <toolbox/InternTable.h>
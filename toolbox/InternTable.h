@@ -0,0 +1,243 @@
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <shared_mutex>
+#include <toolbox/Shards.h>
+#include <toolbox/Value.h>
+#include <unordered_map>
+#include <utility>
+
+namespace toolbox
+{
+
+/** Hash-conses immutable objects, so that equal objects share one
+ * canonical instance
+ *
+ * Interning an object returns a Value holding a shared pointer to the
+ * canonical instance equal to it, creating that from the object if there
+ * is none yet. Values of interned objects then compare and hash by
+ * pointer, in constant time however large the objects, and duplicates
+ * cost one object between them.
+ *
+ * The table may be shared between threads. As with SymbolTable, objects are
+ * spread over shards by hash, each guarded by its own reader-writer lock.
+ * Canonical instances live as long as the table, or until collect() finds
+ * them referenced by the table alone
+ *
+ * Example:
+ * a = table.intern(config)
+ * b = table.intern(copy of config)
+ * a == b and a.get() == b.get()
+ * */
+template <typename T,
+          typename Hash = std::hash<T>,
+          typename Equal = std::equal_to<T>>
+class InternTable
+{
+public:
+    /** Type definitions */
+    using value_type = Value<std::shared_ptr<const T>>;
+    using size_type = std::size_t;
+
+    /** Default number of shards, a few per hardware thread */
+    static size_type default_shard_count();
+
+    explicit InternTable(size_type shard_count = default_shard_count(),
+                         Hash hash = Hash(),
+                         Equal equal = Equal());
+
+    InternTable(const InternTable&) = delete;
+
+    InternTable& operator=(const InternTable&) = delete;
+
+    /** Get the canonical instance equal to object, interning it if new */
+    value_type intern(const T& object);
+
+    value_type intern(T&& object);
+
+    /** Intern the object constructed from args */
+    template <typename... Args>
+    value_type emplace(Args&&... args);
+
+    /** Get the canonical instance equal to object without interning it,
+     * if there is one */
+    std::optional<value_type> find(const T& object) const;
+
+    /** Get the number of canonical instances */
+    size_type size() const;
+
+    /** Drop the canonical instances held by no Value outside the table,
+     * returning how many were dropped */
+    size_type collect();
+
+private:
+    /** Objects are looked up by their hash, computed once */
+    struct Key
+    {
+        std::size_t hash;
+        const T* object;
+    };
+
+    struct KeyHash
+    {
+        std::size_t operator()(const Key& key) const;
+    };
+
+    struct KeyEqual
+    {
+        bool operator()(const Key& lhs, const Key& rhs) const;
+
+        Equal equal;
+    };
+
+    using Map =
+        std::unordered_map<Key, std::shared_ptr<const T>, KeyHash, KeyEqual>;
+
+    struct Shard
+    {
+        mutable std::shared_mutex mutex;
+        Map objects;
+    };
+
+    template <typename Object>
+    value_type insert(Object&& object);
+
+    detail::Shards<Shard> shards_;
+    Hash hash_;
+};
+
+/********************************IMPLEMENTATION********************************/
+
+template <typename T, typename Hash, typename Equal>
+typename InternTable<T, Hash, Equal>::size_type
+InternTable<T, Hash, Equal>::default_shard_count()
+{
+    return detail::defaultShardCount();
+}
+
+template <typename T, typename Hash, typename Equal>
+InternTable<T, Hash, Equal>::InternTable(size_type shard_count,
+                                         Hash hash,
+                                         Equal equal)
+    : shards_(shard_count), hash_(std::move(hash))
+{
+    for (size_type i = 0; i < shards_.size(); ++i)
+    {
+        shards_[i].objects = Map(0, KeyHash(), KeyEqual{equal});
+    }
+}
+
+template <typename T, typename Hash, typename Equal>
+std::size_t
+InternTable<T, Hash, Equal>::KeyHash::operator()(const Key& key) const
+{
+    return key.hash;
+}
+
+template <typename T, typename Hash, typename Equal>
+bool InternTable<T, Hash, Equal>::KeyEqual::operator()(const Key& lhs,
+                                                       const Key& rhs) const
+{
+    return lhs.hash == rhs.hash && equal(*lhs.object, *rhs.object);
+}
+
+template <typename T, typename Hash, typename Equal>
+template <typename Object>
+typename InternTable<T, Hash, Equal>::value_type
+InternTable<T, Hash, Equal>::insert(Object&& object)
+{
+    auto key = Key{hash_(object), &object};
+    auto& shard = shards_.shard(key.hash);
+    {
+        auto lock = std::shared_lock(shard.mutex);
+        auto it = shard.objects.find(key);
+        if (it != shard.objects.end())
+        {
+            return value_type(it->second);
+        }
+    }
+    auto lock = std::unique_lock(shard.mutex);
+    auto it = shard.objects.find(key);
+    if (it != shard.objects.end())
+    {
+        return value_type(it->second);
+    }
+    auto canonical = std::make_shared<const T>(std::forward<Object>(object));
+    /** The key views the canonical instance, which never moves */
+    key.object = canonical.get();
+    shard.objects.emplace(key, canonical);
+    return value_type(std::move(canonical));
+}
+
+template <typename T, typename Hash, typename Equal>
+typename InternTable<T, Hash, Equal>::value_type
+InternTable<T, Hash, Equal>::intern(const T& object)
+{
+    return insert(object);
+}
+
+template <typename T, typename Hash, typename Equal>
+typename InternTable<T, Hash, Equal>::value_type
+InternTable<T, Hash, Equal>::intern(T&& object)
+{
+    return insert(std::move(object));
+}
+
+template <typename T, typename Hash, typename Equal>
+template <typename... Args>
+typename InternTable<T, Hash, Equal>::value_type
+InternTable<T, Hash, Equal>::emplace(Args&&... args)
+{
+    return insert(T(std::forward<Args>(args)...));
+}
+
+template <typename T, typename Hash, typename Equal>
+std::optional<typename InternTable<T, Hash, Equal>::value_type>
+InternTable<T, Hash, Equal>::find(const T& object) const
+{
+    auto key = Key{hash_(object), &object};
+    auto& shard = shards_.shard(key.hash);
+    auto lock = std::shared_lock(shard.mutex);
+    auto it = shard.objects.find(key);
+    if (it == shard.objects.end())
+    {
+        return std::nullopt;
+    }
+    return value_type(it->second);
+}
+
+template <typename T, typename Hash, typename Equal>
+typename InternTable<T, Hash, Equal>::size_type
+InternTable<T, Hash, Equal>::size() const
+{
+    auto result = size_type(0);
+    for (size_type i = 0; i < shards_.size(); ++i)
+    {
+        auto lock = std::shared_lock(shards_[i].mutex);
+        result += shards_[i].objects.size();
+    }
+    return result;
+}
+
+template <typename T, typename Hash, typename Equal>
+typename InternTable<T, Hash, Equal>::size_type
+InternTable<T, Hash, Equal>::collect()
+{
+    auto result = size_type(0);
+    for (size_type i = 0; i < shards_.size(); ++i)
+    {
+        /** Other references are only ever copied under the lock, so one
+         * found unique stays unique */
+        auto lock = std::unique_lock(shards_[i].mutex);
+        result += std::erase_if(shards_[i].objects, [](const auto& entry) {
+            return entry.second.use_count() == 1;
+        });
+    }
+    return result;
+}
+
+} // namespace toolbox
@@ -0,0 +1 @@
+#include <toolbox/IntrusivePointer.h>
@@ -0,0 +1,361 @@
+#pragma once
+#include <atomic>
+#include <compare>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <toolbox/Dereference.h>
+#include <type_traits>
+#include <utility>
+
+namespace toolbox
+{
+
+/** Base class for objects whose reference count is held by the object
+ * itself, for IntrusivePointer
+ *
+ * Derived is the class deriving from it, which is deleted as a Derived when
+ * the last reference goes, whatever the type of the pointer released. So an
+ * object of exactly that class needs no virtual destructor, but Derived
+ * needs one for objects of classes derived further from it, which
+ * IntrusivePointer checks. Counts are
+ * atomic by default; objects only ever used by one thread can skip that
+ * with ThreadSafe = false. Copying an object doesn't copy its count
+ *
+ * Example:
+ * struct Node : RefCounted<Node>
+ * auto node = makeIntrusivePointer<Node>()
+ * */
+template <typename Derived, bool ThreadSafe = true>
+class RefCounted
+{
+public:
+    using count_type = std::uint32_t;
+
+    /** The class deleted when the last reference goes */
+    using ref_counted_type = Derived;
+
+    /** Get the number of IntrusivePointers to this object */
+    count_type use_count() const noexcept;
+
+protected:
+    RefCounted() noexcept = default;
+    RefCounted(const RefCounted&) noexcept;
+    RefCounted& operator=(const RefCounted&) noexcept;
+    ~RefCounted() = default;
+
+private:
+    /** Found by IntrusivePointer through argument dependent lookup, as
+     * those of other intrusively counted types may be */
+    friend void intrusive_add_ref(const RefCounted* object) noexcept
+    {
+        if constexpr (ThreadSafe)
+        {
+            object->count_.fetch_add(1, std::memory_order_relaxed);
+        }
+        else
+        {
+            ++object->count_;
+        }
+    }
+
+    friend void intrusive_release(const RefCounted* object) noexcept
+    {
+        if constexpr (ThreadSafe)
+        {
+            if (object->count_.fetch_sub(1, std::memory_order_acq_rel) != 1)
+            {
+                return;
+            }
+        }
+        else if (--object->count_ != 0)
+        {
+            return;
+        }
+        delete static_cast<const Derived*>(object);
+    }
+
+    using Count = std::conditional_t<ThreadSafe,
+                                     std::atomic<count_type>,
+                                     count_type>;
+
+    mutable Count count_ = 0;
+};
+
+namespace detail
+{
+
+/** Whether deleting a T through RefCounted is deleting it through a class
+ * with a virtual destructor or through T itself, trivially true of classes
+ * counted some other way */
+template <typename T, typename = void>
+struct is_intrusively_deletable : std::true_type
+{
+};
+
+template <typename T>
+struct is_intrusively_deletable<T,
+                                std::void_t<typename T::ref_counted_type>>
+    : std::bool_constant<
+          std::is_same_v<std::remove_cv_t<T>, typename T::ref_counted_type> ||
+          std::has_virtual_destructor_v<typename T::ref_counted_type>>
+{
+};
+
+} // namespace detail
+
+/** A pointer to an object which counts its own references
+ *
+ * T is typically derived from RefCounted, but may be any type for which
+ * intrusive_add_ref(const T*) and intrusive_release(const T*) are found by
+ * argument dependent lookup. Since the count lives in the object, there is
+ * no separate control block to allocate and the pointer is a single word.
+ * Any number of IntrusivePointers may be made from the same raw pointer.
+ *
+ * IntrusivePointers are dereferenced like smart pointers, so may be held
+ * by Value, and compare and hash by address
+ * */
+template <typename T>
+class IntrusivePointer
+{
+public:
+    /** Type definitions */
+    using element_type = T;
+
+    /** Constructors */
+    IntrusivePointer() noexcept = default;
+
+    IntrusivePointer(std::nullptr_t) noexcept;
+
+    /** Take a reference to object, if not null */
+    explicit IntrusivePointer(T* object) noexcept;
+
+    IntrusivePointer(const IntrusivePointer& other) noexcept;
+
+    IntrusivePointer(IntrusivePointer&& other) noexcept;
+
+    template <typename U,
+              typename = std::enable_if_t<std::is_convertible_v<U*, T*>>>
+    IntrusivePointer(const IntrusivePointer<U>& other) noexcept;
+
+    template <typename U,
+              typename = std::enable_if_t<std::is_convertible_v<U*, T*>>>
+    IntrusivePointer(IntrusivePointer<U>&& other) noexcept;
+
+    IntrusivePointer& operator=(const IntrusivePointer& other) noexcept;
+
+    IntrusivePointer& operator=(IntrusivePointer&& other) noexcept;
+
+    ~IntrusivePointer();
+
+    /** Release the object, referring to object instead */
+    void reset(T* object = nullptr) noexcept;
+
+    void swap(IntrusivePointer& other) noexcept;
+
+    /** Accessors */
+    T* get() const noexcept;
+
+    T& operator*() const noexcept;
+
+    T* operator->() const noexcept;
+
+    explicit operator bool() const noexcept;
+
+    /** Comparisons */
+    template <typename U>
+    bool operator==(const IntrusivePointer<U>& rhs) const noexcept;
+
+    template <typename U>
+    std::strong_ordering
+    operator<=>(const IntrusivePointer<U>& rhs) const noexcept;
+
+    bool operator==(std::nullptr_t) const noexcept;
+
+private:
+    template <typename U>
+    friend class IntrusivePointer;
+
+    T* object_ = nullptr;
+};
+
+template <typename T>
+struct enable_smart_pointer<IntrusivePointer<T>> : std::true_type
+{
+};
+
+/** Construct a T from args and get an IntrusivePointer to it */
+template <typename T, typename... Args>
+IntrusivePointer<T> makeIntrusivePointer(Args&&... args);
+
+/********************************IMPLEMENTATION********************************/
+
+template <typename Derived, bool ThreadSafe>
+typename RefCounted<Derived, ThreadSafe>::count_type
+RefCounted<Derived, ThreadSafe>::use_count() const noexcept
+{
+    if constexpr (ThreadSafe)
+    {
+        return count_.load(std::memory_order_relaxed);
+    }
+    else
+    {
+        return count_;
+    }
+}
+
+template <typename Derived, bool ThreadSafe>
+RefCounted<Derived, ThreadSafe>::RefCounted(const RefCounted&) noexcept
+{
+}
+
+template <typename Derived, bool ThreadSafe>
+RefCounted<Derived, ThreadSafe>&
+RefCounted<Derived, ThreadSafe>::operator=(const RefCounted&) noexcept
+{
+    return *this;
+}
+
+template <typename T>
+IntrusivePointer<T>::IntrusivePointer(std::nullptr_t) noexcept
+{
+}
+
+template <typename T>
+IntrusivePointer<T>::IntrusivePointer(T* object) noexcept : object_(object)
+{
+    static_assert(detail::is_intrusively_deletable<T>::value,
+                  "Classes derived from RefCounted<Derived>'s Derived need "
+                  "Derived to have a virtual destructor");
+    if (object_)
+    {
+        intrusive_add_ref(object_);
+    }
+}
+
+template <typename T>
+IntrusivePointer<T>::IntrusivePointer(const IntrusivePointer& other) noexcept
+    : IntrusivePointer(other.object_)
+{
+}
+
+template <typename T>
+IntrusivePointer<T>::IntrusivePointer(IntrusivePointer&& other) noexcept
+    : object_(std::exchange(other.object_, nullptr))
+{
+}
+
+template <typename T>
+template <typename U, typename>
+IntrusivePointer<T>::IntrusivePointer(
+    const IntrusivePointer<U>& other) noexcept
+    : IntrusivePointer(static_cast<T*>(other.object_))
+{
+}
+
+template <typename T>
+template <typename U, typename>
+IntrusivePointer<T>::IntrusivePointer(IntrusivePointer<U>&& other) noexcept
+    : object_(std::exchange(other.object_, nullptr))
+{
+}
+
+template <typename T>
+IntrusivePointer<T>&
+IntrusivePointer<T>::operator=(const IntrusivePointer& other) noexcept
+{
+    IntrusivePointer(other).swap(*this);
+    return *this;
+}
+
+template <typename T>
+IntrusivePointer<T>&
+IntrusivePointer<T>::operator=(IntrusivePointer&& other) noexcept
+{
+    IntrusivePointer(std::move(other)).swap(*this);
+    return *this;
+}
+
+template <typename T>
+IntrusivePointer<T>::~IntrusivePointer()
+{
+    if (object_)
+    {
+        intrusive_release(object_);
+    }
+}
+
+template <typename T>
+void IntrusivePointer<T>::reset(T* object) noexcept
+{
+    IntrusivePointer(object).swap(*this);
+}
+
+template <typename T>
+void IntrusivePointer<T>::swap(IntrusivePointer& other) noexcept
+{
+    std::swap(object_, other.object_);
+}
+
+template <typename T>
+T* IntrusivePointer<T>::get() const noexcept
+{
+    return object_;
+}
+
+template <typename T>
+T& IntrusivePointer<T>::operator*() const noexcept
+{
+    return *object_;
+}
+
+template <typename T>
+T* IntrusivePointer<T>::operator->() const noexcept
+{
+    return object_;
+}
+
+template <typename T>
+IntrusivePointer<T>::operator bool() const noexcept
+{
+    return object_ != nullptr;
+}
+
+template <typename T>
+template <typename U>
+bool IntrusivePointer<T>::operator==(
+    const IntrusivePointer<U>& rhs) const noexcept
+{
+    return object_ == rhs.object_;
+}
+
+template <typename T>
+template <typename U>
+std::strong_ordering IntrusivePointer<T>::operator<=>(
+    const IntrusivePointer<U>& rhs) const noexcept
+{
+    return std::compare_three_way()(object_, rhs.object_);
+}
+
+template <typename T>
+bool IntrusivePointer<T>::operator==(std::nullptr_t) const noexcept
+{
+    return object_ == nullptr;
+}
+
+template <typename T, typename... Args>
+IntrusivePointer<T> makeIntrusivePointer(Args&&... args)
+{
+    return IntrusivePointer<T>(new T(std::forward<Args>(args)...));
+}
+
+} // namespace toolbox
+
+template <typename T>
+struct std::hash<toolbox::IntrusivePointer<T>>
+{
+    std::size_t operator()(const toolbox::IntrusivePointer<T>& pointer) const
+    {
+        return std::hash<T*>()(pointer.get());
+    }
+};
@@ -1,9 +1,35 @@
 #pragma once
 #include <iterator>
+#include <utility>
 
 namespace toolbox
 {
 
+/** A non-owning view of the half-open interval [begin, end) */
+template <typename Iterator>
+class Range
+{
+public:
+    using iterator = Iterator;
+    using value_type = typename std::iterator_traits<Iterator>::value_type;
+
+    explicit Range(Iterator begin = Iterator(), Iterator end = Iterator());
+
+    Iterator begin() const;
+
+    Iterator end() const;
+
+    bool empty() const;
+
+private:
+    Iterator begin_;
+    Iterator end_;
+};
+
+/** Make a Range from a pair of iterators */
+template <typename Iterator>
+Range<Iterator> makeRange(Iterator begin, Iterator end);
+
 /** Get the last value of an iterator within the given closed interval */
 template <typename Iterator>
 Iterator back(const Iterator& begin, const Iterator& end);
@@ -16,8 +42,42 @@ auto back(const Container& value);
 template <typename Iterator>
 Iterator end(const Iterator& begin, const Iterator& end);
 
+/** Skip the leading values in [begin, end) which satisfy a predicate */
+template <typename Iterator, typename Predicate>
+Iterator dropWhile(Iterator begin, const Iterator& end, Predicate predicate);
+
 /********************************IMPLEMENTATION********************************/
 
+template <typename Iterator>
+Range<Iterator>::Range(Iterator begin, Iterator end)
+    : begin_(std::move(begin)), end_(std::move(end))
+{
+}
+
+template <typename Iterator>
+Iterator Range<Iterator>::begin() const
+{
+    return begin_;
+}
+
+template <typename Iterator>
+Iterator Range<Iterator>::end() const
+{
+    return end_;
+}
+
+template <typename Iterator>
+bool Range<Iterator>::empty() const
+{
+    return begin_ == end_;
+}
+
+template <typename Iterator>
+Range<Iterator> makeRange(Iterator begin, Iterator end)
+{
+    return Range<Iterator>(std::move(begin), std::move(end));
+}
+
 template <typename Iterator>
 Iterator back(const Iterator& begin, const Iterator& end)
 {
@@ -47,4 +107,14 @@ Iterator end(const Iterator& begin, const Iterator& end)
     return result;
 }
 
+template <typename Iterator, typename Predicate>
+Iterator dropWhile(Iterator begin, const Iterator& end, Predicate predicate)
+{
+    while (begin != end && predicate(*begin))
+    {
+        ++begin;
+    }
+    return begin;
+}
+
 } // namespace toolbox
@@ -0,0 +1 @@
+#include <toolbox/IteratorChunker.h>
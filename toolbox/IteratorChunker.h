@@ -0,0 +1,136 @@
+#pragma once
+
+#include <cstddef>
+#include <iterator>
+#include <toolbox/Iterator.h>
+#include <utility>
+
+namespace toolbox
+{
+
+/** Groups an interval into consecutive batches of up to n values
+ *
+ * Each batch is a Range over the underlying interval rather than a copy, so
+ * batching doesn't allocate. The final batch may hold fewer than n values,
+ * and a size of 0 is taken as 1
+ */
+template <typename Iterator>
+class IteratorChunker
+{
+public:
+    using self_type = IteratorChunker;
+    using iterator_category = std::input_iterator_tag;
+    using value_type = Range<Iterator>;
+    using difference_type =
+        typename std::iterator_traits<Iterator>::difference_type;
+    using reference = value_type;
+    using pointer = void;
+    using size_type = std::size_t;
+
+    explicit IteratorChunker(Iterator it = Iterator{},
+                             Iterator end = Iterator{},
+                             size_type size = 1);
+
+    Iterator get() const;
+
+    self_type& operator++();
+
+    const self_type operator++(int dummy);
+
+    reference operator*() const;
+
+    bool operator==(const IteratorChunker& rhs) const;
+
+    bool operator!=(const IteratorChunker& rhs) const;
+
+private:
+    Iterator it_;
+    Iterator next_;
+    Iterator end_;
+    size_type size_;
+
+    /** Find the end of the current batch */
+    void measure();
+};
+
+/** Batch the interval [it, end) into Ranges of up to size values */
+template <typename Iterator>
+IteratorChunker<Iterator>
+makeIteratorChunker(Iterator it, Iterator end, std::size_t size);
+
+/********************************IMPLEMENTATION********************************/
+
+template <typename Iterator>
+IteratorChunker<Iterator>::IteratorChunker(Iterator it,
+                                           Iterator end,
+                                           size_type size)
+    : it_(std::move(it)), next_(it_), end_(std::move(end)),
+      size_(size == 0 ? 1 : size)
+{
+    measure();
+}
+
+template <typename Iterator>
+Iterator IteratorChunker<Iterator>::get() const
+{
+    return it_;
+}
+
+template <typename Iterator>
+void IteratorChunker<Iterator>::measure()
+{
+    next_ = it_;
+    for (size_type i = 0; i < size_ && next_ != end_; ++i)
+    {
+        ++next_;
+    }
+}
+
+template <typename Iterator>
+typename IteratorChunker<Iterator>::self_type& IteratorChunker<Iterator>::
+operator++()
+{
+    it_ = next_;
+    measure();
+    return *this;
+}
+
+template <typename Iterator>
+const typename IteratorChunker<Iterator>::self_type
+    IteratorChunker<Iterator>::operator++(int dummy)
+{
+    (void)dummy;
+    auto tmp = *this;
+    ++*this;
+    return tmp;
+}
+
+template <typename Iterator>
+typename IteratorChunker<Iterator>::reference IteratorChunker<Iterator>::
+operator*() const
+{
+    return value_type(it_, next_);
+}
+
+template <typename Iterator>
+bool IteratorChunker<Iterator>::
+operator==(const IteratorChunker<Iterator>& rhs) const
+{
+    return it_ == rhs.it_;
+}
+
+template <typename Iterator>
+bool IteratorChunker<Iterator>::
+operator!=(const IteratorChunker<Iterator>& rhs) const
+{
+    return it_ != rhs.it_;
+}
+
+template <typename Iterator>
+IteratorChunker<Iterator>
+makeIteratorChunker(Iterator it, Iterator end, std::size_t size)
+{
+    return IteratorChunker<Iterator>(std::move(it), std::move(end), size);
+}
+
+} // namespace toolbox
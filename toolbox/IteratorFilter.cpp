@@ -0,0 +1 @@
+#include <toolbox/IteratorFilter.h>
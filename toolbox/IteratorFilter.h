@@ -0,0 +1,139 @@
+#pragma once
+
+#include <iterator>
+#include <utility>
+
+namespace toolbox
+{
+
+/** Lazily skips the values of an Iterator which don't satisfy a Predicate
+ *
+ * Values are neither copied nor buffered: dereferencing yields the
+ * underlying Iterator's reference
+ */
+template <typename Predicate, typename Iterator>
+class IteratorFilter
+{
+public:
+    using self_type = IteratorFilter;
+    using iterator_category = std::input_iterator_tag;
+    using value_type = typename std::iterator_traits<Iterator>::value_type;
+    using difference_type =
+        typename std::iterator_traits<Iterator>::difference_type;
+    using reference = typename std::iterator_traits<Iterator>::reference;
+    using pointer = typename std::iterator_traits<Iterator>::pointer;
+
+    explicit IteratorFilter(Iterator it = Iterator{},
+                            Iterator end = Iterator{},
+                            Predicate predicate = Predicate{});
+
+    Iterator get() const;
+
+    self_type& operator++();
+
+    const self_type operator++(int dummy);
+
+    reference operator*() const;
+
+    pointer operator->() const;
+
+    bool operator==(const IteratorFilter& rhs) const;
+
+    bool operator!=(const IteratorFilter& rhs) const;
+
+private:
+    Iterator it_;
+    Iterator end_;
+    Predicate predicate_;
+
+    void skip();
+};
+
+/** Filter the interval [it, end) by a Predicate */
+template <typename Predicate, typename Iterator>
+IteratorFilter<Predicate, Iterator>
+makeIteratorFilter(Iterator it, Iterator end, Predicate predicate);
+
+/********************************IMPLEMENTATION********************************/
+
+template <typename Predicate, typename Iterator>
+IteratorFilter<Predicate, Iterator>::IteratorFilter(Iterator it,
+                                                    Iterator end,
+                                                    Predicate predicate)
+    : it_(std::move(it)), end_(std::move(end)),
+      predicate_(std::move(predicate))
+{
+    skip();
+}
+
+template <typename Predicate, typename Iterator>
+Iterator IteratorFilter<Predicate, Iterator>::get() const
+{
+    return it_;
+}
+
+template <typename Predicate, typename Iterator>
+void IteratorFilter<Predicate, Iterator>::skip()
+{
+    while (it_ != end_ && !predicate_(*it_))
+    {
+        ++it_;
+    }
+}
+
+template <typename Predicate, typename Iterator>
+typename IteratorFilter<Predicate, Iterator>::self_type&
+    IteratorFilter<Predicate, Iterator>::operator++()
+{
+    ++it_;
+    skip();
+    return *this;
+}
+
+template <typename Predicate, typename Iterator>
+const typename IteratorFilter<Predicate, Iterator>::self_type
+    IteratorFilter<Predicate, Iterator>::operator++(int dummy)
+{
+    (void)dummy;
+    auto tmp = *this;
+    ++*this;
+    return tmp;
+}
+
+template <typename Predicate, typename Iterator>
+typename IteratorFilter<Predicate, Iterator>::reference
+    IteratorFilter<Predicate, Iterator>::operator*() const
+{
+    return *it_;
+}
+
+template <typename Predicate, typename Iterator>
+typename IteratorFilter<Predicate, Iterator>::pointer
+    IteratorFilter<Predicate, Iterator>::operator->() const
+{
+    return &*it_;
+}
+
+template <typename Predicate, typename Iterator>
+bool IteratorFilter<Predicate, Iterator>::
+operator==(const IteratorFilter<Predicate, Iterator>& rhs) const
+{
+    return it_ == rhs.it_;
+}
+
+template <typename Predicate, typename Iterator>
+bool IteratorFilter<Predicate, Iterator>::
+operator!=(const IteratorFilter<Predicate, Iterator>& rhs) const
+{
+    return it_ != rhs.it_;
+}
+
+template <typename Predicate, typename Iterator>
+IteratorFilter<Predicate, Iterator>
+makeIteratorFilter(Iterator it, Iterator end, Predicate predicate)
+{
+    return IteratorFilter<Predicate, Iterator>(
+        std::move(it), std::move(end), std::move(predicate));
+}
+
+} // namespace toolbox
@@ -0,0 +1 @@
+#include <toolbox/IteratorFlattener.h>
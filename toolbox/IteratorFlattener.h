@@ -0,0 +1,156 @@
+#pragma once
+
+#include <iterator>
+#include <utility>
+
+namespace toolbox
+{
+
+/** Maps each value of an Iterator to a range and iterates over the values of
+ * every range in turn (flat map)
+ *
+ * Transform must return either a reference to a range or a non-owning range
+ * such as toolbox::Range, because only the range's iterators are retained
+ */
+template <typename Transform, typename Iterator>
+class IteratorFlattener
+{
+public:
+    using self_type = IteratorFlattener;
+    using range_type = decltype(std::declval<Transform&>()(
+        *std::declval<Iterator&>()));
+    using inner_iterator = decltype(std::begin(std::declval<range_type&>()));
+    using iterator_category = std::input_iterator_tag;
+    using value_type =
+        typename std::iterator_traits<inner_iterator>::value_type;
+    using difference_type =
+        typename std::iterator_traits<inner_iterator>::difference_type;
+    using reference = typename std::iterator_traits<inner_iterator>::reference;
+    using pointer = typename std::iterator_traits<inner_iterator>::pointer;
+
+    explicit IteratorFlattener(Iterator it = Iterator{},
+                               Iterator end = Iterator{},
+                               Transform transform = Transform{});
+
+    Iterator get() const;
+
+    self_type& operator++();
+
+    const self_type operator++(int dummy);
+
+    reference operator*() const;
+
+    pointer operator->() const;
+
+    bool operator==(const IteratorFlattener& rhs) const;
+
+    bool operator!=(const IteratorFlattener& rhs) const;
+
+private:
+    Iterator it_;
+    Iterator end_;
+    Transform transform_;
+    inner_iterator inner_;
+    inner_iterator inner_end_;
+
+    /** Advance the outer iterator until a non-empty range is found */
+    void settle();
+};
+
+/** Flat map the interval [it, end) with a Transform */
+template <typename Transform, typename Iterator>
+IteratorFlattener<Transform, Iterator>
+makeIteratorFlattener(Iterator it, Iterator end, Transform transform);
+
+/********************************IMPLEMENTATION********************************/
+
+template <typename Transform, typename Iterator>
+IteratorFlattener<Transform, Iterator>::IteratorFlattener(Iterator it,
+                                                          Iterator end,
+                                                          Transform transform)
+    : it_(std::move(it)), end_(std::move(end)),
+      transform_(std::move(transform)), inner_(), inner_end_()
+{
+    settle();
+}
+
+template <typename Transform, typename Iterator>
+Iterator IteratorFlattener<Transform, Iterator>::get() const
+{
+    return it_;
+}
+
+template <typename Transform, typename Iterator>
+void IteratorFlattener<Transform, Iterator>::settle()
+{
+    for (; it_ != end_; ++it_)
+    {
+        auto&& range = transform_(*it_);
+        inner_ = std::begin(range);
+        inner_end_ = std::end(range);
+        if (inner_ != inner_end_)
+        {
+            break;
+        }
+    }
+}
+
+template <typename Transform, typename Iterator>
+typename IteratorFlattener<Transform, Iterator>::self_type&
+    IteratorFlattener<Transform, Iterator>::operator++()
+{
+    if (++inner_ == inner_end_)
+    {
+        ++it_;
+        settle();
+    }
+    return *this;
+}
+
+template <typename Transform, typename Iterator>
+const typename IteratorFlattener<Transform, Iterator>::self_type
+    IteratorFlattener<Transform, Iterator>::operator++(int dummy)
+{
+    (void)dummy;
+    auto tmp = *this;
+    ++*this;
+    return tmp;
+}
+
+template <typename Transform, typename Iterator>
+typename IteratorFlattener<Transform, Iterator>::reference
+    IteratorFlattener<Transform, Iterator>::operator*() const
+{
+    return *inner_;
+}
+
+template <typename Transform, typename Iterator>
+typename IteratorFlattener<Transform, Iterator>::pointer
+    IteratorFlattener<Transform, Iterator>::operator->() const
+{
+    return &*inner_;
+}
+
+template <typename Transform, typename Iterator>
+bool IteratorFlattener<Transform, Iterator>::
+operator==(const IteratorFlattener<Transform, Iterator>& rhs) const
+{
+    return it_ == rhs.it_ && (it_ == end_ || inner_ == rhs.inner_);
+}
+
+template <typename Transform, typename Iterator>
+bool IteratorFlattener<Transform, Iterator>::
+operator!=(const IteratorFlattener<Transform, Iterator>& rhs) const
+{
+    return !(*this == rhs);
+}
+
+template <typename Transform, typename Iterator>
+IteratorFlattener<Transform, Iterator>
+makeIteratorFlattener(Iterator it, Iterator end, Transform transform)
+{
+    return IteratorFlattener<Transform, Iterator>(
+        std::move(it), std::move(end), std::move(transform));
+}
+
+} // namespace toolbox
@@ -0,0 +1 @@
+#include <toolbox/IteratorLimiter.h>
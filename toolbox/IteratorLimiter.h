@@ -0,0 +1,139 @@
+#pragma once
+
+#include <iterator>
+#include <utility>
+
+namespace toolbox
+{
+
+/** Ends an interval at the first value which doesn't satisfy a Predicate
+ *
+ * Once the Predicate fails the IteratorLimiter compares equal to the end of
+ * the underlying interval, so the remaining values are never visited
+ */
+template <typename Predicate, typename Iterator>
+class IteratorLimiter
+{
+public:
+    using self_type = IteratorLimiter;
+    using iterator_category = std::input_iterator_tag;
+    using value_type = typename std::iterator_traits<Iterator>::value_type;
+    using difference_type =
+        typename std::iterator_traits<Iterator>::difference_type;
+    using reference = typename std::iterator_traits<Iterator>::reference;
+    using pointer = typename std::iterator_traits<Iterator>::pointer;
+
+    explicit IteratorLimiter(Iterator it = Iterator{},
+                             Iterator end = Iterator{},
+                             Predicate predicate = Predicate{});
+
+    Iterator get() const;
+
+    self_type& operator++();
+
+    const self_type operator++(int dummy);
+
+    reference operator*() const;
+
+    pointer operator->() const;
+
+    bool operator==(const IteratorLimiter& rhs) const;
+
+    bool operator!=(const IteratorLimiter& rhs) const;
+
+private:
+    Iterator it_;
+    Iterator end_;
+    Predicate predicate_;
+
+    void limit();
+};
+
+/** Take values from [it, end) while they satisfy a Predicate */
+template <typename Predicate, typename Iterator>
+IteratorLimiter<Predicate, Iterator>
+makeIteratorLimiter(Iterator it, Iterator end, Predicate predicate);
+
+/********************************IMPLEMENTATION********************************/
+
+template <typename Predicate, typename Iterator>
+IteratorLimiter<Predicate, Iterator>::IteratorLimiter(Iterator it,
+                                                      Iterator end,
+                                                      Predicate predicate)
+    : it_(std::move(it)), end_(std::move(end)),
+      predicate_(std::move(predicate))
+{
+    limit();
+}
+
+template <typename Predicate, typename Iterator>
+Iterator IteratorLimiter<Predicate, Iterator>::get() const
+{
+    return it_;
+}
+
+template <typename Predicate, typename Iterator>
+void IteratorLimiter<Predicate, Iterator>::limit()
+{
+    if (it_ != end_ && !predicate_(*it_))
+    {
+        it_ = end_;
+    }
+}
+
+template <typename Predicate, typename Iterator>
+typename IteratorLimiter<Predicate, Iterator>::self_type&
+    IteratorLimiter<Predicate, Iterator>::operator++()
+{
+    ++it_;
+    limit();
+    return *this;
+}
+
+template <typename Predicate, typename Iterator>
+const typename IteratorLimiter<Predicate, Iterator>::self_type
+    IteratorLimiter<Predicate, Iterator>::operator++(int dummy)
+{
+    (void)dummy;
+    auto tmp = *this;
+    ++*this;
+    return tmp;
+}
+
+template <typename Predicate, typename Iterator>
+typename IteratorLimiter<Predicate, Iterator>::reference
+    IteratorLimiter<Predicate, Iterator>::operator*() const
+{
+    return *it_;
+}
+
+template <typename Predicate, typename Iterator>
+typename IteratorLimiter<Predicate, Iterator>::pointer
+    IteratorLimiter<Predicate, Iterator>::operator->() const
+{
+    return &*it_;
+}
+
+template <typename Predicate, typename Iterator>
+bool IteratorLimiter<Predicate, Iterator>::
+operator==(const IteratorLimiter<Predicate, Iterator>& rhs) const
+{
+    return it_ == rhs.it_;
+}
+
+template <typename Predicate, typename Iterator>
+bool IteratorLimiter<Predicate, Iterator>::
+operator!=(const IteratorLimiter<Predicate, Iterator>& rhs) const
+{
+    return it_ != rhs.it_;
+}
+
+template <typename Predicate, typename Iterator>
+IteratorLimiter<Predicate, Iterator>
+makeIteratorLimiter(Iterator it, Iterator end, Predicate predicate)
+{
+    return IteratorLimiter<Predicate, Iterator>(
+        std::move(it), std::move(end), std::move(predicate));
+}
+
+} // namespace toolbox
@@ -1,23 +1,30 @@
 #pragma once
 #include <algorithm>
+#include <cstddef>
 #include <iterator>
 #include <memory>
+#include <memory_resource>
 #include <vector>
 
 namespace toolbox
 {
 /** Fills a std::vector<Iterator>, which can then be
-'re-wound' with operator-- even in forward-only iterators like graph search */
+'re-wound' with operator-- even in forward-only iterators like graph search
+
+The recording, and the count which shares it between copies, are allocated
+from a std::pmr::memory_resource, the default resource unless one is given */
 template <typename Iterator>
-class IteratorRecorder : public std::iterator<std::input_iterator_tag,
-                                              typename Iterator::value_type>
+class IteratorRecorder
 {
 public: /** Type Definitions */
+    using iterator_category = std::input_iterator_tag;
     using reference = typename Iterator::reference;
     using value_type = typename Iterator::value_type;
+    using difference_type = std::ptrdiff_t;
+    using pointer = value_type*;
 
-private:                                              /** Data */
-    std::shared_ptr<std::vector<value_type>> values_; /** Cache */
+private: /** Data */
+    std::shared_ptr<std::pmr::vector<value_type>> values_; /** Cache */
     Iterator it_;
     typename std::vector<Iterator>::size_type index_; /** Current position */
 
@@ -28,6 +35,7 @@ private:
 public: /** Constructors */
     IteratorRecorder();
     explicit IteratorRecorder(Iterator it);
+    IteratorRecorder(Iterator it, std::pmr::memory_resource& resource);
 
 public: /** Operators */
     IteratorRecorder& operator++();
@@ -59,8 +67,16 @@ IteratorRecorder<Iterator>::IteratorRecorder()
 
 template <typename Iterator>
 IteratorRecorder<Iterator>::IteratorRecorder(Iterator it)
-    : values_(std::make_shared<std::vector<value_type>>()), it_(std::move(it)),
-      index_(0)
+    : IteratorRecorder(std::move(it), *std::pmr::get_default_resource())
+{
+}
+
+template <typename Iterator>
+IteratorRecorder<Iterator>::IteratorRecorder(
+    Iterator it, std::pmr::memory_resource& resource)
+    : values_(std::allocate_shared<std::pmr::vector<value_type>>(
+          std::pmr::polymorphic_allocator<>(&resource))),
+      it_(std::move(it)), index_(0)
 {
 }
 
@@ -0,0 +1 @@
+#include <toolbox/IteratorStrider.h>
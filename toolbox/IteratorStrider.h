@@ -0,0 +1,130 @@
+#pragma once
+
+#include <cstddef>
+#include <iterator>
+#include <utility>
+
+namespace toolbox
+{
+
+/** Visits every n-th value of an interval, starting with the first
+ *
+ * Stepping never moves past the end of the interval, so the length of the
+ * interval needn't be a multiple of the stride. A stride of 0 is taken as 1
+ */
+template <typename Iterator>
+class IteratorStrider
+{
+public:
+    using self_type = IteratorStrider;
+    using iterator_category = std::input_iterator_tag;
+    using value_type = typename std::iterator_traits<Iterator>::value_type;
+    using difference_type =
+        typename std::iterator_traits<Iterator>::difference_type;
+    using reference = typename std::iterator_traits<Iterator>::reference;
+    using pointer = typename std::iterator_traits<Iterator>::pointer;
+    using size_type = std::size_t;
+
+    explicit IteratorStrider(Iterator it = Iterator{},
+                             Iterator end = Iterator{},
+                             size_type stride = 1);
+
+    Iterator get() const;
+
+    self_type& operator++();
+
+    const self_type operator++(int dummy);
+
+    reference operator*() const;
+
+    pointer operator->() const;
+
+    bool operator==(const IteratorStrider& rhs) const;
+
+    bool operator!=(const IteratorStrider& rhs) const;
+
+private:
+    Iterator it_;
+    Iterator end_;
+    size_type stride_;
+};
+
+/** Stride through the interval [it, end) */
+template <typename Iterator>
+IteratorStrider<Iterator>
+makeIteratorStrider(Iterator it, Iterator end, std::size_t stride);
+
+/********************************IMPLEMENTATION********************************/
+
+template <typename Iterator>
+IteratorStrider<Iterator>::IteratorStrider(Iterator it,
+                                           Iterator end,
+                                           size_type stride)
+    : it_(std::move(it)), end_(std::move(end)),
+      stride_(stride == 0 ? 1 : stride)
+{
+}
+
+template <typename Iterator>
+Iterator IteratorStrider<Iterator>::get() const
+{
+    return it_;
+}
+
+template <typename Iterator>
+typename IteratorStrider<Iterator>::self_type& IteratorStrider<Iterator>::
+operator++()
+{
+    for (size_type i = 0; i < stride_ && it_ != end_; ++i)
+    {
+        ++it_;
+    }
+    return *this;
+}
+
+template <typename Iterator>
+const typename IteratorStrider<Iterator>::self_type
+    IteratorStrider<Iterator>::operator++(int dummy)
+{
+    (void)dummy;
+    auto tmp = *this;
+    ++*this;
+    return tmp;
+}
+
+template <typename Iterator>
+typename IteratorStrider<Iterator>::reference IteratorStrider<Iterator>::
+operator*() const
+{
+    return *it_;
+}
+
+template <typename Iterator>
+typename IteratorStrider<Iterator>::pointer IteratorStrider<Iterator>::
+operator->() const
+{
+    return &*it_;
+}
+
+template <typename Iterator>
+bool IteratorStrider<Iterator>::
+operator==(const IteratorStrider<Iterator>& rhs) const
+{
+    return it_ == rhs.it_;
+}
+
+template <typename Iterator>
+bool IteratorStrider<Iterator>::
+operator!=(const IteratorStrider<Iterator>& rhs) const
+{
+    return it_ != rhs.it_;
+}
+
+template <typename Iterator>
+IteratorStrider<Iterator>
+makeIteratorStrider(Iterator it, Iterator end, std::size_t stride)
+{
+    return IteratorStrider<Iterator>(std::move(it), std::move(end), stride);
+}
+
+} // namespace toolbox
@@ -1,15 +1,53 @@
 #pragma once
 
+#include <cstddef>
+#include <iterator>
 #include <memory>
+#include <toolbox/Composition.h>
+#include <type_traits>
 
 namespace toolbox
 {
+namespace detail
+{
+
+/** A Transform which declares static constexpr bool pins_result = true may
+ * return a std::shared_ptr to a result which it would otherwise drop, such
+ * as a value in a cache, so that the result lives while the pointer does */
+template <typename Transform, typename = void>
+struct pins_result : std::false_type
+{
+};
+
+template <typename Transform>
+struct pins_result<Transform, std::void_t<decltype(Transform::pins_result)>>
+    : std::bool_constant<Transform::pins_result>
+{
+};
+
+/** The result of a Transform, as a reference to the value pointed to where
+ * Result is a pointer pinning it */
+template <typename Transform,
+          typename Result,
+          bool = pins_result<Transform>::value>
+struct transform_result
+{
+    using type = Result;
+};
+
+template <typename Transform, typename T>
+struct transform_result<Transform, std::shared_ptr<T>, true>
+{
+    using type = T&;
+};
+
+template <typename Transform, typename Result>
+using transform_result_t = typename transform_result<Transform, Result>::type;
+
+} // namespace detail
 
 template <typename Transform, typename Iterator>
 class IteratorTransformer
-    : public std::iterator<std::input_iterator_tag,
-                           decltype(
-                               Transform()(typename Iterator::value_type()))>
 {
 public:
     using self_type = IteratorTransformer;
@@ -29,11 +67,28 @@ public:
 
     Iterator get() const;
 
-    using value_type = decltype(Transform()(typename Iterator::value_type()));
-    using reference = value_type&;
+    Transform transform() const;
+
+    /** Type returned by Transform
+     *
+     * If Transform returns an lvalue reference, such as a reference into a
+     * cache, the IteratorTransformer refers to the result instead of copying
+     * it. If it pins the result, the IteratorTransformer holds the pin and
+     * refers to the value pinned */
+    using result_type = detail::transform_result_t<
+        Transform,
+        decltype(Transform()(typename Iterator::value_type()))>;
+    using iterator_category = std::input_iterator_tag;
+    using value_type = std::remove_cvref_t<result_type>;
+    using difference_type = std::ptrdiff_t;
+    using reference =
+        std::conditional_t<std::is_lvalue_reference_v<result_type>,
+                           result_type,
+                           value_type&>;
     using const_reference = typename std::add_const<reference>::type;
-    using pointer = value_type*;
-    using const_pointer = value_type const*;
+    using pointer = std::add_pointer_t<reference>;
+    using const_pointer =
+        std::add_pointer_t<const std::remove_reference_t<reference>>;
 
     self_type operator++();
 
@@ -52,20 +107,35 @@ public:
     bool operator!=(const IteratorTransformer& rhs) const;
 
 private:
+    using returned_type =
+        decltype(Transform()(typename Iterator::value_type()));
+    static constexpr bool pinned =
+        !std::is_same_v<returned_type, result_type>;
+    using storage_type = std::conditional_t<
+        pinned,
+        returned_type,
+        std::conditional_t<std::is_lvalue_reference_v<result_type>,
+                           pointer,
+                           value_type>>;
+
     Iterator it_;
     Transform transform_;
-    mutable value_type value_;
+    mutable storage_type value_;
     mutable bool dirty_flag_;
 
     void evaluate();
 
+    void store(returned_type&& value) const;
+
+    reference load() const;
+
     void increment();
 };
 
 template <typename Transform, typename Iterator>
 IteratorTransformer<Transform, Iterator>::IteratorTransformer(
     Iterator it, Transform transform)
-    : it_(std::move(it)), transform_(transform), dirty_flag_(true)
+    : it_(std::move(it)), transform_(transform), value_(), dirty_flag_(true)
 {
 }
 
@@ -75,6 +145,12 @@ Iterator IteratorTransformer<Transform, Iterator>::get() const
     return it_;
 }
 
+template <typename Transform, typename Iterator>
+Transform IteratorTransformer<Transform, Iterator>::transform() const
+{
+    return transform_;
+}
+
 template <typename Transform, typename Iterator>
 void IteratorTransformer<Transform, Iterator>::increment()
 {
@@ -105,17 +181,49 @@ void IteratorTransformer<Transform, Iterator>::evaluate()
 {
     if (dirty_flag_)
     {
-        value_ = transform_(*it_);
+        store(transform_(*it_));
         dirty_flag_ = false;
     }
 }
 
+template <typename Transform, typename Iterator>
+void IteratorTransformer<Transform, Iterator>::store(
+    returned_type&& value) const
+{
+    if constexpr (pinned)
+    {
+        value_ = std::move(value);
+    }
+    else if constexpr (std::is_lvalue_reference_v<result_type>)
+    {
+        value_ = std::addressof(value);
+    }
+    else
+    {
+        value_ = std::move(value);
+    }
+}
+
+template <typename Transform, typename Iterator>
+typename IteratorTransformer<Transform, Iterator>::reference
+IteratorTransformer<Transform, Iterator>::load() const
+{
+    if constexpr (pinned || std::is_lvalue_reference_v<result_type>)
+    {
+        return *value_;
+    }
+    else
+    {
+        return value_;
+    }
+}
+
 template <typename Transform, typename Iterator>
 typename IteratorTransformer<Transform, Iterator>::reference
     IteratorTransformer<Transform, Iterator>::operator*()
 {
     evaluate();
-    return value_;
+    return load();
 }
 
 template <typename Transform, typename Iterator>
@@ -124,10 +232,10 @@ typename IteratorTransformer<Transform, Iterator>::const_reference
 {
     if (dirty_flag_)
     {
-        value_ = transform_(*it_);
+        store(transform_(*it_));
         dirty_flag_ = false;
     }
-    return value_;
+    return load();
 }
 
 template <typename Transform, typename Iterator>
@@ -135,7 +243,7 @@ typename IteratorTransformer<Transform, Iterator>::pointer
     IteratorTransformer<Transform, Iterator>::operator->()
 {
     evaluate();
-    return &value_;
+    return std::addressof(load());
 }
 
 template <typename Transform, typename Iterator>
@@ -144,10 +252,10 @@ typename IteratorTransformer<Transform, Iterator>::const_pointer
 {
     if (dirty_flag_)
     {
-        value_ = transform_(*it_);
+        store(transform_(*it_));
         dirty_flag_ = false;
     }
-    return &value_;
+    return std::addressof(load());
 }
 
 template <typename Transform, typename Iterator>
@@ -164,4 +272,63 @@ operator!=(const IteratorTransformer<Transform, Iterator>& rhs) const
     return it_ != rhs.it_;
 }
 
+/** Collapses a Transform applied over nested IteratorTransformers into a
+ * single IteratorTransformer over the innermost Iterator
+ *
+ * IteratorTransformer<F, IteratorTransformer<G, IteratorTransformer<H, It>>>
+ * becomes IteratorTransformer<Composition<Composition<F, G>, H>, It>, which
+ * holds one cached value and evaluates F(G(H(*it))) in a single step
+ */
+template <typename Transform, typename Iterator, typename = void>
+struct fused_transformer
+{
+    using type = IteratorTransformer<Transform, Iterator>;
+
+    static type make(Iterator it, Transform transform)
+    {
+        return type(std::move(it), std::move(transform));
+    }
+};
+
+/** Pinned results must be held by an IteratorTransformer, so aren't fused */
+template <typename Transform, typename Inner, typename Iterator>
+struct fused_transformer<
+    Transform,
+    IteratorTransformer<Inner, Iterator>,
+    std::enable_if_t<!detail::pins_result<Inner>::value>>
+{
+    using base_type =
+        fused_transformer<Composition<Transform, Inner>, Iterator>;
+    using type = typename base_type::type;
+
+    static type make(const IteratorTransformer<Inner, Iterator>& it,
+                     Transform transform)
+    {
+        return base_type::make(it.get(),
+                               compose(std::move(transform), it.transform()));
+    }
+};
+
+template <typename Transform, typename Iterator>
+using fused_transformer_t =
+    typename fused_transformer<Transform, Iterator>::type;
+
+/** Apply a Transform to an Iterator, fusing it with any IteratorTransformers
+ * which the Iterator already consists of */
+template <typename Transform, typename Iterator>
+fused_transformer_t<Transform, Iterator>
+makeIteratorTransformer(Iterator it, Transform transform = Transform())
+{
+    return fused_transformer<Transform, Iterator>::make(std::move(it),
+                                                        std::move(transform));
+}
+
+/** Collapse nested IteratorTransformers into a single IteratorTransformer */
+template <typename Transform, typename Iterator>
+fused_transformer_t<Transform, Iterator>
+fuse(const IteratorTransformer<Transform, Iterator>& it)
+{
+    return makeIteratorTransformer(it.get(), it.transform());
+}
+
 } // namespace toolbox
@@ -0,0 +1 @@
+#include <toolbox/IteratorZipper.h>
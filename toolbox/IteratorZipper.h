@@ -0,0 +1,149 @@
+#pragma once
+
+#include <cstddef>
+#include <initializer_list>
+#include <iterator>
+#include <tuple>
+#include <utility>
+
+namespace toolbox
+{
+
+/** Iterates over several intervals in lockstep
+ *
+ * Dereferencing yields a std::tuple of the underlying references. Two
+ * IteratorZippers compare equal when any of their iterators compare equal,
+ * so zipping intervals of different lengths stops at the shortest
+ */
+template <typename... Iterators>
+class IteratorZipper
+{
+public:
+    using self_type = IteratorZipper;
+    using iterator_category = std::input_iterator_tag;
+    using value_type = std::tuple<
+        typename std::iterator_traits<Iterators>::value_type...>;
+    using difference_type = std::ptrdiff_t;
+    using reference =
+        std::tuple<typename std::iterator_traits<Iterators>::reference...>;
+    using pointer = void;
+
+    IteratorZipper() = default;
+
+    explicit IteratorZipper(Iterators... its);
+
+    std::tuple<Iterators...> get() const;
+
+    self_type& operator++();
+
+    const self_type operator++(int dummy);
+
+    reference operator*() const;
+
+    bool operator==(const IteratorZipper& rhs) const;
+
+    bool operator!=(const IteratorZipper& rhs) const;
+
+private:
+    std::tuple<Iterators...> its_;
+
+    template <std::size_t... I>
+    void increment(std::index_sequence<I...>);
+
+    template <std::size_t... I>
+    reference dereference(std::index_sequence<I...>) const;
+
+    template <std::size_t... I>
+    bool equal(const IteratorZipper& rhs, std::index_sequence<I...>) const;
+};
+
+/** Zip several iterators together */
+template <typename... Iterators>
+IteratorZipper<Iterators...> makeIteratorZipper(Iterators... its);
+
+/********************************IMPLEMENTATION********************************/
+
+template <typename... Iterators>
+IteratorZipper<Iterators...>::IteratorZipper(Iterators... its)
+    : its_(std::move(its)...)
+{
+}
+
+template <typename... Iterators>
+std::tuple<Iterators...> IteratorZipper<Iterators...>::get() const
+{
+    return its_;
+}
+
+template <typename... Iterators>
+template <std::size_t... I>
+void IteratorZipper<Iterators...>::increment(std::index_sequence<I...>)
+{
+    (void)std::initializer_list<int>{(++std::get<I>(its_), 0)...};
+}
+
+template <typename... Iterators>
+template <std::size_t... I>
+typename IteratorZipper<Iterators...>::reference
+IteratorZipper<Iterators...>::dereference(std::index_sequence<I...>) const
+{
+    return reference(*std::get<I>(its_)...);
+}
+
+template <typename... Iterators>
+template <std::size_t... I>
+bool IteratorZipper<Iterators...>::equal(const IteratorZipper& rhs,
+                                         std::index_sequence<I...>) const
+{
+    auto result = false;
+    (void)std::initializer_list<int>{
+        (result = result || std::get<I>(its_) == std::get<I>(rhs.its_), 0)...};
+    return result;
+}
+
+template <typename... Iterators>
+typename IteratorZipper<Iterators...>::self_type&
+    IteratorZipper<Iterators...>::operator++()
+{
+    increment(std::index_sequence_for<Iterators...>());
+    return *this;
+}
+
+template <typename... Iterators>
+const typename IteratorZipper<Iterators...>::self_type
+    IteratorZipper<Iterators...>::operator++(int dummy)
+{
+    (void)dummy;
+    auto tmp = *this;
+    ++*this;
+    return tmp;
+}
+
+template <typename... Iterators>
+typename IteratorZipper<Iterators...>::reference
+    IteratorZipper<Iterators...>::operator*() const
+{
+    return dereference(std::index_sequence_for<Iterators...>());
+}
+
+template <typename... Iterators>
+bool IteratorZipper<Iterators...>::
+operator==(const IteratorZipper<Iterators...>& rhs) const
+{
+    return equal(rhs, std::index_sequence_for<Iterators...>());
+}
+
+template <typename... Iterators>
+bool IteratorZipper<Iterators...>::
+operator!=(const IteratorZipper<Iterators...>& rhs) const
+{
+    return !(*this == rhs);
+}
+
+template <typename... Iterators>
+IteratorZipper<Iterators...> makeIteratorZipper(Iterators... its)
+{
+    return IteratorZipper<Iterators...>(std::move(its)...);
+}
+
+} // namespace toolbox
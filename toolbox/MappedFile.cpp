@@ -0,0 +1,137 @@
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <system_error>
+#include <toolbox/MappedFile.h>
+#include <unistd.h>
+#include <utility>
+
+namespace toolbox
+{
+
+namespace
+{
+
+std::system_error error(const std::string& what)
+{
+    return std::system_error(errno, std::generic_category(), what);
+}
+
+int advice_flag(MappedFile::Advice advice)
+{
+    switch (advice)
+    {
+        case MappedFile::Advice::sequential:
+            return MADV_SEQUENTIAL;
+        case MappedFile::Advice::random:
+            return MADV_RANDOM;
+        case MappedFile::Advice::willneed:
+            return MADV_WILLNEED;
+        default:
+            return MADV_NORMAL;
+    }
+}
+
+} // namespace
+
+MappedFile::MappedFile(const std::string& path, Advice advice)
+{
+    auto fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0)
+    {
+        throw error("open " + path);
+    }
+    struct stat status;
+    if (::fstat(fd, &status) != 0)
+    {
+        auto result = error("stat " + path);
+        ::close(fd);
+        throw result;
+    }
+    size_ = static_cast<std::size_t>(status.st_size);
+    if (size_ > 0)
+    {
+        auto address = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (address == MAP_FAILED)
+        {
+            auto result = error("mmap " + path);
+            ::close(fd);
+            throw result;
+        }
+        data_ = static_cast<const char*>(address);
+        /** The advice is only a hint, so failing to give it isn't worth
+         * failing, and leaking, the mapping for */
+        ::madvise(address, size_, advice_flag(advice));
+    }
+    ::close(fd);
+}
+
+MappedFile::MappedFile(MappedFile&& rhs) noexcept
+    : data_(std::exchange(rhs.data_, nullptr)),
+      size_(std::exchange(rhs.size_, 0))
+{
+}
+
+MappedFile& MappedFile::operator=(MappedFile&& rhs) noexcept
+{
+    if (this != &rhs)
+    {
+        unmap();
+        data_ = std::exchange(rhs.data_, nullptr);
+        size_ = std::exchange(rhs.size_, 0);
+    }
+    return *this;
+}
+
+MappedFile::~MappedFile()
+{
+    unmap();
+}
+
+void MappedFile::unmap() noexcept
+{
+    if (data_)
+    {
+        ::munmap(const_cast<char*>(data_), size_);
+        data_ = nullptr;
+        size_ = 0;
+    }
+}
+
+const char* MappedFile::data() const noexcept
+{
+    return data_;
+}
+
+std::size_t MappedFile::size() const noexcept
+{
+    return size_;
+}
+
+bool MappedFile::empty() const noexcept
+{
+    return size_ == 0;
+}
+
+std::string_view MappedFile::view() const noexcept
+{
+    return std::string_view(data_, size_);
+}
+
+std::span<const std::byte> MappedFile::bytes() const noexcept
+{
+    return std::span<const std::byte>(
+        reinterpret_cast<const std::byte*>(data_), size_);
+}
+
+void MappedFile::advise(Advice advice) const
+{
+    if (data_ &&
+        ::madvise(const_cast<char*>(data_), size_, advice_flag(advice)) != 0)
+    {
+        throw error("madvise");
+    }
+}
+
+} // namespace toolbox
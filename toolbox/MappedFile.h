@@ -0,0 +1,66 @@
+#pragma once
+
+#include <cstddef>
+#include <span>
+#include <string>
+#include <string_view>
+
+namespace toolbox
+{
+
+/** A read-only memory mapping of a whole file
+ *
+ * Records can be read straight out of the mapping through string_view and
+ * span without copying them into the heap. Throws std::system_error if the
+ * file cannot be opened or mapped
+ */
+class MappedFile
+{
+public:
+    /** Expected access pattern, passed to the kernel as a paging hint */
+    enum class Advice
+    {
+        normal,
+        sequential,
+        random,
+        willneed
+    };
+
+    MappedFile() noexcept = default;
+
+    explicit MappedFile(const std::string& path,
+                        Advice advice = Advice::sequential);
+
+    MappedFile(const MappedFile&) = delete;
+
+    MappedFile(MappedFile&& rhs) noexcept;
+
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    MappedFile& operator=(MappedFile&& rhs) noexcept;
+
+    ~MappedFile();
+
+    const char* data() const noexcept;
+
+    std::size_t size() const noexcept;
+
+    bool empty() const noexcept;
+
+    /** View the contents as characters */
+    std::string_view view() const noexcept;
+
+    /** View the contents as bytes */
+    std::span<const std::byte> bytes() const noexcept;
+
+    /** Change the paging hint for the whole mapping */
+    void advise(Advice advice) const;
+
+private:
+    const char* data_ = nullptr;
+    std::size_t size_ = 0;
+
+    void unmap() noexcept;
+};
+
+} // namespace toolbox
@@ -0,0 +1,246 @@
+#include <algorithm>
+#include <memory>
+#include <toolbox/MemoryResource.h>
+
+namespace toolbox
+{
+
+namespace
+{
+
+/** Chunks are aligned for anything, as operator new would align them */
+constexpr auto chunk_alignment = alignof(std::max_align_t);
+
+std::size_t roundUp(std::size_t size)
+{
+    return (size + chunk_alignment - 1) / chunk_alignment * chunk_alignment;
+}
+
+} // namespace
+
+ArenaResource::ArenaResource(std::size_t chunk_size,
+                             std::pmr::memory_resource* upstream)
+    : upstream_(upstream), chunk_size_(std::max(chunk_size, sizeof(Chunk))),
+      next_size_(chunk_size_)
+{
+}
+
+ArenaResource::ArenaResource(void* buffer,
+                             std::size_t size,
+                             std::pmr::memory_resource* upstream)
+    : upstream_(upstream), buffer_(static_cast<char*>(buffer)),
+      buffer_size_(size), chunk_size_(std::max(size, default_chunk_size)),
+      next_size_(chunk_size_), cursor_(buffer_), end_(buffer_ + size)
+{
+}
+
+ArenaResource::~ArenaResource()
+{
+    free(chunks_);
+}
+
+void ArenaResource::free(Chunk* chunk)
+{
+    while (chunk)
+    {
+        auto next = chunk->next;
+        upstream_->deallocate(chunk, chunk->size, chunk_alignment);
+        chunk = next;
+    }
+}
+
+void ArenaResource::grow(std::size_t bytes, std::size_t alignment)
+{
+    auto size = std::max(next_size_, sizeof(Chunk) + bytes + alignment);
+    auto chunk =
+        static_cast<Chunk*>(upstream_->allocate(size, chunk_alignment));
+    chunk->next = chunks_;
+    chunk->size = size;
+    chunks_ = chunk;
+    cursor_ = reinterpret_cast<char*>(chunk + 1);
+    end_ = reinterpret_cast<char*>(chunk) + size;
+    capacity_ += size;
+    next_size_ = size * 2;
+}
+
+void* ArenaResource::do_allocate(std::size_t bytes, std::size_t alignment)
+{
+    void* pointer = cursor_;
+    auto space = static_cast<std::size_t>(end_ - cursor_);
+    if (!cursor_ || !std::align(alignment, bytes, pointer, space))
+    {
+        grow(bytes, alignment);
+        pointer = cursor_;
+        space = static_cast<std::size_t>(end_ - cursor_);
+        std::align(alignment, bytes, pointer, space);
+    }
+    cursor_ = static_cast<char*>(pointer) + bytes;
+    allocated_ += bytes;
+    return pointer;
+}
+
+void ArenaResource::do_deallocate(void* pointer,
+                                  std::size_t bytes,
+                                  std::size_t alignment)
+{
+    /** Memory is only reclaimed all at once */
+    static_cast<void>(pointer);
+    static_cast<void>(bytes);
+    static_cast<void>(alignment);
+}
+
+bool ArenaResource::do_is_equal(
+    const std::pmr::memory_resource& other) const noexcept
+{
+    return this == &other;
+}
+
+void ArenaResource::reset()
+{
+    allocated_ = 0;
+    if (!chunks_)
+    {
+        cursor_ = buffer_;
+        end_ = buffer_ + buffer_size_;
+        return;
+    }
+    if (chunks_->next)
+    {
+        next_size_ = capacity_;
+        free(chunks_);
+        chunks_ = nullptr;
+        capacity_ = 0;
+        grow(0, 1);
+        return;
+    }
+    cursor_ = reinterpret_cast<char*>(chunks_ + 1);
+    end_ = reinterpret_cast<char*>(chunks_) + chunks_->size;
+}
+
+void ArenaResource::release()
+{
+    free(chunks_);
+    chunks_ = nullptr;
+    allocated_ = 0;
+    capacity_ = 0;
+    next_size_ = chunk_size_;
+    cursor_ = buffer_;
+    end_ = buffer_ + buffer_size_;
+}
+
+std::size_t ArenaResource::allocated() const
+{
+    return allocated_;
+}
+
+std::size_t ArenaResource::capacity() const
+{
+    return capacity_;
+}
+
+std::pmr::memory_resource* ArenaResource::upstream_resource() const
+{
+    return upstream_;
+}
+
+PoolResource::PoolResource(std::size_t block_size,
+                           std::size_t blocks_per_chunk,
+                           std::pmr::memory_resource* upstream)
+    : upstream_(upstream), block_size_(roundUp(std::max(block_size,
+                                                        sizeof(Block)))),
+      blocks_per_chunk_(std::max<std::size_t>(blocks_per_chunk, 1))
+{
+}
+
+PoolResource::~PoolResource()
+{
+    release();
+}
+
+bool PoolResource::pooled(std::size_t bytes, std::size_t alignment) const
+{
+    return bytes <= block_size_ && alignment <= chunk_alignment;
+}
+
+void* PoolResource::do_allocate(std::size_t bytes, std::size_t alignment)
+{
+    if (!pooled(bytes, alignment))
+    {
+        return upstream_->allocate(bytes, alignment);
+    }
+    if (free_)
+    {
+        auto block = free_;
+        free_ = block->next;
+        ++used_;
+        return block;
+    }
+    if (cursor_ == end_)
+    {
+        /** The first block of each chunk links it to the previous chunk */
+        auto size = block_size_ * (blocks_per_chunk_ + 1);
+        auto chunk =
+            static_cast<Block*>(upstream_->allocate(size, chunk_alignment));
+        chunk->next = chunks_;
+        chunks_ = chunk;
+        cursor_ = reinterpret_cast<char*>(chunk) + block_size_;
+        end_ = reinterpret_cast<char*>(chunk) + size;
+    }
+    auto result = cursor_;
+    cursor_ += block_size_;
+    ++used_;
+    return result;
+}
+
+void PoolResource::do_deallocate(void* pointer,
+                                 std::size_t bytes,
+                                 std::size_t alignment)
+{
+    if (!pooled(bytes, alignment))
+    {
+        upstream_->deallocate(pointer, bytes, alignment);
+        return;
+    }
+    auto block = static_cast<Block*>(pointer);
+    block->next = free_;
+    free_ = block;
+    --used_;
+}
+
+bool PoolResource::do_is_equal(
+    const std::pmr::memory_resource& other) const noexcept
+{
+    return this == &other;
+}
+
+void PoolResource::release()
+{
+    auto size = block_size_ * (blocks_per_chunk_ + 1);
+    while (chunks_)
+    {
+        auto next = chunks_->next;
+        upstream_->deallocate(chunks_, size, chunk_alignment);
+        chunks_ = next;
+    }
+    free_ = nullptr;
+    cursor_ = nullptr;
+    end_ = nullptr;
+    used_ = 0;
+}
+
+std::size_t PoolResource::block_size() const
+{
+    return block_size_;
+}
+
+std::size_t PoolResource::used() const
+{
+    return used_;
+}
+
+std::pmr::memory_resource* PoolResource::upstream_resource() const
+{
+    return upstream_;
+}
+
+} // namespace toolbox
@@ -0,0 +1,158 @@
+#pragma once
+
+#include <cstddef>
+#include <memory_resource>
+
+namespace toolbox
+{
+
+/** A monotonic memory resource for allocations which die together, such as
+ * everything made while handling one request
+ *
+ * Allocating bumps a pointer through chunks taken from upstream, each twice
+ * the size of the last, and deallocating does nothing. reset() frees every
+ * allocation at once and merges the chunks into one as large as all of
+ * them, so that an arena reused for similar requests stops allocating from
+ * upstream after the first. Unlike std::pmr::monotonic_buffer_resource,
+ * whose release() returns every chunk, memory is only given back upstream
+ * by release() or destruction.
+ *
+ * An arena isn't thread safe
+ * */
+class ArenaResource : public std::pmr::memory_resource
+{
+public:
+    static constexpr std::size_t default_chunk_size = 4096;
+
+    explicit ArenaResource(
+        std::size_t chunk_size = default_chunk_size,
+        std::pmr::memory_resource* upstream =
+            std::pmr::get_default_resource());
+
+    /** Allocate from buffer, e.g. on the stack, before going upstream */
+    ArenaResource(
+        void* buffer,
+        std::size_t size,
+        std::pmr::memory_resource* upstream =
+            std::pmr::get_default_resource());
+
+    ArenaResource(const ArenaResource&) = delete;
+
+    ArenaResource& operator=(const ArenaResource&) = delete;
+
+    ~ArenaResource() override;
+
+    /** Free every allocation, keeping one chunk as large as all of them */
+    void reset();
+
+    /** Free every allocation, returning every chunk upstream */
+    void release();
+
+    /** Get the number of bytes allocated since the last reset */
+    std::size_t allocated() const;
+
+    /** Get the number of bytes held from upstream */
+    std::size_t capacity() const;
+
+    std::pmr::memory_resource* upstream_resource() const;
+
+private:
+    struct Chunk
+    {
+        Chunk* next;
+        std::size_t size; /**< Including this header */
+    };
+
+    void* do_allocate(std::size_t bytes, std::size_t alignment) override;
+
+    void do_deallocate(void* pointer,
+                       std::size_t bytes,
+                       std::size_t alignment) override;
+
+    bool do_is_equal(
+        const std::pmr::memory_resource& other) const noexcept override;
+
+    /** Take a chunk from upstream with room for bytes at alignment */
+    void grow(std::size_t bytes, std::size_t alignment);
+
+    void free(Chunk* chunk);
+
+    std::pmr::memory_resource* upstream_;
+    char* buffer_ = nullptr;
+    std::size_t buffer_size_ = 0;
+    std::size_t chunk_size_;
+    std::size_t next_size_;
+    Chunk* chunks_ = nullptr; /**< Newest first */
+    char* cursor_ = nullptr;
+    char* end_ = nullptr;
+    std::size_t allocated_ = 0;
+    std::size_t capacity_ = 0;
+};
+
+/** A memory resource of blocks of one size, such as the nodes of a map
+ *
+ * Blocks are carved from chunks of blocks_per_chunk taken from upstream and
+ * deallocated blocks are kept on a free list, so that allocating and
+ * deallocating are a few instructions each and freed blocks are reused at
+ * once. Requests for more than block_size bytes, or for more alignment than
+ * that of std::max_align_t, are passed upstream. Chunks go back upstream
+ * on release() or destruction.
+ *
+ * A pool isn't thread safe
+ * */
+class PoolResource : public std::pmr::memory_resource
+{
+public:
+    static constexpr std::size_t default_blocks_per_chunk = 256;
+
+    explicit PoolResource(
+        std::size_t block_size,
+        std::size_t blocks_per_chunk = default_blocks_per_chunk,
+        std::pmr::memory_resource* upstream =
+            std::pmr::get_default_resource());
+
+    PoolResource(const PoolResource&) = delete;
+
+    PoolResource& operator=(const PoolResource&) = delete;
+
+    ~PoolResource() override;
+
+    /** Free every block, returning every chunk upstream */
+    void release();
+
+    /** Get the size of each block, rounded up to keep blocks aligned */
+    std::size_t block_size() const;
+
+    /** Get the number of blocks allocated and not yet deallocated */
+    std::size_t used() const;
+
+    std::pmr::memory_resource* upstream_resource() const;
+
+private:
+    struct Block
+    {
+        Block* next;
+    };
+
+    void* do_allocate(std::size_t bytes, std::size_t alignment) override;
+
+    void do_deallocate(void* pointer,
+                       std::size_t bytes,
+                       std::size_t alignment) override;
+
+    bool do_is_equal(
+        const std::pmr::memory_resource& other) const noexcept override;
+
+    bool pooled(std::size_t bytes, std::size_t alignment) const;
+
+    std::pmr::memory_resource* upstream_;
+    std::size_t block_size_;
+    std::size_t blocks_per_chunk_;
+    Block* chunks_ = nullptr; /**< Each chunk's first block links them */
+    Block* free_ = nullptr;
+    char* cursor_ = nullptr; /**< Blocks never yet allocated */
+    char* end_ = nullptr;
+    std::size_t used_ = 0;
+};
+
+} // namespace toolbox
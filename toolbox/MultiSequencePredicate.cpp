@@ -0,0 +1 @@
+#include <toolbox/MultiSequencePredicate.h>
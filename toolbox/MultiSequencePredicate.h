@@ -0,0 +1,412 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <span>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace toolbox
+{
+
+/** Matches a stream of values against many sequences at once
+ *
+ * The sequences are compiled into a single Aho-Corasick automaton over
+ * their distinct values, so each input costs one lookup of its value and
+ * one transition however many sequences there are, plus one step per
+ * sequence which it completes. Where the number of states times the number
+ * of distinct values is at most dense_limit, every transition is
+ * precomputed into a table; otherwise transitions are looked up sparsely
+ * and fall back along failure links.
+ *
+ * As with SequencePredicate, an empty sequence matches every input.
+ * Sequences may be added at any time, which rebuilds the automaton and
+ * resets the stream on the next input
+ *
+ * Example:
+ * sequences = {"/", "home"}, {"home", "/", "user"}
+ * input = "/", "home", "/", "user"
+ * matches = {}, {0}, {}, {1}
+ * */
+template <typename Value,
+          typename Hash = std::hash<Value>,
+          typename Equal = std::equal_to<Value>>
+class MultiSequencePredicate
+{
+public:
+    /** Type definitions */
+    using value_type = Value;
+    using argument_type = value_type;
+    using result_type = bool;
+    using size_type = std::size_t;
+    using pattern_type = std::size_t;
+
+    /** Default largest number of entries in a dense transition table */
+    static constexpr size_type default_dense_limit = 1 << 20;
+
+    /** Constructors */
+    explicit MultiSequencePredicate(
+        size_type dense_limit = default_dense_limit,
+        Hash hash = Hash(),
+        Equal equal = Equal());
+
+    /** Construct matching each of a range of sequences */
+    template <typename Sequences>
+    explicit MultiSequencePredicate(
+        const Sequences& sequences,
+        size_type dense_limit = default_dense_limit,
+        Hash hash = Hash(),
+        Equal equal = Equal());
+
+    /** Add the sequence [begin, end), returning its index */
+    template <typename Iterator>
+    pattern_type add(Iterator begin, Iterator end);
+
+    /** Add a sequence, returning its index */
+    template <typename Sequence>
+    pattern_type add(const Sequence& sequence);
+
+    /** Operators */
+
+    /** Advance by input, returning whether it completed any sequence */
+    result_type operator()(const argument_type& input);
+
+    /** Get the indices of the sequences completed by the last input */
+    std::span<const pattern_type> matches() const;
+
+    /** Get the length of the longest partial match ending at the last
+     * input, which is 0 if it advanced no sequence */
+    size_type depth() const;
+
+    /** Whether the last input continued a partial match of any sequence */
+    bool advanced() const;
+
+    /** Get the indices of the sequences which a partial match ending at the
+     * last input is a prefix of, including those it completed, in ascending
+     * order
+     *
+     * This walks the failure links of the current state, so costs more than
+     * advanced() or depth() and is best called only when they say so */
+    std::vector<pattern_type> advancing() const;
+
+    /** Forget the inputs so far */
+    void reset();
+
+    /** Get the number of sequences */
+    size_type size() const;
+
+    /** Whether the transitions are held in a dense table */
+    bool dense() const;
+
+private:
+    using state_type = std::uint32_t;
+    using symbol_type = std::uint32_t;
+
+    static constexpr state_type none = ~state_type(0);
+
+    struct State
+    {
+        state_type fail = 0;       /**< Longest proper suffix state */
+        state_type output = none;  /**< Nearest suffix with matches */
+        std::uint32_t depth = 0;   /**< Length of the prefix it matches */
+        std::uint32_t begin = 0;   /**< First of its own matches */
+        std::uint32_t end = 0;     /**< Past the last of its own matches */
+    };
+
+    /** Methods */
+    void compile();
+
+    symbol_type symbol(const value_type& value) const;
+
+    state_type child(state_type state, symbol_type symbol) const;
+
+    state_type next(state_type state, symbol_type symbol) const;
+
+    static std::uint64_t edge(state_type state, symbol_type symbol);
+
+    /** Data */
+    std::unordered_map<Value, symbol_type, Hash, Equal> symbols_;
+    std::unordered_map<std::uint64_t, state_type> edges_;
+    std::vector<State> states_;
+    std::vector<std::vector<pattern_type>> ends_; /**< Matches by state */
+    std::vector<std::vector<pattern_type>> through_; /**< Prefixed by state */
+    std::vector<pattern_type> outputs_;           /**< Flattened ends_ */
+    std::vector<state_type> table_;               /**< Dense transitions */
+    size_type dense_limit_;
+    size_type size_ = 0;
+    bool compiled_ = false;
+    state_type state_ = 0;
+    std::vector<pattern_type> matches_;
+};
+
+template <typename Sequences>
+auto makeMultiSequencePredicate(const Sequences& sequences);
+
+/********************************IMPLEMENTATION********************************/
+
+template <typename Value, typename Hash, typename Equal>
+MultiSequencePredicate<Value, Hash, Equal>::MultiSequencePredicate(
+    size_type dense_limit, Hash hash, Equal equal)
+    : symbols_(0, std::move(hash), std::move(equal)), states_(1), ends_(1),
+      through_(1), dense_limit_(dense_limit)
+{
+}
+
+template <typename Value, typename Hash, typename Equal>
+template <typename Sequences>
+MultiSequencePredicate<Value, Hash, Equal>::MultiSequencePredicate(
+    const Sequences& sequences, size_type dense_limit, Hash hash, Equal equal)
+    : MultiSequencePredicate(dense_limit, std::move(hash), std::move(equal))
+{
+    for (const auto& sequence : sequences)
+    {
+        add(sequence);
+    }
+}
+
+template <typename Value, typename Hash, typename Equal>
+std::uint64_t
+MultiSequencePredicate<Value, Hash, Equal>::edge(state_type state,
+                                                 symbol_type symbol)
+{
+    return std::uint64_t(state) << 32 | symbol;
+}
+
+template <typename Value, typename Hash, typename Equal>
+template <typename Iterator>
+typename MultiSequencePredicate<Value, Hash, Equal>::pattern_type
+MultiSequencePredicate<Value, Hash, Equal>::add(Iterator begin, Iterator end)
+{
+    auto state = state_type(0);
+    for (; begin != end; ++begin)
+    {
+        auto symbol = symbols_.try_emplace(*begin, symbols_.size())
+                          .first->second;
+        auto [it, inserted] = edges_.try_emplace(
+            edge(state, symbol), static_cast<state_type>(states_.size()));
+        if (inserted)
+        {
+            states_.emplace_back();
+            states_.back().depth = states_[state].depth + 1;
+            ends_.emplace_back();
+            through_.emplace_back();
+        }
+        state = it->second;
+        through_[state].push_back(size_);
+    }
+    ends_[state].push_back(size_);
+    compiled_ = false;
+    return size_++;
+}
+
+template <typename Value, typename Hash, typename Equal>
+template <typename Sequence>
+typename MultiSequencePredicate<Value, Hash, Equal>::pattern_type
+MultiSequencePredicate<Value, Hash, Equal>::add(const Sequence& sequence)
+{
+    return add(std::begin(sequence), std::end(sequence));
+}
+
+template <typename Value, typename Hash, typename Equal>
+typename MultiSequencePredicate<Value, Hash, Equal>::state_type
+MultiSequencePredicate<Value, Hash, Equal>::child(state_type state,
+                                                  symbol_type symbol) const
+{
+    auto it = edges_.find(edge(state, symbol));
+    return it == edges_.end() ? none : it->second;
+}
+
+template <typename Value, typename Hash, typename Equal>
+void MultiSequencePredicate<Value, Hash, Equal>::compile()
+{
+    /** Visit states breadth first, so that every state's failure link is
+     * known before those of the states below it */
+    auto order = std::vector<state_type>{0};
+    order.reserve(states_.size());
+    auto children = std::vector<std::vector<std::pair<symbol_type,
+                                                      state_type>>>(
+        states_.size());
+    for (const auto& [key, to] : edges_)
+    {
+        children[key >> 32].emplace_back(static_cast<symbol_type>(key), to);
+    }
+    for (size_type i = 0; i < order.size(); ++i)
+    {
+        auto state = order[i];
+        for (const auto& [symbol, to] : children[state])
+        {
+            auto fail = state_type(0);
+            if (state != 0)
+            {
+                fail = states_[state].fail;
+                while (fail != 0 && child(fail, symbol) == none)
+                {
+                    fail = states_[fail].fail;
+                }
+                auto next = child(fail, symbol);
+                fail = next == none ? 0 : next;
+            }
+            states_[to].fail = fail;
+            states_[to].output =
+                ends_[fail].empty() ? states_[fail].output : fail;
+            order.push_back(to);
+        }
+    }
+    outputs_.clear();
+    for (size_type state = 0; state < states_.size(); ++state)
+    {
+        states_[state].begin = static_cast<std::uint32_t>(outputs_.size());
+        outputs_.insert(outputs_.end(), ends_[state].begin(),
+                        ends_[state].end());
+        states_[state].end = static_cast<std::uint32_t>(outputs_.size());
+    }
+    /** One column per symbol, and a last for values in no sequence */
+    auto width = symbols_.size() + 1;
+    table_.clear();
+    if (states_.size() * width <= dense_limit_)
+    {
+        table_.assign(states_.size() * width, 0);
+        for (auto state : order)
+        {
+            auto fail = states_[state].fail;
+            for (symbol_type symbol = 0; symbol + 1 < width; ++symbol)
+            {
+                auto to = child(state, symbol);
+                table_[state * width + symbol] =
+                    to != none ? to
+                    : state == 0 ? 0
+                                 : table_[fail * width + symbol];
+            }
+        }
+    }
+    state_ = 0;
+    compiled_ = true;
+}
+
+template <typename Value, typename Hash, typename Equal>
+typename MultiSequencePredicate<Value, Hash, Equal>::symbol_type
+MultiSequencePredicate<Value, Hash, Equal>::symbol(
+    const value_type& value) const
+{
+    auto it = symbols_.find(value);
+    return it == symbols_.end() ? static_cast<symbol_type>(symbols_.size())
+                                : it->second;
+}
+
+template <typename Value, typename Hash, typename Equal>
+typename MultiSequencePredicate<Value, Hash, Equal>::state_type
+MultiSequencePredicate<Value, Hash, Equal>::next(state_type state,
+                                                 symbol_type symbol) const
+{
+    if (!table_.empty())
+    {
+        return table_[state * (symbols_.size() + 1) + symbol];
+    }
+    while (true)
+    {
+        auto to = child(state, symbol);
+        if (to != none)
+        {
+            return to;
+        }
+        if (state == 0)
+        {
+            return 0;
+        }
+        state = states_[state].fail;
+    }
+}
+
+template <typename Value, typename Hash, typename Equal>
+typename MultiSequencePredicate<Value, Hash, Equal>::result_type
+MultiSequencePredicate<Value, Hash, Equal>::operator()(
+    const argument_type& input)
+{
+    if (!compiled_)
+    {
+        compile();
+    }
+    state_ = next(state_, symbol(input));
+    matches_.clear();
+    auto state = ends_[state_].empty() ? states_[state_].output : state_;
+    while (state != none)
+    {
+        const auto& found = states_[state];
+        matches_.insert(matches_.end(), outputs_.begin() + found.begin,
+                        outputs_.begin() + found.end);
+        state = found.output;
+    }
+    return !matches_.empty();
+}
+
+template <typename Value, typename Hash, typename Equal>
+std::span<const typename MultiSequencePredicate<Value, Hash, Equal>::
+              pattern_type>
+MultiSequencePredicate<Value, Hash, Equal>::matches() const
+{
+    return matches_;
+}
+
+template <typename Value, typename Hash, typename Equal>
+typename MultiSequencePredicate<Value, Hash, Equal>::size_type
+MultiSequencePredicate<Value, Hash, Equal>::depth() const
+{
+    return states_[state_].depth;
+}
+
+template <typename Value, typename Hash, typename Equal>
+bool MultiSequencePredicate<Value, Hash, Equal>::advanced() const
+{
+    return depth() != 0;
+}
+
+template <typename Value, typename Hash, typename Equal>
+std::vector<typename MultiSequencePredicate<Value, Hash, Equal>::pattern_type>
+MultiSequencePredicate<Value, Hash, Equal>::advancing() const
+{
+    /** Every suffix of the input which is a prefix of some sequence is a
+     * state on the failure chain */
+    auto result = std::vector<pattern_type>();
+    for (auto state = state_; state != 0; state = states_[state].fail)
+    {
+        result.insert(result.end(), through_[state].begin(),
+                      through_[state].end());
+    }
+    std::sort(result.begin(), result.end());
+    result.erase(std::unique(result.begin(), result.end()), result.end());
+    return result;
+}
+
+template <typename Value, typename Hash, typename Equal>
+void MultiSequencePredicate<Value, Hash, Equal>::reset()
+{
+    state_ = 0;
+    matches_.clear();
+}
+
+template <typename Value, typename Hash, typename Equal>
+typename MultiSequencePredicate<Value, Hash, Equal>::size_type
+MultiSequencePredicate<Value, Hash, Equal>::size() const
+{
+    return size_;
+}
+
+template <typename Value, typename Hash, typename Equal>
+bool MultiSequencePredicate<Value, Hash, Equal>::dense() const
+{
+    return !table_.empty();
+}
+
+template <typename Sequences>
+auto makeMultiSequencePredicate(const Sequences& sequences)
+{
+    using Value = std::decay_t<decltype(*std::begin(*std::begin(sequences)))>;
+    return MultiSequencePredicate<Value>(sequences);
+}
+
+} // namespace toolbox
@@ -0,0 +1 @@
+#include <toolbox/Parallel.h>
@@ -0,0 +1,100 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <exception>
+#include <iterator>
+#include <thread>
+#include <vector>
+
+namespace toolbox
+{
+
+/** Default number of values processed by each thread in a parallel batch */
+constexpr std::size_t default_batch_size = 4096;
+
+/** Apply f to each value in [first, last), writing the results to out
+ *
+ * Once the input holds more than batch_size values it is split into
+ * contiguous batches which are processed on separate threads, each with its
+ * own copy of f. Results are written in input order. The first exception
+ * thrown by f is rethrown after every batch has finished. Batches for which
+ * no thread can be started are processed on the calling thread
+ */
+template <typename RandomIterator, typename OutputRandomIterator, typename F>
+OutputRandomIterator parallelTransform(RandomIterator first,
+                                       RandomIterator last,
+                                       OutputRandomIterator out,
+                                       F f,
+                                       std::size_t batch_size =
+                                           default_batch_size);
+
+/********************************IMPLEMENTATION********************************/
+
+template <typename RandomIterator, typename OutputRandomIterator, typename F>
+OutputRandomIterator parallelTransform(RandomIterator first,
+                                       RandomIterator last,
+                                       OutputRandomIterator out,
+                                       F f,
+                                       std::size_t batch_size)
+{
+    auto size = static_cast<std::size_t>(std::distance(first, last));
+    auto hardware = std::max(1u, std::thread::hardware_concurrency());
+    batch_size = std::max<std::size_t>(batch_size, 1);
+    auto batches =
+        std::min<std::size_t>(hardware, (size + batch_size - 1) / batch_size);
+    if (batches <= 1)
+    {
+        return std::transform(first, last, out, f);
+    }
+    auto step = (size + batches - 1) / batches;
+    auto errors = std::vector<std::exception_ptr>(batches);
+    auto threads = std::vector<std::thread>();
+    threads.reserve(batches - 1);
+    auto run = [&errors, first, out, f, step, size](std::size_t batch) {
+        try
+        {
+            auto begin = std::min(batch * step, size);
+            auto end = std::min(begin + step, size);
+            auto g = f;
+            std::transform(std::next(first, begin), std::next(first, end),
+                           std::next(out, begin), g);
+        }
+        catch (...)
+        {
+            errors[batch] = std::current_exception();
+        }
+    };
+    auto spawned = std::size_t(1);
+    try
+    {
+        for (; spawned < batches; ++spawned)
+        {
+            threads.emplace_back(run, spawned);
+        }
+    }
+    catch (...)
+    {
+        /** Threads already started must still be joined, so rather than
+         * unwinding past them finish the remaining batches here */
+    }
+    for (auto batch = spawned; batch < batches; ++batch)
+    {
+        run(batch);
+    }
+    run(0);
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
+    for (auto& error : errors)
+    {
+        if (error)
+        {
+            std::rethrow_exception(error);
+        }
+    }
+    return std::next(out, size);
+}
+
+} // namespace toolbox
@@ -0,0 +1 @@
+#include <toolbox/PolymorphicValue.h>
@@ -0,0 +1,357 @@
+#pragma once
+#include <cstddef>
+#include <new>
+#include <stdexcept>
+#include <toolbox/Dereference.h>
+#include <type_traits>
+#include <utility>
+
+namespace toolbox
+{
+
+/** Holds an object of any type derived from Base, by value
+ *
+ * Objects of up to Size bytes, aligned to at most Align, whose move
+ * constructor doesn't throw are constructed inside the PolymorphicValue
+ * itself, so that holding them needs no allocation; larger objects fall
+ * back to the heap. Copying, moving and destroying go through a table of
+ * functions shared by every value holding the same type, so a value is
+ * only its buffer and two pointers, which by default fill a cache line.
+ *
+ * Unlike a smart pointer, copies are deep and constness is too. Copying a
+ * value holding a type which can't be copied throws std::logic_error, and a
+ * moved from value is empty. Derived mustn't inherit Base virtually.
+ *
+ * A PolymorphicValue is dereferenced like a smart pointer, so it may be
+ * held by Value
+ *
+ * Example:
+ * PolymorphicValue<Shape> shape = Circle(1.0);
+ * shape->area() = 3.14...
+ * */
+template <typename Base,
+          std::size_t Size = 64 - 2 * sizeof(void*),
+          std::size_t Align = alignof(std::max_align_t)>
+class PolymorphicValue
+{
+public:
+    /** Type definitions */
+    using element_type = Base;
+
+    static constexpr std::size_t size = Size;
+    static constexpr std::size_t alignment = Align;
+
+    /** Whether a Derived is held without allocating */
+    template <typename Derived>
+    static constexpr bool fits_inline =
+        sizeof(Derived) <= Size && alignof(Derived) <= Align &&
+        std::is_nothrow_move_constructible_v<Derived>;
+
+    /** Constructors */
+    PolymorphicValue() noexcept = default;
+
+    template <typename Derived,
+              typename = std::enable_if_t<
+                  std::is_base_of_v<Base, std::decay_t<Derived>> &&
+                  !std::is_same_v<std::decay_t<Derived>, PolymorphicValue>>>
+    PolymorphicValue(Derived&& object);
+
+    template <typename Derived, typename... Args>
+    explicit PolymorphicValue(std::in_place_type_t<Derived>, Args&&... args);
+
+    PolymorphicValue(const PolymorphicValue& other);
+
+    PolymorphicValue(PolymorphicValue&& other) noexcept;
+
+    PolymorphicValue& operator=(const PolymorphicValue& other);
+
+    PolymorphicValue& operator=(PolymorphicValue&& other) noexcept;
+
+    ~PolymorphicValue();
+
+    /** Replace the object with a Derived constructed from args */
+    template <typename Derived, typename... Args>
+    Derived& emplace(Args&&... args);
+
+    /** Destroy the object, leaving the value empty */
+    void reset() noexcept;
+
+    /** Accessors */
+    Base* get() noexcept;
+    const Base* get() const noexcept;
+
+    Base& operator*() noexcept;
+    const Base& operator*() const noexcept;
+
+    Base* operator->() noexcept;
+    const Base* operator->() const noexcept;
+
+    explicit operator bool() const noexcept;
+
+    /** Whether the object is held in the value rather than on the heap */
+    bool inlined() const noexcept;
+
+private:
+    /** Operations on the type of the object held */
+    struct VTable
+    {
+        Base* (*copy)(const Base& object, void* buffer);
+        Base* (*move)(Base* object, void* buffer) noexcept;
+        void (*destroy)(Base* object) noexcept;
+        bool inlined;
+    };
+
+    template <typename Derived>
+    struct Model
+    {
+        static Base* copy(const Base& object, void* buffer);
+        static Base* move(Base* object, void* buffer) noexcept;
+        static void destroy(Base* object) noexcept;
+
+        static constexpr VTable vtable = {&copy, &move, &destroy,
+                                          fits_inline<Derived>};
+    };
+
+    template <typename Derived, typename... Args>
+    void construct(Args&&... args);
+
+    /** Data */
+    alignas(Align) unsigned char buffer_[Size];
+    const VTable* vtable_ = nullptr; /**< Null when empty */
+    Base* object_ = nullptr;         /**< In buffer_ or on the heap */
+};
+
+template <typename Base, std::size_t Size, std::size_t Align>
+struct enable_smart_pointer<PolymorphicValue<Base, Size, Align>>
+    : std::true_type
+{
+};
+
+template <typename Base, typename Derived, typename... Args>
+PolymorphicValue<Base> makePolymorphicValue(Args&&... args);
+
+/********************************IMPLEMENTATION********************************/
+
+template <typename Base, std::size_t Size, std::size_t Align>
+template <typename Derived>
+Base* PolymorphicValue<Base, Size, Align>::Model<Derived>::copy(
+    const Base& object, void* buffer)
+{
+    if constexpr (!std::is_copy_constructible_v<Derived>)
+    {
+        throw std::logic_error("PolymorphicValue holds an uncopyable type");
+    }
+    else if constexpr (fits_inline<Derived>)
+    {
+        return ::new (buffer) Derived(static_cast<const Derived&>(object));
+    }
+    else
+    {
+        return new Derived(static_cast<const Derived&>(object));
+    }
+}
+
+template <typename Base, std::size_t Size, std::size_t Align>
+template <typename Derived>
+Base* PolymorphicValue<Base, Size, Align>::Model<Derived>::move(
+    Base* object, void* buffer) noexcept
+{
+    if constexpr (fits_inline<Derived>)
+    {
+        auto& derived = static_cast<Derived&>(*object);
+        Base* result = ::new (buffer) Derived(std::move(derived));
+        derived.~Derived();
+        return result;
+    }
+    else
+    {
+        /** Heap objects change owner without moving */
+        static_cast<void>(buffer);
+        return object;
+    }
+}
+
+template <typename Base, std::size_t Size, std::size_t Align>
+template <typename Derived>
+void PolymorphicValue<Base, Size, Align>::Model<Derived>::destroy(
+    Base* object) noexcept
+{
+    if constexpr (fits_inline<Derived>)
+    {
+        static_cast<Derived*>(object)->~Derived();
+    }
+    else
+    {
+        delete static_cast<Derived*>(object);
+    }
+}
+
+template <typename Base, std::size_t Size, std::size_t Align>
+template <typename Derived, typename... Args>
+void PolymorphicValue<Base, Size, Align>::construct(Args&&... args)
+{
+    static_assert(std::is_base_of_v<Base, Derived>,
+                  "PolymorphicValue only holds types derived from Base");
+    if constexpr (fits_inline<Derived>)
+    {
+        object_ = ::new (static_cast<void*>(buffer_))
+            Derived(std::forward<Args>(args)...);
+    }
+    else
+    {
+        object_ = new Derived(std::forward<Args>(args)...);
+    }
+    vtable_ = &Model<Derived>::vtable;
+}
+
+template <typename Base, std::size_t Size, std::size_t Align>
+template <typename Derived, typename>
+PolymorphicValue<Base, Size, Align>::PolymorphicValue(Derived&& object)
+{
+    construct<std::decay_t<Derived>>(std::forward<Derived>(object));
+}
+
+template <typename Base, std::size_t Size, std::size_t Align>
+template <typename Derived, typename... Args>
+PolymorphicValue<Base, Size, Align>::PolymorphicValue(
+    std::in_place_type_t<Derived>, Args&&... args)
+{
+    construct<Derived>(std::forward<Args>(args)...);
+}
+
+template <typename Base, std::size_t Size, std::size_t Align>
+PolymorphicValue<Base, Size, Align>::PolymorphicValue(
+    const PolymorphicValue& other)
+{
+    if (other.vtable_)
+    {
+        object_ = other.vtable_->copy(*other.object_, buffer_);
+        vtable_ = other.vtable_;
+    }
+}
+
+template <typename Base, std::size_t Size, std::size_t Align>
+PolymorphicValue<Base, Size, Align>::PolymorphicValue(
+    PolymorphicValue&& other) noexcept
+{
+    if (other.vtable_)
+    {
+        object_ = other.vtable_->move(other.object_, buffer_);
+        vtable_ = other.vtable_;
+        other.vtable_ = nullptr;
+        other.object_ = nullptr;
+    }
+}
+
+template <typename Base, std::size_t Size, std::size_t Align>
+PolymorphicValue<Base, Size, Align>&
+PolymorphicValue<Base, Size, Align>::operator=(const PolymorphicValue& other)
+{
+    if (this != &other)
+    {
+        *this = PolymorphicValue(other);
+    }
+    return *this;
+}
+
+template <typename Base, std::size_t Size, std::size_t Align>
+PolymorphicValue<Base, Size, Align>&
+PolymorphicValue<Base, Size, Align>::operator=(
+    PolymorphicValue&& other) noexcept
+{
+    if (this != &other)
+    {
+        reset();
+        if (other.vtable_)
+        {
+            object_ = other.vtable_->move(other.object_, buffer_);
+            vtable_ = other.vtable_;
+            other.vtable_ = nullptr;
+            other.object_ = nullptr;
+        }
+    }
+    return *this;
+}
+
+template <typename Base, std::size_t Size, std::size_t Align>
+PolymorphicValue<Base, Size, Align>::~PolymorphicValue()
+{
+    reset();
+}
+
+template <typename Base, std::size_t Size, std::size_t Align>
+template <typename Derived, typename... Args>
+Derived& PolymorphicValue<Base, Size, Align>::emplace(Args&&... args)
+{
+    reset();
+    construct<Derived>(std::forward<Args>(args)...);
+    return static_cast<Derived&>(*object_);
+}
+
+template <typename Base, std::size_t Size, std::size_t Align>
+void PolymorphicValue<Base, Size, Align>::reset() noexcept
+{
+    if (vtable_)
+    {
+        vtable_->destroy(object_);
+        vtable_ = nullptr;
+        object_ = nullptr;
+    }
+}
+
+template <typename Base, std::size_t Size, std::size_t Align>
+Base* PolymorphicValue<Base, Size, Align>::get() noexcept
+{
+    return object_;
+}
+
+template <typename Base, std::size_t Size, std::size_t Align>
+const Base* PolymorphicValue<Base, Size, Align>::get() const noexcept
+{
+    return object_;
+}
+
+template <typename Base, std::size_t Size, std::size_t Align>
+Base& PolymorphicValue<Base, Size, Align>::operator*() noexcept
+{
+    return *object_;
+}
+
+template <typename Base, std::size_t Size, std::size_t Align>
+const Base& PolymorphicValue<Base, Size, Align>::operator*() const noexcept
+{
+    return *object_;
+}
+
+template <typename Base, std::size_t Size, std::size_t Align>
+Base* PolymorphicValue<Base, Size, Align>::operator->() noexcept
+{
+    return object_;
+}
+
+template <typename Base, std::size_t Size, std::size_t Align>
+const Base* PolymorphicValue<Base, Size, Align>::operator->() const noexcept
+{
+    return object_;
+}
+
+template <typename Base, std::size_t Size, std::size_t Align>
+PolymorphicValue<Base, Size, Align>::operator bool() const noexcept
+{
+    return vtable_ != nullptr;
+}
+
+template <typename Base, std::size_t Size, std::size_t Align>
+bool PolymorphicValue<Base, Size, Align>::inlined() const noexcept
+{
+    return vtable_ && vtable_->inlined;
+}
+
+template <typename Base, typename Derived, typename... Args>
+PolymorphicValue<Base> makePolymorphicValue(Args&&... args)
+{
+    return PolymorphicValue<Base>(std::in_place_type<Derived>,
+                                  std::forward<Args>(args)...);
+}
+
+} // namespace toolbox
@@ -0,0 +1,147 @@
+#include <cstring>
+#include <toolbox/RecordIterator.h>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace toolbox
+{
+
+const char* findDelimiter(const char* begin, const char* end, char delimiter)
+{
+#if defined(__SSE2__)
+    auto pattern = _mm_set1_epi8(delimiter);
+    for (; end - begin >= 16; begin += 16)
+    {
+        auto block =
+            _mm_loadu_si128(reinterpret_cast<const __m128i*>(begin));
+        auto mask = _mm_movemask_epi8(_mm_cmpeq_epi8(block, pattern));
+        if (mask != 0)
+        {
+            return begin + __builtin_ctz(static_cast<unsigned>(mask));
+        }
+    }
+#endif
+    auto result = static_cast<const char*>(
+        std::memchr(begin, delimiter, static_cast<std::size_t>(end - begin)));
+    return result ? result : end;
+}
+
+DelimitedRecordIterator::DelimitedRecordIterator(std::string_view buffer,
+                                                 char delimiter)
+    : end_(buffer.data() + buffer.size()), delimiter_(delimiter)
+{
+    scan(buffer.data());
+}
+
+DelimitedRecordIterator DelimitedRecordIterator::end(std::string_view buffer,
+                                                     char delimiter)
+{
+    return DelimitedRecordIterator(buffer.substr(buffer.size()), delimiter);
+}
+
+void DelimitedRecordIterator::scan(const char* begin)
+{
+    auto next = begin == end_ ? end_ : findDelimiter(begin, end_, delimiter_);
+    record_ = value_type(begin, static_cast<std::size_t>(next - begin));
+}
+
+DelimitedRecordIterator& DelimitedRecordIterator::operator++()
+{
+    auto next = record_.data() + record_.size();
+    scan(next == end_ ? end_ : next + 1);
+    return *this;
+}
+
+const DelimitedRecordIterator DelimitedRecordIterator::operator++(int dummy)
+{
+    (void)dummy;
+    auto tmp = *this;
+    ++*this;
+    return tmp;
+}
+
+DelimitedRecordIterator::reference DelimitedRecordIterator::operator*() const
+    noexcept
+{
+    return record_;
+}
+
+DelimitedRecordIterator::pointer DelimitedRecordIterator::operator->() const
+    noexcept
+{
+    return &record_;
+}
+
+bool DelimitedRecordIterator::operator==(
+    const DelimitedRecordIterator& rhs) const noexcept
+{
+    return record_.data() == rhs.record_.data();
+}
+
+bool DelimitedRecordIterator::operator!=(
+    const DelimitedRecordIterator& rhs) const noexcept
+{
+    return !(*this == rhs);
+}
+
+FixedRecordIterator::FixedRecordIterator(const std::byte* position,
+                                         std::size_t record_size) noexcept
+    : position_(position), record_size_(record_size)
+{
+}
+
+FixedRecordIterator& FixedRecordIterator::operator++() noexcept
+{
+    position_ += record_size_;
+    return *this;
+}
+
+const FixedRecordIterator FixedRecordIterator::operator++(int dummy) noexcept
+{
+    (void)dummy;
+    auto tmp = *this;
+    ++*this;
+    return tmp;
+}
+
+FixedRecordIterator::reference FixedRecordIterator::operator*() const noexcept
+{
+    return value_type(position_, record_size_);
+}
+
+bool FixedRecordIterator::operator==(const FixedRecordIterator& rhs) const
+    noexcept
+{
+    return position_ == rhs.position_;
+}
+
+bool FixedRecordIterator::operator!=(const FixedRecordIterator& rhs) const
+    noexcept
+{
+    return !(*this == rhs);
+}
+
+Range<DelimitedRecordIterator> makeLineRange(std::string_view buffer)
+{
+    return makeDelimitedRange(buffer, '\n');
+}
+
+Range<DelimitedRecordIterator> makeDelimitedRange(std::string_view buffer,
+                                                  char delimiter)
+{
+    return makeRange(DelimitedRecordIterator(buffer, delimiter),
+                     DelimitedRecordIterator::end(buffer, delimiter));
+}
+
+Range<FixedRecordIterator> makeFixedRecordRange(
+    std::span<const std::byte> buffer, std::size_t record_size)
+{
+    auto whole = record_size == 0 ? 0 : buffer.size() / record_size;
+    return makeRange(
+        FixedRecordIterator(buffer.data(), record_size),
+        FixedRecordIterator(buffer.data() + whole * record_size, record_size));
+}
+
+} // namespace toolbox
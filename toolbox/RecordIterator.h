@@ -0,0 +1,107 @@
+#pragma once
+
+#include <cstddef>
+#include <iterator>
+#include <span>
+#include <string_view>
+#include <toolbox/Iterator.h>
+
+namespace toolbox
+{
+
+/** Find the first occurrence of delimiter in [begin, end), or end if there is
+ * none. Scans 16 bytes at a time where SSE2 is available */
+const char* findDelimiter(const char* begin, const char* end, char delimiter);
+
+/** Iterates over the delimiter-separated records of a character buffer
+ *
+ * Each record is a string_view into the buffer, so no record is copied. As
+ * with std::getline, a trailing delimiter doesn't start an empty record
+ */
+class DelimitedRecordIterator
+{
+public:
+    using self_type = DelimitedRecordIterator;
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = std::string_view;
+    using difference_type = std::ptrdiff_t;
+    using reference = const value_type&;
+    using pointer = const value_type*;
+
+    DelimitedRecordIterator() noexcept = default;
+
+    /** Start at the beginning of buffer */
+    explicit DelimitedRecordIterator(std::string_view buffer,
+                                     char delimiter = '\n');
+
+    /** The end of buffer */
+    static DelimitedRecordIterator end(std::string_view buffer,
+                                       char delimiter = '\n');
+
+    self_type& operator++();
+
+    const self_type operator++(int dummy);
+
+    reference operator*() const noexcept;
+
+    pointer operator->() const noexcept;
+
+    bool operator==(const DelimitedRecordIterator& rhs) const noexcept;
+
+    bool operator!=(const DelimitedRecordIterator& rhs) const noexcept;
+
+private:
+    const char* end_ = nullptr;
+    char delimiter_ = '\n';
+    value_type record_;
+
+    void scan(const char* begin);
+};
+
+/** Iterates over consecutive fixed-size binary records of a byte buffer
+ *
+ * Each record is a span into the buffer. Trailing bytes which don't make up
+ * a whole record are not visited
+ */
+class FixedRecordIterator
+{
+public:
+    using self_type = FixedRecordIterator;
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = std::span<const std::byte>;
+    using difference_type = std::ptrdiff_t;
+    using reference = value_type;
+    using pointer = void;
+
+    FixedRecordIterator() noexcept = default;
+
+    FixedRecordIterator(const std::byte* position,
+                        std::size_t record_size) noexcept;
+
+    self_type& operator++() noexcept;
+
+    const self_type operator++(int dummy) noexcept;
+
+    reference operator*() const noexcept;
+
+    bool operator==(const FixedRecordIterator& rhs) const noexcept;
+
+    bool operator!=(const FixedRecordIterator& rhs) const noexcept;
+
+private:
+    const std::byte* position_ = nullptr;
+    std::size_t record_size_ = 0;
+};
+
+/** The lines of a buffer */
+Range<DelimitedRecordIterator> makeLineRange(std::string_view buffer);
+
+/** The delimiter-separated records of a buffer */
+Range<DelimitedRecordIterator> makeDelimitedRange(std::string_view buffer,
+                                                  char delimiter);
+
+/** The whole fixed-size records of a buffer */
+Range<FixedRecordIterator> makeFixedRecordRange(
+    std::span<const std::byte> buffer, std::size_t record_size);
+
+} // namespace toolbox
@@ -1,6 +1,11 @@
 #pragma once
+#include <cstddef>
 #include <functional>
+#include <span>
+#include <toolbox/SequenceScan.h>
+#include <type_traits>
 #include <utility>
+#include <vector>
 
 namespace toolbox
 {
@@ -99,4 +104,234 @@ SequencePredicate<Iterator, Compare>::operator()(
     return result;
 }
 
+/** Finds every occurrence of a sequence in a stream of values, one value
+ * at a time
+ *
+ * A failure function is precomputed from the sequence, as in the
+ * Knuth-Morris-Pratt algorithm, so that on a mismatch the longest partial
+ * match which is still possible carries on rather than starting over.
+ * Matching is linear in the length of the stream, and overlapping
+ * occurrences are all found. As with SequencePredicate, an empty sequence
+ * matches every input
+ *
+ * Example:
+ * sequence = "a", "a"
+ * input = "a", "a", "a"
+ * result = false, true, true
+ * */
+template <typename Iterator,
+          typename Compare = std::less<decltype(*Iterator())>>
+class StreamingSequencePredicate
+{
+public:
+    /** Type definitions */
+    using value_type = std::remove_cvref_t<decltype(*Iterator())>;
+    using argument_type = value_type;
+    using result_type = bool;
+    using size_type = std::size_t;
+
+    /** Returned by match_position() before any match */
+    static constexpr size_type npos = ~size_type(0);
+
+    /** Constructors */
+    explicit StreamingSequencePredicate(Iterator begin = Iterator(),
+                                        Iterator end = Iterator(),
+                                        Compare compare = Compare());
+
+    /** Operators */
+
+    /** Advance by input, returning whether it completed an occurrence */
+    result_type operator()(const argument_type& input);
+
+    /** Whether the last input completed an occurrence */
+    bool matched() const;
+
+    /** Get the number of inputs since construction or reset() */
+    size_type position() const;
+
+    /** Get the position of the first input of the latest occurrence, or
+     * npos if there has been none */
+    size_type match_position() const;
+
+    /** Get the length of the partial match ending at the last input */
+    size_type progress() const;
+
+    /** Forget the inputs so far */
+    void reset();
+
+    /** Find every occurrence in input, as a fresh predicate fed each value
+     * would report them by match_position(), leaving this one as it is
+     *
+     * Where the values are integers compared by std::less, non-empty
+     * sequences are found by scanSequence() */
+    std::vector<size_type> scan(std::span<const value_type> input) const;
+
+private:
+    /** Methods */
+    bool equal(const value_type& lhs, const value_type& rhs) const;
+
+    /** Data */
+    std::vector<Iterator> sequence_; /**< Each value of the sequence */
+    std::vector<size_type> fail_;    /**< Border of each prefix */
+    Compare compare_;                /**< Compare to match values */
+    size_type progress_ = 0;         /**< Length of the partial match */
+    size_type position_ = 0;         /**< Inputs seen */
+    size_type match_position_ = npos;
+    bool matched_ = false;
+};
+
+template <typename Iterator, typename Compare>
+StreamingSequencePredicate<Iterator, Compare>
+makeStreamingSequencePredicate(Iterator begin, Iterator end, Compare compare);
+
+namespace detail
+{
+
+/** Whether Compare orders values of type T as their operator< does */
+template <typename Compare, typename T>
+inline constexpr bool is_default_less_v =
+    std::is_same_v<Compare, std::less<>> ||
+    std::is_same_v<Compare, std::less<T>> ||
+    std::is_same_v<Compare, std::less<const T&>> ||
+    std::is_same_v<Compare, std::less<T&>>;
+
+} // namespace detail
+
+template <typename Iterator, typename Compare>
+StreamingSequencePredicate<Iterator, Compare>::StreamingSequencePredicate(
+    Iterator begin, Iterator end, Compare compare)
+    : compare_(std::move(compare))
+{
+    for (; begin != end; ++begin)
+    {
+        sequence_.push_back(begin);
+    }
+    /** fail_[i] is the length of the longest proper prefix of the first
+     * i + 1 values which is also a suffix of them */
+    fail_.assign(sequence_.size(), 0);
+    for (size_type i = 1, k = 0; i < sequence_.size(); ++i)
+    {
+        while (k > 0 && !equal(*sequence_[i], *sequence_[k]))
+        {
+            k = fail_[k - 1];
+        }
+        if (equal(*sequence_[i], *sequence_[k]))
+        {
+            ++k;
+        }
+        fail_[i] = k;
+    }
+}
+
+template <typename Iterator, typename Compare>
+StreamingSequencePredicate<Iterator, Compare>
+makeStreamingSequencePredicate(Iterator begin, Iterator end, Compare compare)
+{
+    return StreamingSequencePredicate<Iterator, Compare>(
+        std::move(begin), std::move(end), std::move(compare));
+}
+
+template <typename Iterator, typename Compare>
+bool StreamingSequencePredicate<Iterator, Compare>::equal(
+    const value_type& lhs, const value_type& rhs) const
+{
+    return !compare_(lhs, rhs) && !compare_(rhs, lhs);
+}
+
+template <typename Iterator, typename Compare>
+typename StreamingSequencePredicate<Iterator, Compare>::result_type
+StreamingSequencePredicate<Iterator, Compare>::operator()(
+    const argument_type& input)
+{
+    ++position_;
+    auto size = sequence_.size();
+    if (progress_ == size && size != 0)
+    {
+        progress_ = fail_[size - 1];
+    }
+    while (progress_ > 0 && !equal(input, *sequence_[progress_]))
+    {
+        progress_ = fail_[progress_ - 1];
+    }
+    if (size != 0 && equal(input, *sequence_[progress_]))
+    {
+        ++progress_;
+    }
+    matched_ = progress_ == size;
+    if (matched_)
+    {
+        match_position_ = position_ - size;
+    }
+    return matched_;
+}
+
+template <typename Iterator, typename Compare>
+bool StreamingSequencePredicate<Iterator, Compare>::matched() const
+{
+    return matched_;
+}
+
+template <typename Iterator, typename Compare>
+typename StreamingSequencePredicate<Iterator, Compare>::size_type
+StreamingSequencePredicate<Iterator, Compare>::position() const
+{
+    return position_;
+}
+
+template <typename Iterator, typename Compare>
+typename StreamingSequencePredicate<Iterator, Compare>::size_type
+StreamingSequencePredicate<Iterator, Compare>::match_position() const
+{
+    return match_position_;
+}
+
+template <typename Iterator, typename Compare>
+typename StreamingSequencePredicate<Iterator, Compare>::size_type
+StreamingSequencePredicate<Iterator, Compare>::progress() const
+{
+    return progress_;
+}
+
+template <typename Iterator, typename Compare>
+void StreamingSequencePredicate<Iterator, Compare>::reset()
+{
+    progress_ = 0;
+    position_ = 0;
+    match_position_ = npos;
+    matched_ = false;
+}
+
+template <typename Iterator, typename Compare>
+std::vector<typename StreamingSequencePredicate<Iterator, Compare>::size_type>
+StreamingSequencePredicate<Iterator, Compare>::scan(
+    std::span<const value_type> input) const
+{
+    auto result = std::vector<size_type>();
+    if constexpr (detail::is_scannable_v<value_type> &&
+                  detail::is_default_less_v<Compare, value_type>)
+    {
+        if (!sequence_.empty())
+        {
+            auto values = std::vector<value_type>();
+            values.reserve(sequence_.size());
+            for (const auto& it : sequence_)
+            {
+                values.push_back(*it);
+            }
+            scanSequence(input, std::span<const value_type>(values), result);
+            return result;
+        }
+    }
+    auto predicate = *this;
+    predicate.reset();
+    for (const auto& value : input)
+    {
+        if (predicate(value))
+        {
+            result.push_back(predicate.match_position());
+        }
+    }
+    return result;
+}
+
 } // namespace toolbox
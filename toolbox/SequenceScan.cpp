@@ -0,0 +1,254 @@
+#include <algorithm>
+#include <bit>
+#include <cstring>
+#include <toolbox/SequenceScan.h>
+#include <toolbox/Simd.h>
+
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+#define TOOLBOX_X86_SIMD 1
+#include <immintrin.h>
+#endif
+
+namespace toolbox
+{
+
+namespace
+{
+
+/** Append the positions of the occurrences among candidates, a byte mask of
+ * the lanes from offset onwards whose first and last values both match */
+template <typename T>
+void verify(const T* input,
+            std::size_t offset,
+            std::uint32_t candidates,
+            const T* sequence,
+            std::size_t length,
+            std::vector<std::size_t>& positions)
+{
+    /** Keep one bit per lane of T */
+    candidates &= sizeof(T) == 1   ? 0xffffffffu
+                  : sizeof(T) == 2 ? 0x55555555u
+                                   : 0x11111111u;
+    while (candidates != 0)
+    {
+        auto position = offset + static_cast<std::size_t>(
+                                     std::countr_zero(candidates)) /
+                                     sizeof(T);
+        if (length <= 2 || std::memcmp(input + position + 1, sequence + 1,
+                                       (length - 2) * sizeof(T)) == 0)
+        {
+            positions.push_back(position);
+        }
+        candidates &= candidates - 1;
+    }
+}
+
+#if defined(TOOLBOX_X86_SIMD)
+
+/** Vectorised kernels test whole blocks of start positions from start and
+ * return the first which they didn't test, leaving the tail to the scalar
+ * code */
+
+template <typename T>
+__attribute__((target("ssse3"))) __m128i splat128(T value)
+{
+    if constexpr (sizeof(T) == 1)
+    {
+        return _mm_set1_epi8(static_cast<char>(value));
+    }
+    else if constexpr (sizeof(T) == 2)
+    {
+        return _mm_set1_epi16(static_cast<short>(value));
+    }
+    else
+    {
+        return _mm_set1_epi32(static_cast<int>(value));
+    }
+}
+
+template <typename T>
+__attribute__((target("ssse3"))) __m128i equal128(const T* input,
+                                                  __m128i value)
+{
+    auto block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(input));
+    if constexpr (sizeof(T) == 1)
+    {
+        return _mm_cmpeq_epi8(block, value);
+    }
+    else if constexpr (sizeof(T) == 2)
+    {
+        return _mm_cmpeq_epi16(block, value);
+    }
+    else
+    {
+        return _mm_cmpeq_epi32(block, value);
+    }
+}
+
+template <typename T>
+__attribute__((target("ssse3"))) std::size_t
+scanSsse3(const T* input,
+          std::size_t size,
+          std::size_t start,
+          const T* sequence,
+          std::size_t length,
+          std::vector<std::size_t>& positions)
+{
+    constexpr auto lanes = 16 / sizeof(T);
+    auto first = splat128(sequence[0]);
+    auto last = splat128(sequence[length - 1]);
+    auto i = start;
+    for (; i + length - 1 + lanes <= size; i += lanes)
+    {
+        auto both = _mm_and_si128(equal128(input + i, first),
+                                  equal128(input + i + length - 1, last));
+        auto candidates = static_cast<std::uint32_t>(_mm_movemask_epi8(both));
+        if (candidates != 0)
+        {
+            verify(input, i, candidates, sequence, length, positions);
+        }
+    }
+    return i;
+}
+
+template <typename T>
+__attribute__((target("avx2"))) __m256i splat256(T value)
+{
+    if constexpr (sizeof(T) == 1)
+    {
+        return _mm256_set1_epi8(static_cast<char>(value));
+    }
+    else if constexpr (sizeof(T) == 2)
+    {
+        return _mm256_set1_epi16(static_cast<short>(value));
+    }
+    else
+    {
+        return _mm256_set1_epi32(static_cast<int>(value));
+    }
+}
+
+template <typename T>
+__attribute__((target("avx2"))) __m256i equal256(const T* input,
+                                                 __m256i value)
+{
+    auto block =
+        _mm256_loadu_si256(reinterpret_cast<const __m256i*>(input));
+    if constexpr (sizeof(T) == 1)
+    {
+        return _mm256_cmpeq_epi8(block, value);
+    }
+    else if constexpr (sizeof(T) == 2)
+    {
+        return _mm256_cmpeq_epi16(block, value);
+    }
+    else
+    {
+        return _mm256_cmpeq_epi32(block, value);
+    }
+}
+
+template <typename T>
+__attribute__((target("avx2"))) std::size_t
+scanAvx2(const T* input,
+         std::size_t size,
+         std::size_t start,
+         const T* sequence,
+         std::size_t length,
+         std::vector<std::size_t>& positions)
+{
+    constexpr auto lanes = 32 / sizeof(T);
+    auto first = splat256(sequence[0]);
+    auto last = splat256(sequence[length - 1]);
+    auto i = start;
+    for (; i + length - 1 + lanes <= size; i += lanes)
+    {
+        auto both = _mm256_and_si256(equal256(input + i, first),
+                                     equal256(input + i + length - 1, last));
+        auto candidates =
+            static_cast<std::uint32_t>(_mm256_movemask_epi8(both));
+        if (candidates != 0)
+        {
+            verify(input, i, candidates, sequence, length, positions);
+        }
+    }
+    return i;
+}
+
+#endif
+
+template <typename T>
+void scan(std::span<const T> input,
+          std::span<const T> sequence,
+          std::vector<std::size_t>& positions)
+{
+    auto size = input.size();
+    auto length = sequence.size();
+    if (length == 0)
+    {
+        for (std::size_t i = 0; i <= size; ++i)
+        {
+            positions.push_back(i);
+        }
+        return;
+    }
+    if (length > size)
+    {
+        return;
+    }
+    auto data = input.data();
+    auto values = sequence.data();
+    std::size_t i = 0;
+#if defined(TOOLBOX_X86_SIMD)
+    auto level = simdLevel();
+    if (level >= SimdLevel::avx2)
+    {
+        i = scanAvx2(data, size, i, values, length, positions);
+    }
+    if (level >= SimdLevel::ssse3)
+    {
+        i = scanSsse3(data, size, i, values, length, positions);
+    }
+#endif
+    auto end = data + (size - length + 1);
+    for (auto it = std::find(data + i, end, values[0]); it != end;
+         it = std::find(it + 1, end, values[0]))
+    {
+        if (std::memcmp(it + 1, values + 1, (length - 1) * sizeof(T)) == 0)
+        {
+            positions.push_back(static_cast<std::size_t>(it - data));
+        }
+    }
+}
+
+} // namespace
+
+void scanSequence(std::span<const std::uint8_t> input,
+                  std::span<const std::uint8_t> sequence,
+                  std::vector<std::size_t>& positions)
+{
+    scan(input, sequence, positions);
+}
+
+void scanSequence(std::span<const std::uint16_t> input,
+                  std::span<const std::uint16_t> sequence,
+                  std::vector<std::size_t>& positions)
+{
+    scan(input, sequence, positions);
+}
+
+void scanSequence(std::span<const std::uint32_t> input,
+                  std::span<const std::uint32_t> sequence,
+                  std::vector<std::size_t>& positions)
+{
+    scan(input, sequence, positions);
+}
+
+std::vector<std::size_t> scanSequence(std::string_view input,
+                                      std::string_view sequence)
+{
+    return scanSequence(std::span<const char>(input),
+                        std::span<const char>(sequence));
+}
+
+} // namespace toolbox
@@ -0,0 +1,98 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+namespace toolbox
+{
+
+/** Finds every position in a contiguous buffer at which sequence occurs
+ *
+ * Rather than stepping a predicate through the input one value at a time,
+ * whole blocks of input are compared against the first and last values of
+ * the sequence at once, and only positions where both agree are compared in
+ * full, as in memmem. Values are compared bitwise. Blocks are 32 bytes where
+ * the CPU has AVX2 and 16 bytes where it has SSSE3, chosen by simdLevel().
+ *
+ * Positions are appended to positions in increasing order, and overlapping
+ * occurrences are all found. An empty sequence occurs at every position from
+ * 0 to input.size()
+ *
+ * Example:
+ * input = "abcabca"
+ * sequence = "bca"
+ * positions = 1, 4
+ * */
+void scanSequence(std::span<const std::uint8_t> input,
+                  std::span<const std::uint8_t> sequence,
+                  std::vector<std::size_t>& positions);
+
+void scanSequence(std::span<const std::uint16_t> input,
+                  std::span<const std::uint16_t> sequence,
+                  std::vector<std::size_t>& positions);
+
+void scanSequence(std::span<const std::uint32_t> input,
+                  std::span<const std::uint32_t> sequence,
+                  std::vector<std::size_t>& positions);
+
+std::vector<std::size_t> scanSequence(std::string_view input,
+                                      std::string_view sequence);
+
+namespace detail
+{
+
+/** Integers which scanSequence() may view as unsigned integers of 1, 2 or
+ * 4 bytes */
+template <typename T>
+inline constexpr bool is_scannable_v =
+    std::is_integral_v<T> && !std::is_same_v<std::remove_cv_t<T>, bool> &&
+    (sizeof(T) == 1 || sizeof(T) == 2 || sizeof(T) == 4) &&
+    (sizeof(T) == 1 ||
+     std::is_same_v<std::remove_cv_t<T>, std::make_signed_t<T>> ||
+     std::is_same_v<std::remove_cv_t<T>, std::make_unsigned_t<T>>);
+
+} // namespace detail
+
+/** Scan any scannable integer type */
+template <typename T>
+void scanSequence(std::span<const T> input,
+                  std::span<const T> sequence,
+                  std::vector<std::size_t>& positions);
+
+template <typename T>
+std::vector<std::size_t> scanSequence(std::span<const T> input,
+                                      std::span<const T> sequence);
+
+/********************************IMPLEMENTATION********************************/
+
+template <typename T>
+void scanSequence(std::span<const T> input,
+                  std::span<const T> sequence,
+                  std::vector<std::size_t>& positions)
+{
+    static_assert(detail::is_scannable_v<T>,
+                  "Only integers of 1, 2 or 4 bytes can be scanned");
+    using Unsigned = std::make_unsigned_t<std::remove_cv_t<T>>;
+    scanSequence(
+        std::span<const Unsigned>(
+            reinterpret_cast<const Unsigned*>(input.data()), input.size()),
+        std::span<const Unsigned>(
+            reinterpret_cast<const Unsigned*>(sequence.data()),
+            sequence.size()),
+        positions);
+}
+
+template <typename T>
+std::vector<std::size_t> scanSequence(std::span<const T> input,
+                                      std::span<const T> sequence)
+{
+    auto result = std::vector<std::size_t>();
+    scanSequence(input, sequence, result);
+    return result;
+}
+
+} // namespace toolbox
@@ -0,0 +1,16 @@
+#include <algorithm>
+#include <thread>
+#include <toolbox/Shards.h>
+
+namespace toolbox
+{
+namespace detail
+{
+
+std::size_t defaultShardCount()
+{
+    return 4 * std::max(1u, std::thread::hardware_concurrency());
+}
+
+} // namespace detail
+} // namespace toolbox
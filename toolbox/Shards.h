@@ -0,0 +1,89 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+namespace toolbox
+{
+namespace detail
+{
+
+/** Get the default number of shards of a concurrent table, a few per
+ * hardware thread */
+std::size_t defaultShardCount();
+
+/** The shards of a concurrent table, each typically a lock and the part of
+ * the table which it guards, chosen by hash
+ *
+ * Each shard is padded to a cache line so that locking one doesn't
+ * invalidate its neighbours. Shards guard themselves, so are mutable
+ * through a const Shards
+ * */
+template <typename Shard>
+class Shards
+{
+public:
+    using size_type = std::size_t;
+
+    /** Make count shards, or one if count is 0 */
+    explicit Shards(size_type count);
+
+    size_type size() const;
+
+    Shard& operator[](size_type index) const;
+
+    /** Select the index of the shard which holds hash */
+    size_type route(std::size_t hash) const;
+
+    /** Get the shard which holds hash */
+    Shard& shard(std::size_t hash) const;
+
+private:
+    struct alignas(64) Padded
+    {
+        Shard shard;
+    };
+
+    size_type count_;
+    std::unique_ptr<Padded[]> shards_;
+};
+
+/********************************IMPLEMENTATION********************************/
+
+template <typename Shard>
+Shards<Shard>::Shards(size_type count)
+    : count_(count > 0 ? count : 1), shards_(new Padded[count_])
+{
+}
+
+template <typename Shard>
+typename Shards<Shard>::size_type Shards<Shard>::size() const
+{
+    return count_;
+}
+
+template <typename Shard>
+Shard& Shards<Shard>::operator[](size_type index) const
+{
+    return shards_[index].shard;
+}
+
+template <typename Shard>
+typename Shards<Shard>::size_type Shards<Shard>::route(std::size_t hash) const
+{
+    /** Unordered shards pick buckets from the low bits of the same hash, so
+     * mix in the high bits to keep shard and bucket choice independent */
+    auto mixed = (static_cast<std::uint64_t>(hash) * 0x9E3779B97F4A7C15ull) >>
+                 32;
+    return static_cast<size_type>(mixed % count_);
+}
+
+template <typename Shard>
+Shard& Shards<Shard>::shard(std::size_t hash) const
+{
+    return (*this)[route(hash)];
+}
+
+} // namespace detail
+} // namespace toolbox
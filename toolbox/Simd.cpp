@@ -0,0 +1,51 @@
+#include <algorithm>
+#include <atomic>
+#include <toolbox/Simd.h>
+
+namespace toolbox
+{
+
+namespace
+{
+
+std::atomic<SimdLevel>& activeLevel()
+{
+    static std::atomic<SimdLevel> level(detectSimdLevel());
+    return level;
+}
+
+} // namespace
+
+SimdLevel detectSimdLevel()
+{
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2"))
+    {
+        return SimdLevel::avx2;
+    }
+    if (__builtin_cpu_supports("sse4.2"))
+    {
+        return SimdLevel::sse42;
+    }
+    if (__builtin_cpu_supports("ssse3"))
+    {
+        return SimdLevel::ssse3;
+    }
+#endif
+    return SimdLevel::scalar;
+}
+
+SimdLevel simdLevel()
+{
+    return activeLevel().load(std::memory_order_relaxed);
+}
+
+SimdLevel simdLevel(SimdLevel level)
+{
+    level = std::min(level, detectSimdLevel());
+    activeLevel().store(level, std::memory_order_relaxed);
+    return level;
+}
+
+} // namespace toolbox
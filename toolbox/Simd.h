@@ -0,0 +1,29 @@
+#pragma once
+
+namespace toolbox
+{
+
+/** Instruction set extensions used by toolbox's vectorised routines, in
+ * increasing order of capability. Each level implies those below it */
+enum class SimdLevel
+{
+    scalar,
+    ssse3,
+    sse42,
+    avx2
+};
+
+/** Get the best level which the CPU supports */
+SimdLevel detectSimdLevel();
+
+/** Get the level which vectorised routines dispatch on
+ *
+ * Defaults to detectSimdLevel() */
+SimdLevel simdLevel();
+
+/** Restrict vectorised routines to at most level, e.g. to compare against
+ * the scalar fallback. Returns the level now in effect, which is never above
+ * detectSimdLevel() */
+SimdLevel simdLevel(SimdLevel level);
+
+} // namespace toolbox
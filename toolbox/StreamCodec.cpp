@@ -0,0 +1 @@
+#include <toolbox/StreamCodec.h>
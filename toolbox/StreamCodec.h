@@ -0,0 +1,405 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <span>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+
+namespace toolbox
+{
+
+/** Streaming encoders and decoders
+ *
+ * A stream transforms a message which arrives in pieces. Each piece is
+ * passed to update(input, output), which appends whatever output it can
+ * already produce to output. finish(output) appends the remainder and
+ * readies the stream for the next message. estimate(n) bounds the output
+ * which n further bytes of input produce, so that callers can reserve.
+ *
+ * Output goes into a caller-supplied std::string, which may be a
+ * PooledBuffer. Draining and clearing it between pieces encodes an
+ * arbitrarily large message in bounded memory, and since clearing keeps its
+ * capacity, steady-state encoding doesn't allocate.
+ *
+ * Existing stateless functors are adapted with:
+ * - ChunkStream, for functors where encoding consecutive blocks of a fixed
+ *   size separately and concatenating the results is the same as encoding
+ *   the whole, such as hex or base64
+ * - MessageStream, for any functor: input is accumulated into a reused
+ *   buffer and encoded on finish()
+ *
+ * A functor may offer, in which case it is preferred:
+ * - operator()(input, output), appending the encoding of input to output
+ *   instead of returning a new string
+ * - max_size(n), bounding the size of the encoding of n bytes
+ * - a static block_size, declaring it suitable for ChunkStream, in which
+ *   case makeStream chooses ChunkStream over MessageStream
+ */
+
+namespace detail
+{
+
+/** An appending functor has operator()(std::string_view, std::string&) */
+template <typename Functor, typename = void>
+struct can_append_into : std::false_type
+{
+};
+
+template <typename Functor>
+struct can_append_into<Functor,
+                       std::void_t<decltype(std::declval<Functor&>()(
+                           std::declval<std::string_view>(),
+                           std::declval<std::string&>()))>> : std::true_type
+{
+};
+
+template <typename Functor, typename = void>
+struct has_max_size : std::false_type
+{
+};
+
+template <typename Functor>
+struct has_max_size<Functor,
+                    std::void_t<decltype(std::declval<const Functor&>()
+                                             .max_size(std::size_t()))>>
+    : std::true_type
+{
+};
+
+template <typename Functor, typename = void>
+struct has_block_size : std::false_type
+{
+};
+
+template <typename Functor>
+struct has_block_size<Functor, std::void_t<decltype(Functor::block_size)>>
+    : std::true_type
+{
+};
+
+/** A stream has update(input, output) and finish(output) */
+template <typename T, typename = void>
+struct is_stream : std::false_type
+{
+};
+
+template <typename T>
+struct is_stream<T,
+                 std::void_t<decltype(std::declval<T&>().update(
+                                 std::declval<std::span<const char>>(),
+                                 std::declval<std::string&>())),
+                             decltype(std::declval<T&>().finish(
+                                 std::declval<std::string&>()))>>
+    : std::true_type
+{
+};
+
+/** A stream which has reset() can discard a partial message */
+template <typename T, typename = void>
+struct has_reset : std::false_type
+{
+};
+
+template <typename T>
+struct has_reset<T, std::void_t<decltype(std::declval<T&>().reset())>>
+    : std::true_type
+{
+};
+
+/** Append the encoding of input to output by whichever means Functor
+ * offers */
+template <typename Functor>
+void appendEncoded(Functor& functor,
+                   std::string_view input,
+                   std::string& output)
+{
+    if constexpr (can_append_into<Functor>::value)
+    {
+        functor(input, output);
+    }
+    else
+    {
+        output += functor(input);
+    }
+}
+
+/** Bound the size of the encoding of size bytes, or guess that encoding
+ * preserves size where Functor can't say */
+template <typename Functor>
+std::size_t maxEncodedSize(const Functor& functor, std::size_t size)
+{
+    if constexpr (has_max_size<Functor>::value)
+    {
+        return functor.max_size(size);
+    }
+    else
+    {
+        (void)functor;
+        return size;
+    }
+}
+
+} // namespace detail
+
+/** Streams a functor over blocks of block_size bytes
+ *
+ * Input is passed to the functor in runs of whole blocks, straight from the
+ * caller's span where possible. A trailing partial block is held back until
+ * more input arrives or finish() passes it on by itself */
+template <typename Functor>
+class ChunkStream
+{
+public:
+    using size_type = std::size_t;
+
+    explicit ChunkStream(Functor functor = Functor(),
+                         size_type block_size = 1);
+
+    void update(std::span<const char> input, std::string& output);
+
+    void finish(std::string& output);
+
+    size_type estimate(size_type input_size) const;
+
+    /** Discard the bytes held back, such as after the functor threw */
+    void reset();
+
+    /** Get the number of bytes held back awaiting a complete block */
+    size_type pending() const;
+
+    Functor& functor();
+
+private:
+    Functor functor_;
+    size_type block_size_;
+    std::string pending_;
+};
+
+/** Streams a functor which must see a whole message at once
+ *
+ * Input is accumulated into a buffer which keeps its capacity between
+ * messages and encoded by finish() */
+template <typename Functor>
+class MessageStream
+{
+public:
+    using size_type = std::size_t;
+
+    explicit MessageStream(Functor functor = Functor());
+
+    void update(std::span<const char> input, std::string& output);
+
+    void finish(std::string& output);
+
+    size_type estimate(size_type input_size) const;
+
+    /** Discard the current message, such as after the functor threw */
+    void reset();
+
+    /** Get the number of bytes accumulated for the current message */
+    size_type pending() const;
+
+    Functor& functor();
+
+private:
+    Functor functor_;
+    std::string buffer_;
+};
+
+/** Stream a functor over blocks of block_size bytes */
+template <typename Functor>
+ChunkStream<Functor> makeChunkStream(Functor functor,
+                                     std::size_t block_size = 1);
+
+/** Stream a functor over whole messages */
+template <typename Functor>
+MessageStream<Functor> makeMessageStream(Functor functor);
+
+/** Stream a functor by the most incremental means it supports: a stream is
+ * returned as is, a functor with a block_size is streamed in blocks and any
+ * other functor over whole messages */
+template <typename Functor>
+auto makeStream(Functor functor);
+
+/** Run a complete message through a stream, reserving output up front
+ *
+ * If the stream throws, output is restored and the stream reset where it
+ * has reset(), so that one bad message doesn't affect the next */
+template <typename Stream>
+void process(Stream& stream,
+             std::span<const char> input,
+             std::string& output);
+
+/********************************IMPLEMENTATION********************************/
+
+template <typename Functor>
+ChunkStream<Functor>::ChunkStream(Functor functor, size_type block_size)
+    : functor_(std::move(functor)),
+      block_size_(block_size == 0 ? 1 : block_size)
+{
+    pending_.reserve(block_size_);
+}
+
+template <typename Functor>
+void ChunkStream<Functor>::update(std::span<const char> input,
+                                  std::string& output)
+{
+    auto data = std::string_view(input.data(), input.size());
+    if (!pending_.empty())
+    {
+        auto take = std::min(block_size_ - pending_.size(), data.size());
+        pending_.append(data.substr(0, take));
+        data.remove_prefix(take);
+        if (pending_.size() < block_size_)
+        {
+            return;
+        }
+        detail::appendEncoded(functor_, pending_, output);
+        pending_.clear();
+    }
+    auto whole = data.size() - data.size() % block_size_;
+    if (whole > 0)
+    {
+        detail::appendEncoded(functor_, data.substr(0, whole), output);
+    }
+    pending_.append(data.substr(whole));
+}
+
+template <typename Functor>
+void ChunkStream<Functor>::finish(std::string& output)
+{
+    if (!pending_.empty())
+    {
+        detail::appendEncoded(functor_, pending_, output);
+        pending_.clear();
+    }
+}
+
+template <typename Functor>
+typename ChunkStream<Functor>::size_type
+ChunkStream<Functor>::estimate(size_type input_size) const
+{
+    return detail::maxEncodedSize(functor_, input_size + pending_.size());
+}
+
+template <typename Functor>
+void ChunkStream<Functor>::reset()
+{
+    pending_.clear();
+}
+
+template <typename Functor>
+typename ChunkStream<Functor>::size_type ChunkStream<Functor>::pending() const
+{
+    return pending_.size();
+}
+
+template <typename Functor>
+Functor& ChunkStream<Functor>::functor()
+{
+    return functor_;
+}
+
+template <typename Functor>
+MessageStream<Functor>::MessageStream(Functor functor)
+    : functor_(std::move(functor))
+{
+}
+
+template <typename Functor>
+void MessageStream<Functor>::update(std::span<const char> input,
+                                    std::string& output)
+{
+    (void)output;
+    buffer_.append(input.data(), input.size());
+}
+
+template <typename Functor>
+void MessageStream<Functor>::finish(std::string& output)
+{
+    detail::appendEncoded(functor_, buffer_, output);
+    buffer_.clear();
+}
+
+template <typename Functor>
+typename MessageStream<Functor>::size_type
+MessageStream<Functor>::estimate(size_type input_size) const
+{
+    return detail::maxEncodedSize(functor_, input_size + buffer_.size());
+}
+
+template <typename Functor>
+void MessageStream<Functor>::reset()
+{
+    buffer_.clear();
+}
+
+template <typename Functor>
+typename MessageStream<Functor>::size_type
+MessageStream<Functor>::pending() const
+{
+    return buffer_.size();
+}
+
+template <typename Functor>
+Functor& MessageStream<Functor>::functor()
+{
+    return functor_;
+}
+
+template <typename Functor>
+ChunkStream<Functor> makeChunkStream(Functor functor, std::size_t block_size)
+{
+    return ChunkStream<Functor>(std::move(functor), block_size);
+}
+
+template <typename Functor>
+MessageStream<Functor> makeMessageStream(Functor functor)
+{
+    return MessageStream<Functor>(std::move(functor));
+}
+
+template <typename Functor>
+auto makeStream(Functor functor)
+{
+    if constexpr (detail::is_stream<Functor>::value)
+    {
+        return functor;
+    }
+    else if constexpr (detail::has_block_size<Functor>::value)
+    {
+        return makeChunkStream(std::move(functor), Functor::block_size);
+    }
+    else
+    {
+        return makeMessageStream(std::move(functor));
+    }
+}
+
+template <typename Stream>
+void process(Stream& stream,
+             std::span<const char> input,
+             std::string& output)
+{
+    auto size = output.size();
+    try
+    {
+        output.reserve(size + stream.estimate(input.size()));
+        stream.update(input, output);
+        stream.finish(output);
+    }
+    catch (...)
+    {
+        output.resize(size);
+        if constexpr (detail::has_reset<Stream>::value)
+        {
+            stream.reset();
+        }
+        throw;
+    }
+}
+
+} // namespace toolbox
@@ -0,0 +1 @@
+#include <toolbox/StructCodec.h>
@@ -0,0 +1,708 @@
+#pragma once
+
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <toolbox/Codec.h>
+#include <toolbox/Codecs.h>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace toolbox
+{
+
+/** How a field's value is written */
+enum class FieldEncoding
+{
+    fixed, /**< as its bytes, or length prefixed for strings and vectors */
+    varint /**< as a varint, zigzagged if signed; for integers only */
+};
+
+/** Describes a data member of a struct serialised by StructCodec
+ *
+ * Since is the schema version which added the field. Fields must be listed
+ * with non-decreasing versions, so that new fields follow old ones */
+template <auto Member,
+          unsigned Since = 1,
+          FieldEncoding Encoding = FieldEncoding::fixed>
+struct Field
+{
+    static constexpr auto member = Member;
+    static constexpr unsigned since = Since;
+    static constexpr FieldEncoding encoding = Encoding;
+};
+
+namespace detail
+{
+
+template <typename... Fields>
+constexpr std::tuple<Fields...> fieldTuple(int, Fields...)
+{
+    return {};
+}
+
+template <typename V>
+constexpr bool viewsInput();
+
+} // namespace detail
+
+} // namespace toolbox
+
+#define TOOLBOX_PARENS ()
+#define TOOLBOX_EXPAND(...)                                                   \
+    TOOLBOX_EXPAND3(                                                          \
+        TOOLBOX_EXPAND3(TOOLBOX_EXPAND3(TOOLBOX_EXPAND3(__VA_ARGS__))))
+#define TOOLBOX_EXPAND3(...)                                                  \
+    TOOLBOX_EXPAND2(                                                          \
+        TOOLBOX_EXPAND2(TOOLBOX_EXPAND2(TOOLBOX_EXPAND2(__VA_ARGS__))))
+#define TOOLBOX_EXPAND2(...)                                                  \
+    TOOLBOX_EXPAND1(                                                          \
+        TOOLBOX_EXPAND1(TOOLBOX_EXPAND1(TOOLBOX_EXPAND1(__VA_ARGS__))))
+#define TOOLBOX_EXPAND1(...) __VA_ARGS__
+#define TOOLBOX_FIELD_LIST(Type, name, ...)                                   \
+    , ::toolbox::Field<&Type::name>{} __VA_OPT__(                             \
+          TOOLBOX_FIELD_LIST_AGAIN TOOLBOX_PARENS(Type, __VA_ARGS__))
+#define TOOLBOX_FIELD_LIST_AGAIN() TOOLBOX_FIELD_LIST
+
+/** Declare the data members of Type which StructCodec serialises, in order
+ *
+ * Use at namespace scope in the namespace of Type. Fields added in later
+ * versions, or written as varints, are declared by defining the function
+ * this expands to by hand, e.g.
+ *
+ *     constexpr auto toolbox_fields(const Order*)
+ *     {
+ *         using namespace toolbox;
+ *         return std::tuple<Field<&Order::id>,
+ *                           Field<&Order::quantity, 1, FieldEncoding::varint>,
+ *                           Field<&Order::note, 2>>();
+ *     }
+ */
+#define TOOLBOX_FIELDS(Type, ...)                                             \
+    [[maybe_unused]] constexpr auto toolbox_fields(const Type*)               \
+    {                                                                         \
+        return ::toolbox::detail::fieldTuple(                                 \
+            0 TOOLBOX_EXPAND(TOOLBOX_FIELD_LIST(Type, __VA_ARGS__)));         \
+    }
+
+namespace toolbox
+{
+
+/** Serialises structs to a compact binary form derived from their fields
+ *
+ * The encoding is the schema version as a varint, then each field in turn.
+ * Trivially copyable fields are written as their bytes in host byte order,
+ * and runs of them which are adjacent in memory are copied with a single
+ * memcpy. Bools and enums are written alike but read one at a time, so that
+ * they can be checked; other trivially copyable types are trusted to be
+ * valid for any bytes. Strings and vectors are written as a varint length
+ * followed by their contents, again as one memcpy for trivially copyable
+ * elements.
+ * Nested structs with fields of their own are written length prefixed.
+ *
+ * Everything is resolved at compile time, with no virtual calls, and the
+ * output is sized exactly before it is written, so that it grows at most once
+ */
+template <typename T>
+class StructEncoder
+{
+public:
+    std::string operator()(const T& value) const;
+
+    void operator()(const T& value, std::string& output) const;
+
+    /** Get the exact length of the encoding of value */
+    std::size_t size(const T& value) const;
+};
+
+/** Deserialises the output of StructEncoder
+ *
+ * Data written by an older schema leaves the fields added since at their
+ * defaults, and fields which a newer schema appended are skipped. Fields of
+ * type std::string_view view the input, which must then outlive the result.
+ * Throws std::invalid_argument on truncated input, an invalid bool, an
+ * overlong varint or a varint field out of the range of its type
+ */
+template <typename T>
+class StructDecoder
+{
+public:
+    static constexpr bool views_input = detail::viewsInput<T>();
+
+    T operator()(std::string_view input) const;
+
+    /** Decode into value, reusing the capacity of its strings and vectors */
+    void operator()(std::string_view input, T& value) const;
+};
+
+template <typename T>
+Codec<StructEncoder<T>, StructDecoder<T>> makeStructCodec();
+
+namespace detail
+{
+
+template <typename T, typename = void>
+struct has_fields : std::false_type
+{
+};
+
+template <typename T>
+struct has_fields<
+    T,
+    std::void_t<decltype(toolbox_fields(static_cast<const T*>(nullptr)))>>
+    : std::true_type
+{
+};
+
+template <typename T>
+using fields_of = decltype(toolbox_fields(static_cast<const T*>(nullptr)));
+
+template <typename T>
+struct is_string : std::false_type
+{
+};
+
+template <typename Traits, typename Allocator>
+struct is_string<std::basic_string<char, Traits, Allocator>> : std::true_type
+{
+};
+
+template <typename T>
+struct is_vector : std::false_type
+{
+};
+
+template <typename U, typename Allocator>
+struct is_vector<std::vector<U, Allocator>> : std::true_type
+{
+};
+
+template <typename Allocator>
+struct is_vector<std::vector<bool, Allocator>> : std::false_type
+{
+    static_assert(!std::is_same_v<Allocator, Allocator>,
+                  "StructCodec can't serialise std::vector<bool>, which packs "
+                  "its bits and has no data(); use std::vector<std::uint8_t>");
+};
+
+/** Whether a value is written as its own bytes
+ *
+ * Not bools or enums, which are checked as they are read, since not every
+ * byte pattern is one of their values */
+template <typename V>
+constexpr bool is_raw = std::is_trivially_copyable_v<V> &&
+                        !std::is_pointer_v<V> && !has_fields<V>::value &&
+                        !std::is_same_v<V, std::string_view> &&
+                        !std::is_same_v<V, bool> && !std::is_enum_v<V>;
+
+/** Enums with a fixed underlying type, which every value of that type is an
+ * enumerator of, can be list initialised from it */
+template <typename V, typename = void>
+struct has_fixed_underlying_type : std::false_type
+{
+};
+
+template <typename V>
+struct has_fixed_underlying_type<
+    V,
+    std::void_t<decltype(V{std::underlying_type_t<V>()})>> : std::true_type
+{
+};
+
+template <typename Class, typename Member>
+Member memberType(Member Class::*);
+
+template <typename F>
+using field_type = decltype(memberType(F::member));
+
+/** The latest version among the fields of T, which fails to compile if
+ * they are out of order */
+template <typename T>
+constexpr unsigned schemaVersion()
+{
+    return std::apply(
+        [](auto... fields) {
+            auto result = 1u;
+            ((result = decltype(fields)::since >= result
+                           ? decltype(fields)::since
+                           : throw std::logic_error("fields out of order")),
+             ...);
+            return result;
+        },
+        fields_of<T>());
+}
+
+template <typename T>
+constexpr unsigned schema_version = schemaVersion<T>();
+
+/** Whether decoding a V may view its input */
+template <typename V>
+constexpr bool viewsInput()
+{
+    if constexpr (std::is_same_v<V, std::string_view>)
+    {
+        return true;
+    }
+    else if constexpr (is_vector<V>::value)
+    {
+        return viewsInput<typename V::value_type>();
+    }
+    else if constexpr (has_fields<V>::value)
+    {
+        return std::apply(
+            [](auto... fields) {
+                return (viewsInput<field_type<decltype(fields)>>() || ...);
+            },
+            fields_of<V>());
+    }
+    else
+    {
+        return false;
+    }
+}
+
+template <typename V>
+constexpr std::uint64_t toVarint(V value)
+{
+    static_assert(std::is_integral_v<V>, "Only integers can be varints");
+    if constexpr (std::is_signed_v<V>)
+    {
+        return ZigzagEncoder()(static_cast<std::int64_t>(value));
+    }
+    else
+    {
+        return static_cast<std::uint64_t>(value);
+    }
+}
+
+/** Convert a varint back to a V, rejecting values which don't fit */
+template <typename V>
+V fromVarint(std::uint64_t value)
+{
+    auto result = V();
+    if constexpr (std::is_signed_v<V>)
+    {
+        result = static_cast<V>(ZigzagDecoder()(value));
+    }
+    else
+    {
+        result = static_cast<V>(value);
+    }
+    if (toVarint(result) != value)
+    {
+        throw std::invalid_argument("StructDecoder: varint out of range");
+    }
+    return result;
+}
+
+constexpr std::size_t varintSize(std::uint64_t value)
+{
+    return (static_cast<std::size_t>(std::bit_width(value | 1)) + 6) / 7;
+}
+
+/** Write value as VarintEncoder does, into output which is already sized */
+inline char* putVarint(char* out, std::uint64_t value)
+{
+    while (value >= 0x80)
+    {
+        *out++ = static_cast<char>(value | 0x80);
+        value >>= 7;
+    }
+    *out++ = static_cast<char>(value);
+    return out;
+}
+
+/** Reads structs, checking that each read stays within the input */
+struct StructReader
+{
+    const char* in;
+    const char* end;
+
+    [[noreturn]] static void truncated()
+    {
+        throw std::invalid_argument("StructDecoder: truncated input");
+    }
+
+    const char* take(std::size_t size)
+    {
+        if (size > static_cast<std::size_t>(end - in))
+        {
+            truncated();
+        }
+        auto result = in;
+        in += size;
+        return result;
+    }
+
+    std::uint64_t varint()
+    {
+        auto result = std::uint64_t(0);
+        auto consumed = VarintDecoder()(
+            std::string_view(in, static_cast<std::size_t>(end - in)), result);
+        if (consumed == 0)
+        {
+            truncated();
+        }
+        in += consumed;
+        return result;
+    }
+};
+
+template <typename T>
+std::size_t structSize(const T& value);
+
+template <typename T>
+char* putStruct(char* out, const T& value);
+
+template <typename T>
+void getStruct(StructReader& reader, T& value);
+
+template <typename V>
+std::size_t valueSize(const V& value)
+{
+    if constexpr (is_string<V>::value || std::is_same_v<V, std::string_view>)
+    {
+        return varintSize(value.size()) + value.size();
+    }
+    else if constexpr (is_vector<V>::value)
+    {
+        using U = typename V::value_type;
+        auto result = varintSize(value.size());
+        if constexpr (is_raw<U>)
+        {
+            return result + value.size() * sizeof(U);
+        }
+        else
+        {
+            for (const auto& element : value)
+            {
+                result += valueSize(element);
+            }
+            return result;
+        }
+    }
+    else if constexpr (has_fields<V>::value)
+    {
+        auto size = structSize(value);
+        return varintSize(size) + size;
+    }
+    else if constexpr (std::is_same_v<V, bool> || std::is_enum_v<V>)
+    {
+        return sizeof(V);
+    }
+    else
+    {
+        static_assert(is_raw<V>, "StructCodec can't serialise this type");
+        return sizeof(V);
+    }
+}
+
+template <typename V>
+char* putValue(char* out, const V& value)
+{
+    if constexpr (is_string<V>::value || std::is_same_v<V, std::string_view>)
+    {
+        out = putVarint(out, value.size());
+        /** An empty string_view may have no data to copy from */
+        if (value.size() != 0)
+        {
+            std::memcpy(out, value.data(), value.size());
+        }
+        return out + value.size();
+    }
+    else if constexpr (is_vector<V>::value)
+    {
+        using U = typename V::value_type;
+        out = putVarint(out, value.size());
+        if constexpr (is_raw<U>)
+        {
+            /** An empty vector may have no data to copy from */
+            if (value.size() != 0)
+            {
+                std::memcpy(out, value.data(), value.size() * sizeof(U));
+            }
+            return out + value.size() * sizeof(U);
+        }
+        else
+        {
+            for (const auto& element : value)
+            {
+                out = putValue(out, element);
+            }
+            return out;
+        }
+    }
+    else if constexpr (has_fields<V>::value)
+    {
+        out = putVarint(out, structSize(value));
+        return putStruct(out, value);
+    }
+    else
+    {
+        std::memcpy(out, &value, sizeof(V));
+        return out + sizeof(V);
+    }
+}
+
+template <typename V>
+void getValue(StructReader& reader, V& value)
+{
+    if constexpr (is_string<V>::value || std::is_same_v<V, std::string_view>)
+    {
+        auto size = reader.varint();
+        auto data = reader.take(size);
+        if constexpr (is_string<V>::value)
+        {
+            value.assign(data, size);
+        }
+        else
+        {
+            value = V(data, size);
+        }
+    }
+    else if constexpr (is_vector<V>::value)
+    {
+        using U = typename V::value_type;
+        auto size = reader.varint();
+        /** Every element takes at least a byte, so this bounds size */
+        if (size > static_cast<std::uint64_t>(reader.end - reader.in))
+        {
+            reader.truncated();
+        }
+        if constexpr (is_raw<U>)
+        {
+            auto data = reader.take(size * sizeof(U));
+            value.resize(size);
+            if (size != 0)
+            {
+                std::memcpy(value.data(), data, size * sizeof(U));
+            }
+        }
+        else
+        {
+            value.resize(size);
+            for (auto& element : value)
+            {
+                getValue(reader, element);
+            }
+        }
+    }
+    else if constexpr (has_fields<V>::value)
+    {
+        auto size = reader.varint();
+        auto data = reader.take(size);
+        auto nested = StructReader{data, data + size};
+        getStruct(nested, value);
+    }
+    else if constexpr (std::is_same_v<V, bool>)
+    {
+        auto byte = static_cast<unsigned char>(*reader.take(1));
+        if (byte > 1)
+        {
+            throw std::invalid_argument("StructDecoder: invalid bool");
+        }
+        value = byte == 1;
+    }
+    else if constexpr (std::is_enum_v<V>)
+    {
+        static_assert(has_fixed_underlying_type<V>::value,
+                      "StructCodec can only read enums with a fixed "
+                      "underlying type, which every value of is valid");
+        auto underlying = std::underlying_type_t<V>();
+        getValue(reader, underlying);
+        value = static_cast<V>(underlying);
+    }
+    else
+    {
+        std::memcpy(&value, reader.take(sizeof(V)), sizeof(V));
+    }
+}
+
+template <typename F>
+constexpr bool is_raw_field =
+    F::encoding == FieldEncoding::fixed && is_raw<field_type<F>>;
+
+template <typename T>
+std::size_t structSize(const T& value)
+{
+    return std::apply(
+        [&value](auto... fields) {
+            return varintSize(schema_version<T>) +
+                   ([&value](auto field) {
+                       using F = decltype(field);
+                       if constexpr (F::encoding == FieldEncoding::varint)
+                       {
+                           return varintSize(toVarint(value.*F::member));
+                       }
+                       else
+                       {
+                           return valueSize(value.*F::member);
+                       }
+                   }(fields) +
+                    ... + 0);
+        },
+        fields_of<T>());
+}
+
+template <typename T>
+char* putStruct(char* out, const T& value)
+{
+    out = putVarint(out, schema_version<T>);
+    /** Adjacent raw fields accumulate into a run copied at once. Their
+     * offsets are constants, so the checks fold away */
+    auto run = static_cast<const char*>(nullptr);
+    auto run_size = std::size_t(0);
+    auto flush = [&out, &run_size, &run] {
+        if (run_size != 0)
+        {
+            std::memcpy(out, run, run_size);
+            out += run_size;
+            run_size = 0;
+        }
+    };
+    std::apply(
+        [&](auto... fields) {
+            (
+                [&](auto field) {
+                    using F = decltype(field);
+                    const auto& member = value.*F::member;
+                    if constexpr (is_raw_field<F>)
+                    {
+                        auto p = reinterpret_cast<const char*>(&member);
+                        if (run_size == 0 || run + run_size != p)
+                        {
+                            flush();
+                            run = p;
+                        }
+                        run_size += sizeof(member);
+                    }
+                    else
+                    {
+                        flush();
+                        if constexpr (F::encoding == FieldEncoding::varint)
+                        {
+                            out = putVarint(out, toVarint(member));
+                        }
+                        else
+                        {
+                            out = putValue(out, member);
+                        }
+                    }
+                }(fields),
+                ...);
+        },
+        fields_of<T>());
+    flush();
+    return out;
+}
+
+template <typename T>
+void getStruct(StructReader& reader, T& value)
+{
+    auto version = reader.varint();
+    auto run = static_cast<char*>(nullptr);
+    auto run_size = std::size_t(0);
+    auto flush = [&reader, &run_size, &run] {
+        if (run_size != 0)
+        {
+            std::memcpy(run, reader.take(run_size), run_size);
+            run_size = 0;
+        }
+    };
+    std::apply(
+        [&](auto... fields) {
+            (
+                [&](auto field) {
+                    using F = decltype(field);
+                    auto& member = value.*F::member;
+                    if (F::since > version)
+                    {
+                        /** Older data doesn't hold this field */
+                        return;
+                    }
+                    if constexpr (is_raw_field<F>)
+                    {
+                        auto p = reinterpret_cast<char*>(&member);
+                        if (run_size == 0 || run + run_size != p)
+                        {
+                            flush();
+                            run = p;
+                        }
+                        run_size += sizeof(member);
+                    }
+                    else
+                    {
+                        flush();
+                        if constexpr (F::encoding == FieldEncoding::varint)
+                        {
+                            auto raw = reader.varint();
+                            member = fromVarint<field_type<F>>(raw);
+                        }
+                        else
+                        {
+                            getValue(reader, member);
+                        }
+                    }
+                }(fields),
+                ...);
+        },
+        fields_of<T>());
+    flush();
+}
+
+} // namespace detail
+
+/********************************IMPLEMENTATION********************************/
+
+template <typename T>
+std::string StructEncoder<T>::operator()(const T& value) const
+{
+    auto result = std::string();
+    (*this)(value, result);
+    return result;
+}
+
+template <typename T>
+void StructEncoder<T>::operator()(const T& value, std::string& output) const
+{
+    auto offset = output.size();
+    output.resize(offset + size(value));
+    detail::putStruct(output.data() + offset, value);
+}
+
+template <typename T>
+std::size_t StructEncoder<T>::size(const T& value) const
+{
+    return detail::structSize(value);
+}
+
+template <typename T>
+T StructDecoder<T>::operator()(std::string_view input) const
+{
+    auto result = T();
+    (*this)(input, result);
+    return result;
+}
+
+template <typename T>
+void StructDecoder<T>::operator()(std::string_view input, T& value) const
+{
+    auto reader = detail::StructReader{input.data(),
+                                       input.data() + input.size()};
+    detail::getStruct(reader, value);
+}
+
+template <typename T>
+Codec<StructEncoder<T>, StructDecoder<T>> makeStructCodec()
+{
+    return makeCodec(StructEncoder<T>(), StructDecoder<T>());
+}
+
+} // namespace toolbox
@@ -0,0 +1,68 @@
+#include <functional>
+#include <mutex>
+#include <toolbox/SymbolTable.h>
+
+namespace toolbox
+{
+
+SymbolTable::size_type SymbolTable::default_shard_count()
+{
+    return detail::defaultShardCount();
+}
+
+SymbolTable::SymbolTable(size_type shard_count) : shards_(shard_count)
+{
+}
+
+SymbolTable::Shard& SymbolTable::shard(std::string_view token) const
+{
+    return shards_.shard(std::hash<std::string_view>()(token));
+}
+
+Symbol SymbolTable::intern(std::string_view token)
+{
+    auto& shard = this->shard(token);
+    {
+        auto lock = std::shared_lock(shard.mutex);
+        auto it = shard.symbols.find(token);
+        if (it != shard.symbols.end())
+        {
+            return it->second;
+        }
+    }
+    auto lock = std::unique_lock(shard.mutex);
+    auto it = shard.symbols.find(token);
+    if (it != shard.symbols.end())
+    {
+        return it->second;
+    }
+    auto names_lock = std::unique_lock(names_mutex_);
+    auto symbol = static_cast<Symbol>(names_.size());
+    /** A deque never moves its elements, so keys may view them */
+    const auto& name = names_.emplace_back(token);
+    names_lock.unlock();
+    shard.symbols.emplace(name, symbol);
+    return symbol;
+}
+
+Symbol SymbolTable::find(std::string_view token) const
+{
+    auto& shard = this->shard(token);
+    auto lock = std::shared_lock(shard.mutex);
+    auto it = shard.symbols.find(token);
+    return it == shard.symbols.end() ? npos : it->second;
+}
+
+std::string SymbolTable::name(Symbol symbol) const
+{
+    auto lock = std::shared_lock(names_mutex_);
+    return names_.at(symbol);
+}
+
+SymbolTable::size_type SymbolTable::size() const
+{
+    auto lock = std::shared_lock(names_mutex_);
+    return names_.size();
+}
+
+} // namespace toolbox
@@ -0,0 +1,113 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <toolbox/Shards.h>
+#include <unordered_map>
+#include <vector>
+
+namespace toolbox
+{
+
+/** The dense integer id of an interned token */
+using Symbol = std::uint32_t;
+
+/** Interns tokens, mapping each distinct token to a dense Symbol
+ *
+ * Sequences of tokens interned once compare with integer equality, e.g.
+ * through SequencePredicate over a vector of Symbols, rather than comparing
+ * strings at every step. Symbols are numbered from 0 in the order in which
+ * tokens are first interned.
+ *
+ * The table may be shared between threads. Tokens are spread over shards by
+ * hash, each guarded by its own reader-writer lock, so lookups of existing
+ * tokens proceed in parallel. Interning a new token also briefly takes a
+ * table-wide lock to number it and store its name, so insertions of new
+ * tokens serialise there even across shards
+ */
+class SymbolTable
+{
+public:
+    using size_type = std::size_t;
+
+    /** Returned by find() for a token which was never interned */
+    static constexpr Symbol npos = ~Symbol(0);
+
+    /** Default number of shards, a few per hardware thread */
+    static size_type default_shard_count();
+
+    explicit SymbolTable(size_type shard_count = default_shard_count());
+
+    SymbolTable(const SymbolTable&) = delete;
+
+    SymbolTable& operator=(const SymbolTable&) = delete;
+
+    /** Get the symbol of token, interning it if it's new */
+    Symbol intern(std::string_view token);
+
+    /** Intern each of [begin, end) */
+    template <typename Iterator>
+    std::vector<Symbol> intern(Iterator begin, Iterator end);
+
+    /** Get the symbol of token without interning it, or npos
+     *
+     * Input streams are best looked up this way, so that tokens which occur
+     * in no pattern don't grow the table. npos equals no interned symbol */
+    Symbol find(std::string_view token) const;
+
+    /** Look up each of [begin, end) */
+    template <typename Iterator>
+    std::vector<Symbol> find(Iterator begin, Iterator end) const;
+
+    /** Get the token interned as symbol */
+    std::string name(Symbol symbol) const;
+
+    /** Get the number of symbols */
+    size_type size() const;
+
+private:
+    struct Shard
+    {
+        mutable std::shared_mutex mutex;
+        std::unordered_map<std::string_view, Symbol> symbols;
+    };
+
+    detail::Shards<Shard> shards_;
+
+    /** Tokens by symbol, whose storage the shards' keys view. Symbols are
+     * dense, so numbering new tokens needs this one lock */
+    mutable std::shared_mutex names_mutex_;
+    std::deque<std::string> names_;
+
+    Shard& shard(std::string_view token) const;
+};
+
+/********************************IMPLEMENTATION********************************/
+
+template <typename Iterator>
+std::vector<Symbol> SymbolTable::intern(Iterator begin, Iterator end)
+{
+    auto result = std::vector<Symbol>();
+    for (; begin != end; ++begin)
+    {
+        result.push_back(intern(*begin));
+    }
+    return result;
+}
+
+template <typename Iterator>
+std::vector<Symbol> SymbolTable::find(Iterator begin, Iterator end) const
+{
+    auto result = std::vector<Symbol>();
+    for (; begin != end; ++begin)
+    {
+        result.push_back(find(*begin));
+    }
+    return result;
+}
+
+} // namespace toolbox
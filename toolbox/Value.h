@@ -1,24 +1,66 @@
 #pragma once
+#include <cstddef>
+#include <functional>
+#include <memory>
 #include <toolbox/Dereference.h>
 #include <type_traits>
+#include <utility>
 
 namespace toolbox
 {
 
+namespace detail
+{
+
+/** Gives Value the allocator_type of what it holds, if any, so that
+ * allocator aware containers pass their allocator down to it */
+template <typename T, typename = void>
+struct value_allocator
+{
+};
+
+template <typename T>
+struct value_allocator<T, std::void_t<typename T::allocator_type>>
+{
+    using allocator_type = typename T::allocator_type;
+};
+
+} // namespace detail
+
 /** Holds a value which may be a raw pointer, smart pointer or stack variable
+ *
+ * Where the value uses an allocator, e.g. a std::pmr::string, so does Value:
+ * it is constructed with the allocator of a std::pmr container holding it
  */
 template <typename T>
-class Value
+class Value : public detail::value_allocator<T>
 {
 private:
     T data_;
 
+    friend struct std::hash<Value>;
+
 public:
     using element_type =
         typename std::remove_reference<decltype(dereference<T>(data_))>::type;
 
     Value(T data);
 
+    /** Uses-allocator construction, passing allocator on to the value */
+    template <typename Allocator>
+    Value(std::allocator_arg_t, const Allocator& allocator);
+
+    template <typename Allocator>
+    Value(std::allocator_arg_t, const Allocator& allocator, T data);
+
+    template <typename Allocator>
+    Value(std::allocator_arg_t,
+          const Allocator& allocator,
+          const Value& other);
+
+    template <typename Allocator>
+    Value(std::allocator_arg_t, const Allocator& allocator, Value&& other);
+
     Value() = default;
     Value(Value&&) = default;
     Value(const Value&) = default;
@@ -45,6 +87,39 @@ Value<T>::Value(T data) : data_(std::move(data))
 {
 }
 
+template <typename T>
+template <typename Allocator>
+Value<T>::Value(std::allocator_arg_t, const Allocator& allocator)
+    : data_(std::make_obj_using_allocator<T>(allocator))
+{
+}
+
+template <typename T>
+template <typename Allocator>
+Value<T>::Value(std::allocator_arg_t, const Allocator& allocator, T data)
+    : data_(std::make_obj_using_allocator<T>(allocator, std::move(data)))
+{
+}
+
+template <typename T>
+template <typename Allocator>
+Value<T>::Value(std::allocator_arg_t,
+                const Allocator& allocator,
+                const Value& other)
+    : data_(std::make_obj_using_allocator<T>(allocator, other.data_))
+{
+}
+
+template <typename T>
+template <typename Allocator>
+Value<T>::Value(std::allocator_arg_t,
+                const Allocator& allocator,
+                Value&& other)
+    : data_(
+          std::make_obj_using_allocator<T>(allocator, std::move(other.data_)))
+{
+}
+
 template <typename T>
 typename Value<T>::element_type* Value<T>::get()
 {
@@ -106,3 +181,13 @@ bool Value<T>::operator>(const Value<T>& rhs) const
 }
 
 } // namespace toolbox
+
+/** Hashes what Value compares, so pointers by identity */
+template <typename T>
+struct std::hash<toolbox::Value<T>>
+{
+    std::size_t operator()(const toolbox::Value<T>& value) const
+    {
+        return std::hash<T>()(value.data_);
+    }
+};
@@ -0,0 +1,280 @@
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <string_view>
+#include <toolbox/CodecPipeline.h>
+#include <toolbox/Codecs.h>
+#include <toolbox/Compression.h>
+#include <toolbox/SequencePredicate.h>
+#include <toolbox/SequenceScan.h>
+#include <toolbox/Simd.h>
+#include <toolbox/StructCodec.h>
+#include <vector>
+
+/** Compares the built-in codecs at each dispatch level against the naive
+ * implementations which they replace
+ *
+ * Build with -DTOOLBOX_BENCHMARKS=ON and run BenchToolbox */
+
+struct Quote
+{
+    std::uint64_t id = 0;
+    std::uint64_t time = 0;
+    double bid = 0;
+    double ask = 0;
+    std::uint32_t bid_size = 0;
+    std::uint32_t ask_size = 0;
+    std::string venue;
+};
+
+TOOLBOX_FIELDS(Quote, id, time, bid, ask, bid_size, ask_size, venue)
+
+namespace
+{
+
+std::string naiveBase64(std::string_view input)
+{
+    static const char alphabet[] =
+        "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+    auto result = std::string();
+    auto bits = 0u;
+    auto count = 0;
+    for (auto c : input)
+    {
+        bits = bits << 8 | static_cast<unsigned char>(c);
+        count += 8;
+        while (count >= 6)
+        {
+            count -= 6;
+            result += alphabet[bits >> count & 0x3f];
+        }
+    }
+    if (count > 0)
+    {
+        result += alphabet[bits << (6 - count) & 0x3f];
+    }
+    while (result.size() % 4 != 0)
+    {
+        result += '=';
+    }
+    return result;
+}
+
+std::string naiveHex(std::string_view input)
+{
+    static const char digits[] = "0123456789abcdef";
+    auto result = std::string();
+    for (auto c : input)
+    {
+        auto byte = static_cast<unsigned char>(c);
+        result += digits[byte >> 4];
+        result += digits[byte & 0xf];
+    }
+    return result;
+}
+
+std::string naiveVarints(const std::vector<std::uint64_t>& values)
+{
+    auto result = std::string();
+    for (auto value : values)
+    {
+        do
+        {
+            auto byte = static_cast<char>(value & 0x7f);
+            value >>= 7;
+            result += value ? static_cast<char>(byte | 0x80) : byte;
+        } while (value);
+    }
+    return result;
+}
+
+/** Report the throughput of f over bytes of input in MB/s */
+template <typename F>
+void measure(const char* name, std::size_t bytes, F f)
+{
+    const auto iterations = 200;
+    /** Keeps the results observable so that the work isn't elided */
+    volatile auto sink = std::size_t(0);
+    auto start = std::chrono::steady_clock::now();
+    for (auto i = 0; i < iterations; ++i)
+    {
+        sink = sink + f();
+    }
+    auto elapsed = std::chrono::duration<double>(
+                       std::chrono::steady_clock::now() - start)
+                       .count();
+    std::printf("%-28s %10.1f MB/s\n", name,
+                static_cast<double>(bytes) * iterations / elapsed / 1e6);
+}
+
+const char* levelName(toolbox::SimdLevel level)
+{
+    switch (level)
+    {
+        case toolbox::SimdLevel::scalar:
+            return "scalar";
+        case toolbox::SimdLevel::ssse3:
+            return "ssse3";
+        case toolbox::SimdLevel::sse42:
+            return "sse4.2";
+        case toolbox::SimdLevel::avx2:
+            return "avx2";
+    }
+    return "";
+}
+
+} // namespace
+
+int main()
+{
+    auto random = std::mt19937(1);
+    auto input = std::string(1 << 20, '\0');
+    for (auto& c : input)
+    {
+        c = static_cast<char>(random());
+    }
+    auto values = std::vector<std::uint64_t>(1 << 17);
+    for (auto& value : values)
+    {
+        value = random() >> (random() % 32);
+    }
+    auto base64 = toolbox::Base64Encoder()(input);
+    auto hex = toolbox::HexEncoder()(input);
+    auto varints = naiveVarints(values);
+
+    measure("base64 encode naive", input.size(),
+            [&] { return naiveBase64(input).size(); });
+    measure("hex encode naive", input.size(),
+            [&] { return naiveHex(input).size(); });
+    measure("varint encode naive", varints.size(),
+            [&] { return naiveVarints(values).size(); });
+
+    auto needle = input.substr(input.size() / 2, 8);
+    auto predicate =
+        toolbox::StreamingSequencePredicate(needle.cbegin(), needle.cend());
+    measure("sequence scan naive", input.size(), [&] {
+        auto count = std::size_t(0);
+        predicate.reset();
+        for (auto c : input)
+        {
+            count += predicate(c);
+        }
+        return count;
+    });
+
+    auto output = std::string();
+    auto decoded = std::vector<std::uint64_t>();
+    auto positions = std::vector<std::size_t>();
+    auto detected = toolbox::detectSimdLevel();
+    for (auto level : {toolbox::SimdLevel::scalar, toolbox::SimdLevel::ssse3,
+                       toolbox::SimdLevel::avx2})
+    {
+        if (level > detected)
+        {
+            continue;
+        }
+        toolbox::simdLevel(level);
+        std::printf("-- %s\n", levelName(level));
+        measure("base64 encode", input.size(), [&] {
+            output.clear();
+            toolbox::Base64Encoder()(input, output);
+            return output.size();
+        });
+        measure("base64 decode", base64.size(), [&] {
+            output.clear();
+            toolbox::Base64Decoder()(base64, output);
+            return output.size();
+        });
+        measure("hex encode", input.size(), [&] {
+            output.clear();
+            toolbox::HexEncoder()(input, output);
+            return output.size();
+        });
+        measure("hex decode", hex.size(), [&] {
+            output.clear();
+            toolbox::HexDecoder()(hex, output);
+            return output.size();
+        });
+        measure("sequence scan", input.size(), [&] {
+            positions.clear();
+            toolbox::scanSequence(std::span<const char>(input),
+                                  std::span<const char>(needle), positions);
+            return positions.size();
+        });
+    }
+    auto hex_codec = toolbox::makeHexCodec();
+    auto base64_codec = toolbox::makeBase64Codec();
+    auto chained = hex_codec | base64_codec;
+    measure("hex then base64", input.size(), [&] {
+        return base64_codec.encode(hex_codec.encode(input)).size();
+    });
+    measure("hex | base64", input.size(), [&] {
+        output.clear();
+        chained.encoder()(input, output);
+        return output.size();
+    });
+    measure("varint encode", varints.size(), [&] {
+        output.clear();
+        toolbox::VarintEncoder()(values, output);
+        return output.size();
+    });
+    measure("varint decode", varints.size(), [&] {
+        decoded.clear();
+        return toolbox::VarintDecoder()(varints, decoded);
+    });
+    auto text = std::string();
+    while (text.size() < input.size())
+    {
+        text += "record " + std::to_string(random() % 1000) +
+                ": the quick brown fox jumps over the lazy dog\n";
+    }
+    auto compressed = toolbox::LzEncoder()(text);
+    std::printf("-- lz ratio %.2f\n",
+                static_cast<double>(text.size()) / compressed.size());
+    measure("lz compress", text.size(), [&] {
+        output.clear();
+        toolbox::LzEncoder()(text, output);
+        return output.size();
+    });
+    measure("lz decompress", text.size(), [&] {
+        output.clear();
+        toolbox::LzDecoder()(compressed, output);
+        return output.size();
+    });
+    auto quotes = std::vector<Quote>(1 << 14);
+    for (auto& quote : quotes)
+    {
+        quote = Quote{random(), random(), 1.5, 1.6, 100, 200, "XLON"};
+    }
+    auto quote_bytes = quotes.size() * toolbox::StructEncoder<Quote>().size(
+                                          quotes.front());
+    measure("struct append naive", quote_bytes, [&] {
+        output.clear();
+        for (const auto& quote : quotes)
+        {
+            output.append(reinterpret_cast<const char*>(&quote.id), 40);
+            output.append(quote.venue);
+        }
+        return output.size();
+    });
+    measure("struct encode", quote_bytes, [&] {
+        output.clear();
+        for (const auto& quote : quotes)
+        {
+            toolbox::StructEncoder<Quote>()(quote, output);
+        }
+        return output.size();
+    });
+    auto encoded_quote = toolbox::StructEncoder<Quote>()(quotes.front());
+    auto decoded_quote = Quote();
+    measure("struct decode", quote_bytes, [&] {
+        for (std::size_t i = 0; i < quotes.size(); ++i)
+        {
+            toolbox::StructDecoder<Quote>()(encoded_quote, decoded_quote);
+        }
+        return decoded_quote.venue.size();
+    });
+    return 0;
+}
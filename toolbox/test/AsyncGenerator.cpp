@@ -0,0 +1,106 @@
+#include "gtest/gtest.h"
+#include <coroutine>
+#include <exception>
+#include <toolbox/AsyncGenerator.h>
+#include <vector>
+
+namespace
+{
+
+/** Coroutine which starts eagerly and destroys itself on completion */
+struct Task
+{
+    struct promise_type
+    {
+        Task get_return_object() noexcept
+        {
+            return {};
+        }
+
+        std::suspend_never initial_suspend() const noexcept
+        {
+            return {};
+        }
+
+        std::suspend_never final_suspend() const noexcept
+        {
+            return {};
+        }
+
+        void return_void() noexcept
+        {
+        }
+
+        void unhandled_exception() noexcept
+        {
+            std::terminate();
+        }
+    };
+};
+
+/** Stands in for an I/O completion which is signalled later */
+struct Event
+{
+    std::coroutine_handle<> waiter;
+
+    bool await_ready() const noexcept
+    {
+        return false;
+    }
+
+    void await_suspend(std::coroutine_handle<> coroutine) noexcept
+    {
+        waiter = coroutine;
+    }
+
+    void await_resume() const noexcept
+    {
+    }
+
+    void set()
+    {
+        std::exchange(waiter, nullptr).resume();
+    }
+};
+
+toolbox::AsyncGenerator<int> read(Event& event, int n)
+{
+    for (auto i = 0; i < n; ++i)
+    {
+        co_await event;
+        co_yield i;
+    }
+}
+
+Task consume(toolbox::AsyncGenerator<int>& generator,
+             std::vector<int>& result,
+             bool& finished)
+{
+    for (auto it = co_await generator.begin(); it != generator.end();
+         co_await ++it)
+    {
+        result.push_back(*it);
+    }
+    finished = true;
+}
+
+} // namespace
+
+TEST(Toolbox, AsyncGenerator)
+{
+    using Output = std::vector<int>;
+    auto event = Event();
+    auto generator = read(event, 3);
+    auto result = Output{};
+    auto finished = false;
+    consume(generator, result, finished);
+    EXPECT_TRUE(result.empty());
+    event.set();
+    EXPECT_EQ((Output{0}), result);
+    event.set();
+    EXPECT_EQ((Output{0, 1}), result);
+    EXPECT_FALSE(finished);
+    event.set();
+    EXPECT_EQ((Output{0, 1, 2}), result);
+    EXPECT_TRUE(finished);
+}
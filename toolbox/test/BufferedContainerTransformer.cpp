@@ -0,0 +1,185 @@
+#include "gtest/gtest.h"
+#include <map>
+#include <set>
+#include <stdexcept>
+#include <string>
+#include <toolbox/BufferedContainerTransformer.h>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace
+{
+
+struct Encode
+{
+    int operator()(const std::string& input) const
+    {
+        return std::atoi(input.c_str());
+    }
+};
+
+struct Decode
+{
+    std::string operator()(int input) const
+    {
+        return std::to_string(input);
+    }
+};
+
+/** Orders ints, but throws comparing 6 while armed */
+struct FragileLess
+{
+    static inline bool armed = false;
+
+    bool operator()(int lhs, int rhs) const
+    {
+        if (armed && (lhs == 6 || rhs == 6))
+        {
+            throw std::runtime_error("FragileLess");
+        }
+        return lhs < rhs;
+    }
+};
+
+} // namespace
+
+TEST(Toolbox, BufferedContainerTransformer)
+{
+    using Strings = std::vector<std::string>;
+    using set_t = std::set<int>;
+    using Transform = std::pair<Encode, Decode>;
+    {
+        auto underlying = set_t{1, 3, 5};
+        auto set = toolbox::BufferedContainerTransformer<set_t, Transform>(
+            underlying, Transform(), 100);
+        set.insert("4");
+        set.insert("2");
+        set.erase("3");
+        set.insert("3");
+        set.erase("5");
+        set.insert("1");
+        set.erase("6");
+        EXPECT_EQ(7u, set.buffered());
+        EXPECT_EQ((set_t{1, 3, 5}), underlying);
+        EXPECT_EQ(4u, set.size());
+        EXPECT_EQ((Strings{"1", "2", "3", "4"}),
+                  Strings(set.begin(), set.end()));
+        EXPECT_EQ("2", *set.find("2"));
+        EXPECT_EQ("3", *set.find("3"));
+        EXPECT_EQ(set.end(), set.find("5"));
+        EXPECT_EQ(set.end(), set.find("6"));
+        EXPECT_EQ(6u, set.buffered()); // collapsed to one write per key
+        set.flush();
+        EXPECT_EQ(0u, set.buffered());
+        EXPECT_EQ((set_t{1, 2, 3, 4}), underlying);
+        set.clear();
+        EXPECT_TRUE(set.empty());
+    }
+    {
+        auto underlying = set_t{};
+        auto set = toolbox::BufferedContainerTransformer<set_t, Transform>(
+            underlying, Transform(), 4);
+        for (auto value : {"9", "7", "8"})
+        {
+            set.insert(value);
+        }
+        EXPECT_TRUE(underlying.empty());
+        set.insert("6"); // reaches the threshold
+        EXPECT_EQ((set_t{6, 7, 8, 9}), underlying);
+        EXPECT_EQ(0u, set.buffered());
+    }
+    {
+        /** Writes still buffered are flushed on destruction */
+        auto underlying = set_t{1};
+        {
+            auto set = toolbox::BufferedContainerTransformer<set_t, Transform>(
+                underlying, Transform(), 100);
+            set.insert("2");
+            set.erase("1");
+            EXPECT_EQ((set_t{1}), underlying);
+        }
+        EXPECT_EQ((set_t{2}), underlying);
+    }
+    {
+        /** Moves hand the buffer over, so each write is merged once */
+        static_assert(!std::is_copy_constructible_v<
+                      toolbox::BufferedContainerTransformer<set_t, Transform>>);
+        auto underlying = set_t{};
+        auto other = set_t{};
+        {
+            auto set = toolbox::BufferedContainerTransformer<set_t, Transform>(
+                underlying, Transform(), 100);
+            set.insert("1");
+            auto moved = std::move(set);
+            EXPECT_EQ(1u, moved.buffered());
+            auto assigned =
+                toolbox::BufferedContainerTransformer<set_t, Transform>(
+                    other, Transform(), 100);
+            assigned.insert("2");
+            assigned = std::move(moved);
+            EXPECT_EQ((set_t{2}), other);
+            EXPECT_EQ(1u, assigned.buffered());
+            assigned.insert("3");
+        }
+        EXPECT_EQ((set_t{1, 3}), underlying);
+        EXPECT_EQ((set_t{2}), other);
+    }
+    {
+        /** A failed flush keeps only the writes it didn't merge */
+        using fragile_t = std::set<int, FragileLess>;
+        auto underlying = fragile_t{1, 5};
+        {
+            auto set =
+                toolbox::BufferedContainerTransformer<fragile_t, Transform>(
+                    underlying, Transform(), 100);
+            set.insert("2");
+            set.erase("4");
+            set.insert("4");
+            set.insert("6");
+            EXPECT_EQ(5u, set.size());
+            FragileLess::armed = true;
+            EXPECT_THROW(set.flush(), std::runtime_error);
+            EXPECT_EQ(1u, set.buffered());
+            EXPECT_EQ((fragile_t{1, 2, 4, 5}), underlying);
+            FragileLess::armed = false;
+            set.flush();
+            EXPECT_EQ((fragile_t{1, 2, 4, 5, 6}), underlying);
+
+            /** Destruction swallows errors instead of terminating */
+            set.insert("6");
+            set.erase("6");
+            EXPECT_EQ(4u, set.size());
+            FragileLess::armed = true;
+        }
+        FragileLess::armed = false;
+        EXPECT_EQ((fragile_t{1, 2, 4, 5, 6}), underlying);
+    }
+    {
+        struct MapEncode
+        {
+            int operator()(int input) const
+            {
+                return input;
+            }
+            std::pair<int, std::string>
+            operator()(const std::pair<int, std::string>& input) const
+            {
+                return input;
+            }
+        };
+        using map_t = std::map<int, std::string>;
+        using MapTransform = std::pair<MapEncode, MapEncode>;
+        auto underlying = map_t{{1, "one"}, {2, "two"}};
+        auto map =
+            toolbox::BufferedContainerTransformer<map_t, MapTransform>(
+                underlying);
+        map.insert(std::make_pair(1, "uno"));
+        map.erase(2);
+        map.insert(std::make_pair(2, "dos"));
+        EXPECT_EQ("one", map.find(1)->second);
+        EXPECT_EQ("dos", map.find(2)->second);
+        map.flush();
+        EXPECT_EQ((map_t{{1, "one"}, {2, "dos"}}), underlying);
+    }
+}
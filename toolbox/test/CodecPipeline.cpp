@@ -0,0 +1,87 @@
+#include "gtest/gtest.h"
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <toolbox/CodecPipeline.h>
+#include <toolbox/Codecs.h>
+#include <type_traits>
+
+namespace
+{
+
+/** A stage which must see the whole message */
+struct Reverse
+{
+    std::string operator()(std::string_view input) const
+    {
+        return std::string(input.rbegin(), input.rend());
+    }
+};
+
+} // namespace
+
+TEST(Toolbox, CodecPipeline)
+{
+    using namespace std::string_literals;
+    auto random = std::mt19937(3);
+    auto input = std::string(10000, '\0');
+    for (auto& c : input)
+    {
+        c = static_cast<char>(random());
+    }
+    auto hex = toolbox::makeHexCodec();
+    auto base64 = toolbox::makeBase64Codec();
+    {
+        auto codec = hex | base64;
+        EXPECT_EQ(base64.encode(hex.encode("hello"s)), codec.encode("hello"s));
+        EXPECT_EQ("hello", codec.decode(codec.encode("hello"s)));
+        EXPECT_EQ("", codec.encode(""s));
+        /** Chunk boundaries which split blocks of every stage */
+        for (auto chunk_size : {1u, 7u, 4096u})
+        {
+            codec.encoder().chunk_size(chunk_size);
+            codec.decoder().chunk_size(chunk_size);
+            auto encoded = codec.encode(input);
+            EXPECT_EQ(base64.encode(hex.encode(input)), encoded);
+            EXPECT_EQ(input, codec.decode(encoded));
+        }
+        EXPECT_EQ(base64.encoder().max_size(hex.encoder().max_size(10)),
+                  codec.encoder().estimate(10));
+        /** A message failing in any stage leaves nothing behind for the
+         * next, nor in the output */
+        auto valid = codec.encode("hello"s);
+        for (auto invalid : {base64.encode("0g"s), "Z"s, valid + "!"})
+        {
+            auto output = "prefix"s;
+            EXPECT_THROW(codec.decoder()(invalid, output),
+                         std::invalid_argument);
+            EXPECT_EQ("prefix", output);
+            EXPECT_EQ("hello", codec.decode(valid));
+        }
+    }
+    {
+        /** Chains are flattened, and whole-message stages are buffered */
+        auto reverse = makeCodec(Reverse(), Reverse());
+        auto codec = hex | reverse | base64;
+        static_assert(
+            std::tuple_size<std::decay_t<decltype(
+                codec.encoder().stages())>>::value == 3);
+        auto expected = base64.encode(reverse.encode(hex.encode(input)));
+        EXPECT_EQ(expected, codec.encode(input));
+        EXPECT_EQ(input, codec.decode(expected));
+        EXPECT_THROW(codec.decode(base64.encode("0g"s)),
+                     std::invalid_argument);
+        EXPECT_EQ(input, codec.decode(expected));
+    }
+    {
+        /** A pipeline is a stream, so input may arrive in pieces */
+        auto codec = base64 | hex;
+        auto& encoder = codec.encoder();
+        auto output = std::string();
+        encoder.update("ab"s, output);
+        encoder.update("cd"s, output);
+        encoder.finish(output);
+        EXPECT_EQ(hex.encode(base64.encode("abcd"s)), output);
+    }
+}
@@ -0,0 +1,167 @@
+#include "gtest/gtest.h"
+#include <cstdint>
+#include <limits>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <toolbox/Codecs.h>
+#include <toolbox/Simd.h>
+#include <toolbox/StreamCodec.h>
+#include <vector>
+
+TEST(Toolbox, Codecs)
+{
+    using namespace std::string_literals;
+    using toolbox::Base64Alphabet;
+    {
+        /** RFC 4648 test vectors */
+        auto codec = toolbox::makeBase64Codec();
+        auto vectors = std::vector<std::pair<std::string, std::string>>{
+            {"", ""},         {"f", "Zg=="},         {"fo", "Zm8="},
+            {"foo", "Zm9v"},  {"foob", "Zm9vYg=="},  {"fooba", "Zm9vYmE="},
+            {"foobar", "Zm9vYmFy"}};
+        for (const auto& vector : vectors)
+        {
+            EXPECT_EQ(vector.second, codec.encode(vector.first));
+            EXPECT_EQ(vector.first, codec.decode(vector.second));
+        }
+        auto url = toolbox::makeBase64Codec(Base64Alphabet::url, false);
+        EXPECT_EQ("-_8", url.encode("\xfb\xff"s));
+        EXPECT_EQ("\xfb\xff"s, url.decode("-_8"s));
+        EXPECT_EQ("\xfb\xff"s, url.decode("-_8="s));
+        EXPECT_THROW(codec.decode("Zm9v!mFy"s), std::invalid_argument);
+        EXPECT_THROW(codec.decode("Zm9vY"s), std::invalid_argument);
+        EXPECT_THROW(codec.decode("Zg="s), std::invalid_argument);
+        EXPECT_THROW(url.decode("+/8="s), std::invalid_argument);
+        /** Appending decodes leave their output as is when they throw,
+         * including after vectorised blocks have been written */
+        for (auto invalid : {"QUJD!!!!"s, std::string(64, 'A') + "!!!!"})
+        {
+            auto output = "prefix"s;
+            EXPECT_THROW(codec.decoder()(invalid, output),
+                         std::invalid_argument);
+            EXPECT_EQ("prefix", output);
+        }
+    }
+    {
+        auto codec = toolbox::makeHexCodec();
+        EXPECT_EQ("00ff7f10", codec.encode("\x00\xff\x7f\x10"s));
+        EXPECT_EQ("\x00\xff\x7f\x10"s, codec.decode("00FF7f10"s));
+        EXPECT_THROW(codec.decode("0"s), std::invalid_argument);
+        EXPECT_THROW(codec.decode("0g"s), std::invalid_argument);
+        auto output = "prefix"s;
+        EXPECT_THROW(codec.decoder()(std::string(64, '0') + "0g", output),
+                     std::invalid_argument);
+        EXPECT_EQ("prefix", output);
+    }
+    {
+        /** Every dispatch level agrees with the scalar code, including on
+         * lengths which end mid-block and on errors past the first block */
+        auto random = std::mt19937(42);
+        auto byte = std::uniform_int_distribution<int>(0, 255);
+        auto detected = toolbox::detectSimdLevel();
+        for (auto size = 0u; size < 300; size += 7)
+        {
+            auto input = std::string(size, '\0');
+            for (auto& c : input)
+            {
+                c = static_cast<char>(byte(random));
+            }
+            for (auto alphabet :
+                 {Base64Alphabet::standard, Base64Alphabet::url})
+            {
+                auto encoder = toolbox::Base64Encoder(alphabet);
+                auto decoder = toolbox::Base64Decoder(alphabet);
+                toolbox::simdLevel(toolbox::SimdLevel::scalar);
+                auto expected = encoder(input);
+                for (auto level : {toolbox::SimdLevel::ssse3,
+                                   toolbox::SimdLevel::avx2})
+                {
+                    toolbox::simdLevel(level);
+                    EXPECT_EQ(expected, encoder(input));
+                    EXPECT_EQ(input, decoder(expected));
+                    if (expected.size() > 40)
+                    {
+                        auto invalid = expected;
+                        invalid[36] = '*';
+                        EXPECT_THROW(decoder(invalid), std::invalid_argument);
+                    }
+                }
+            }
+            auto hex = toolbox::HexEncoder();
+            toolbox::simdLevel(toolbox::SimdLevel::scalar);
+            auto expected = hex(input);
+            for (auto level :
+                 {toolbox::SimdLevel::ssse3, toolbox::SimdLevel::avx2})
+            {
+                toolbox::simdLevel(level);
+                EXPECT_EQ(expected, hex(input));
+                EXPECT_EQ(input, toolbox::HexDecoder()(expected));
+            }
+        }
+        EXPECT_EQ(detected, toolbox::simdLevel(detected));
+    }
+    {
+        /** The text codecs stream in whole blocks */
+        auto input = std::string(1000, 'x');
+        auto encoder = toolbox::makeChunkStream(toolbox::Base64Encoder(), 3);
+        auto encoded = std::string();
+        for (std::size_t i = 0; i < input.size(); i += 100)
+        {
+            encoder.update(std::string_view(input).substr(i, 100), encoded);
+        }
+        encoder.finish(encoded);
+        EXPECT_EQ(toolbox::Base64Encoder()(input), encoded);
+        auto decoder = toolbox::makeChunkStream(toolbox::Base64Decoder(), 4);
+        auto decoded = std::string();
+        toolbox::process(decoder, encoded, decoded);
+        EXPECT_EQ(input, decoded);
+    }
+    {
+        auto codec = toolbox::makeVarintCodec();
+        EXPECT_EQ("\x00"s, codec.encode(0));
+        EXPECT_EQ("\x7f"s, codec.encode(127));
+        EXPECT_EQ("\x80\x01"s, codec.encode(128));
+        EXPECT_EQ("\xac\x02"s, codec.encode(300));
+        auto values = std::vector<std::uint64_t>{
+            0, 1, 127, 128, 300, 1ull << 35, (1ull << 56) - 1, 1ull << 56,
+            std::numeric_limits<std::uint64_t>::max()};
+        for (auto value : values)
+        {
+            EXPECT_EQ(value, codec.decode(codec.encode(value)));
+        }
+        auto encoded = std::string();
+        codec.encoder()(values, encoded);
+        auto decoded = std::vector<std::uint64_t>();
+        EXPECT_EQ(encoded.size(), codec.decoder()(encoded, decoded));
+        EXPECT_EQ(values, decoded);
+        /** A truncated varint is left unconsumed */
+        decoded.clear();
+        encoded.pop_back();
+        EXPECT_EQ(encoded.size() - 9, codec.decoder()(encoded, decoded));
+        EXPECT_EQ(values.size() - 1, decoded.size());
+        EXPECT_THROW(codec.decode("\x80"s), std::invalid_argument);
+        EXPECT_THROW(codec.decode("\x01\x02"s), std::invalid_argument);
+        EXPECT_THROW(codec.decode(std::string(10, '\xff') + "\x01"s),
+                     std::invalid_argument);
+        decoded = {7};
+        EXPECT_THROW(codec.decoder()("\x01"s + std::string(10, '\xff'),
+                                     decoded),
+                     std::invalid_argument);
+        EXPECT_EQ((std::vector<std::uint64_t>{7}), decoded);
+    }
+    {
+        auto codec = toolbox::makeZigzagCodec();
+        EXPECT_EQ(0u, codec.encode(0));
+        EXPECT_EQ(1u, codec.encode(-1));
+        EXPECT_EQ(2u, codec.encode(1));
+        EXPECT_EQ(3u, codec.encode(-2));
+        for (auto value : {std::numeric_limits<std::int64_t>::min(),
+                           std::int64_t(-12345), std::int64_t(0),
+                           std::numeric_limits<std::int64_t>::max()})
+        {
+            EXPECT_EQ(value, codec.decode(codec.encode(value)));
+        }
+        static_assert(toolbox::ZigzagEncoder()(-3) == 5);
+    }
+}
@@ -0,0 +1,15 @@
+#include "gtest/gtest.h"
+#include <string>
+#include <toolbox/Composition.h>
+
+TEST(Toolbox, Composition)
+{
+    auto times_ten = [](int value) { return value * 10; };
+    auto plus_one = [](int value) { return value + 1; };
+    auto to_string = [](int value) { return std::to_string(value); };
+    EXPECT_EQ(20, toolbox::compose(times_ten, plus_one)(1));
+    EXPECT_EQ(11, toolbox::compose(plus_one, times_ten)(1));
+    EXPECT_EQ("21", toolbox::compose(to_string, plus_one, times_ten)(2));
+    const auto composition = toolbox::compose(to_string, times_ten, plus_one);
+    EXPECT_EQ("30", composition(2));
+}
@@ -0,0 +1,142 @@
+#include "gtest/gtest.h"
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <toolbox/Compression.h>
+#include <toolbox/FramedCodec.h>
+#include <vector>
+
+TEST(Toolbox, Compression)
+{
+    using namespace std::string_literals;
+    auto random = std::mt19937(7);
+    auto text = std::string();
+    while (text.size() < 100000)
+    {
+        text += "record " + std::to_string(random() % 1000) +
+                ": the quick brown fox jumps over the lazy dog\n";
+    }
+    auto noise = std::string(5000, '\0');
+    for (auto& c : noise)
+    {
+        c = static_cast<char>(random());
+    }
+    auto inputs = std::vector<std::string>{"",
+                                           "a",
+                                           "abcabcabcabc",
+                                           std::string(1000, 'x'),
+                                           std::string(70000, '\0'),
+                                           text,
+                                           noise,
+                                           noise + noise};
+    {
+        auto codec = toolbox::makeLzCodec();
+        for (const auto& input : inputs)
+        {
+            auto encoded = codec.encode(input);
+            EXPECT_LE(encoded.size(), codec.encoder().max_size(input.size()));
+            EXPECT_EQ(input, codec.decode(encoded));
+        }
+        EXPECT_LT(codec.encode(text).size(), text.size() / 4);
+        EXPECT_LT(codec.encode(std::string(1000, 'x')).size(), 20u);
+        /** Repeats more than 64KiB apart are out of reach */
+        EXPECT_GT(codec.encode(noise + std::string(70000, '\0') + noise)
+                      .size(),
+                  2 * noise.size());
+    }
+    {
+        /** A context reused across calls compresses exactly as a fresh one */
+        auto encoder = toolbox::LzEncoder();
+        auto context = toolbox::LzContext();
+        for (const auto& input : inputs)
+        {
+            auto reused = std::string();
+            encoder(input, reused, context);
+            auto fresh = std::string();
+            auto other = toolbox::LzContext();
+            encoder(input, fresh, other);
+            EXPECT_EQ(fresh, reused);
+        }
+        auto output = "prefix"s;
+        encoder("abcabcabcabc", output, context);
+        EXPECT_EQ("abcabcabcabc", toolbox::LzDecoder()(output.substr(6)));
+    }
+    {
+        auto codec = toolbox::makeLzCodec();
+        auto encoded = codec.encode(text);
+        EXPECT_THROW(codec.decode(encoded.substr(0, encoded.size() - 1)),
+                     std::invalid_argument);
+        EXPECT_THROW(codec.decode(""s), std::invalid_argument);
+        EXPECT_THROW(codec.decode("\x05\x10\x01\x00\x00"s),
+                     std::invalid_argument);
+        EXPECT_THROW(codec.decode("\xff\xff\xff\x0f"s), std::invalid_argument);
+        /** Decoders which throw leave what they append to as is */
+        for (const auto& invalid :
+             {encoded.substr(0, encoded.size() - 1), "\x05\x10\x01\x00\x00"s})
+        {
+            auto output = "prefix"s;
+            EXPECT_THROW(codec.decoder()(invalid, output),
+                         std::invalid_argument);
+            EXPECT_EQ("prefix", output);
+        }
+    }
+    {
+        /** Tiny records share little with themselves, but a trained
+         * dictionary holds what they share with each other */
+        auto records = std::vector<std::string>();
+        for (auto i = 0; i < 200; ++i)
+        {
+            records.push_back(R"({"id":)" + std::to_string(random() % 100000) +
+                              R"(,"type":"order","status":"shipped",)"
+                              R"("currency":"EUR"})");
+        }
+        auto dictionary = toolbox::CompressionDictionary::train(
+            std::vector<std::string>(records.begin(), records.begin() + 100),
+            1024);
+        EXPECT_FALSE(dictionary.empty());
+        EXPECT_LE(dictionary.content().size(), 1024u);
+        auto plain = toolbox::makeLzCodec();
+        auto trained = toolbox::makeLzCodec(dictionary);
+        auto plain_size = std::size_t(0);
+        auto trained_size = std::size_t(0);
+        for (auto i = 100u; i < records.size(); ++i)
+        {
+            auto encoded = trained.encode(records[i]);
+            EXPECT_EQ(records[i], trained.decode(encoded));
+            plain_size += plain.encode(records[i]).size();
+            trained_size += encoded.size();
+        }
+        EXPECT_LT(trained_size * 2, plain_size);
+        /** Decoding needs the same dictionary */
+        EXPECT_THROW(plain.decode(trained.encode(records[150])),
+                     std::invalid_argument);
+        /** Matches may run from the dictionary on into the input */
+        auto tail = std::string(dictionary.content().substr(
+            dictionary.content().size() - 10));
+        auto input = tail + tail + tail;
+        EXPECT_EQ(input, trained.decode(trained.encode(input)));
+        EXPECT_TRUE(toolbox::CompressionDictionary().empty());
+        EXPECT_TRUE(
+            toolbox::CompressionDictionary::train(std::vector<std::string>())
+                .empty());
+    }
+    {
+        auto codec = toolbox::makeRleCodec();
+        for (const auto& input : inputs)
+        {
+            auto encoded = codec.encode(input);
+            EXPECT_LE(encoded.size(), codec.encoder().max_size(input.size()));
+            EXPECT_EQ(input, codec.decode(encoded));
+        }
+        EXPECT_EQ("\x01" "ab\x81x"s, codec.encode("abxxxx"s));
+        EXPECT_EQ(2u * (1 + 1000 / 130), codec.encode(std::string(1000, 'x'))
+                                             .size());
+        EXPECT_THROW(codec.decode("\x05" "ab"s), std::invalid_argument);
+        EXPECT_THROW(codec.decode("\x81"s), std::invalid_argument);
+    }
+    {
+        /** Frames compress independently, so they can go in parallel */
+        auto framed = toolbox::makeFramedCodec(toolbox::makeLzCodec(), 4096);
+        EXPECT_EQ(text, framed.decode(framed.encode(text)));
+    }
+}
@@ -0,0 +1,115 @@
+#include "gtest/gtest.h"
+#include <map>
+#include <set>
+#include <string>
+#include <thread>
+#include <toolbox/ConcurrentContainerTransformer.h>
+#include <unordered_set>
+#include <vector>
+
+namespace
+{
+
+struct Encode
+{
+    int operator()(const std::string& input) const
+    {
+        return std::atoi(input.c_str());
+    }
+};
+
+struct Decode
+{
+    std::string operator()(int input) const
+    {
+        return std::to_string(input);
+    }
+};
+
+} // namespace
+
+TEST(Toolbox, ConcurrentContainerTransformer)
+{
+    using Transform = std::pair<Encode, Decode>;
+    {
+        auto set = toolbox::ConcurrentContainerTransformer<std::set<int>,
+                                                           Transform>(4);
+        EXPECT_EQ(4u, set.shard_count());
+        EXPECT_TRUE(set.empty());
+        EXPECT_TRUE(set.insert("1"));
+        EXPECT_FALSE(set.insert("1"));
+        EXPECT_TRUE(set.insert("2"));
+        EXPECT_EQ(2u, set.size());
+        EXPECT_EQ("1", set.find("1").value());
+        EXPECT_FALSE(set.find("3").has_value());
+        EXPECT_TRUE(set.contains("2"));
+        EXPECT_EQ(1u, set.erase("2"));
+        EXPECT_EQ(0u, set.erase("2"));
+        EXPECT_FALSE(set.contains("2"));
+        auto values = std::vector<std::string>{"3", "4", "5", "3"};
+        set.insert(values.begin(), values.end());
+        auto seen = std::set<std::string>();
+        set.for_each(
+            [&seen](const std::string& value) { seen.insert(value); });
+        EXPECT_EQ((std::set<std::string>{"1", "3", "4", "5"}), seen);
+        set.clear();
+        EXPECT_TRUE(set.empty());
+    }
+    {
+        /** Writers and readers on separate threads */
+        auto set =
+            toolbox::ConcurrentContainerTransformer<std::unordered_set<int>,
+                                                    Transform>();
+        const auto threads = 4;
+        const auto count = 1000;
+        auto workers = std::vector<std::thread>();
+        for (auto t = 0; t < threads; ++t)
+        {
+            workers.emplace_back([&set, t, count]() {
+                for (auto i = 0; i < count; ++i)
+                {
+                    set.insert(std::to_string(t * count + i));
+                }
+            });
+            workers.emplace_back([&set, count]() {
+                for (auto i = 0; i < count; ++i)
+                {
+                    auto found = set.find(std::to_string(i));
+                    if (found)
+                    {
+                        EXPECT_EQ(std::to_string(i), *found);
+                    }
+                }
+            });
+        }
+        for (auto& worker : workers)
+        {
+            worker.join();
+        }
+        EXPECT_EQ(static_cast<std::size_t>(threads * count), set.size());
+        for (auto i = 0; i < threads * count; ++i)
+        {
+            EXPECT_TRUE(set.contains(std::to_string(i)));
+        }
+    }
+    {
+        struct MapEncode
+        {
+            int operator()(int input) const
+            {
+                return input;
+            }
+            std::pair<int, std::string>
+            operator()(const std::pair<int, std::string>& input) const
+            {
+                return input;
+            }
+        };
+        using MapTransform = std::pair<MapEncode, MapEncode>;
+        auto map =
+            toolbox::ConcurrentContainerTransformer<std::map<int, std::string>,
+                                                    MapTransform>(2);
+        map.insert(std::make_pair(1, std::string("one")));
+        EXPECT_EQ("one", map.find(1)->second);
+    }
+}
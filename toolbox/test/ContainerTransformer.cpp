@@ -1,5 +1,14 @@
 #include "gtest/gtest.h"
+#include <list>
+#include <map>
+#include <set>
+#include <string>
+#include <string_view>
+#include <thread>
 #include <toolbox/ContainerTransformer.h>
+#include <toolbox/DecodeCache.h>
+#include <unordered_set>
+#include <vector>
 
 TEST(Toolbox, ContainerTransformer)
 {
@@ -59,3 +68,305 @@ TEST(Toolbox, ContainerTransformer)
         EXPECT_EQ(it->second, "1234");
     }
 }
+
+namespace
+{
+
+/** Encodes through copies on several threads at once */
+struct BulkEncoder
+{
+    static constexpr bool concurrent = true;
+
+    int operator()(const std::string& input) const
+    {
+        return std::atoi(input.c_str());
+    }
+};
+
+struct BulkDecoder
+{
+    std::string operator()(int input) const
+    {
+        return std::to_string(input);
+    }
+};
+
+} // namespace
+
+TEST(Toolbox, ContainerTransformerBulk)
+{
+    using Transform = std::pair<BulkEncoder, BulkDecoder>;
+    auto input = std::vector<std::string>();
+    for (auto i = 0; i < 10000; ++i)
+    {
+        input.push_back(std::to_string((i * 7919) % 10000));
+    }
+    {
+        auto underlying = std::set<int>{5000, 20000};
+        auto set = toolbox::ContainerTransformer<std::set<int>, Transform>(
+            underlying);
+        set.insert(input.begin(), input.end());
+        EXPECT_EQ(10001u, set.size());
+        EXPECT_EQ(0, *underlying.begin());
+        EXPECT_EQ(20000, *underlying.rbegin());
+        auto keys = std::vector<std::string>{"1", "-1", "9999"};
+        auto found = std::vector<decltype(set)::const_iterator>();
+        set.find_many(keys.begin(), keys.end(), std::back_inserter(found));
+        ASSERT_EQ(3u, found.size());
+        EXPECT_EQ("1", *found[0]);
+        EXPECT_EQ(set.cend(), found[1]);
+        EXPECT_EQ("9999", *found[2]);
+        EXPECT_EQ(2u, set.erase(keys.begin(), keys.end()));
+        EXPECT_EQ(set.cend(), set.find("1"));
+        EXPECT_EQ(9999u, set.size());
+    }
+    {
+        using unordered_t = std::unordered_set<int>;
+        auto underlying = unordered_t{};
+        auto set = toolbox::ContainerTransformer<unordered_t, Transform>(
+            underlying);
+        auto keys = std::list<std::string>{"3", "1", "2", "1"};
+        set.insert(keys.begin(), keys.end());
+        EXPECT_EQ((unordered_t{1, 2, 3}), underlying);
+        EXPECT_EQ(3u, set.erase(keys.begin(), keys.end()));
+        EXPECT_TRUE(set.empty());
+    }
+    {
+        /** Encoders which don't declare themselves concurrent are only
+         * called on the calling thread, so may share state */
+        auto calls = 0;
+        auto caller = std::this_thread::get_id();
+        auto encode = [&calls, caller](const std::string& input) {
+            EXPECT_EQ(caller, std::this_thread::get_id());
+            ++calls;
+            return std::atoi(input.c_str());
+        };
+        using Shared = std::pair<std::function<int(const std::string&)>,
+                                 BulkDecoder>;
+        auto underlying = std::set<int>{};
+        auto set = toolbox::ContainerTransformer<std::set<int>, Shared>(
+            underlying, Shared(encode, BulkDecoder()));
+        set.insert(input.begin(), input.end());
+        EXPECT_EQ(10000, calls);
+        EXPECT_EQ(10000u, set.size());
+    }
+}
+
+namespace
+{
+
+struct Name
+{
+    std::string value;
+
+    bool operator==(const Name& rhs) const
+    {
+        return value == rhs.value;
+    }
+};
+
+/** Counts the keys which were encoded into a new string */
+int encodings = 0;
+
+struct ProjectingEncoder
+{
+    std::string operator()(const Name& name) const
+    {
+        ++encodings;
+        return name.value;
+    }
+
+    std::string_view project(const Name& name) const
+    {
+        return name.value;
+    }
+};
+
+struct ScratchEncoder
+{
+    std::string operator()(int value) const
+    {
+        ++encodings;
+        return std::to_string(value);
+    }
+
+    void operator()(int value, std::string& encoded) const
+    {
+        encoded.assign(std::to_string(value));
+    }
+};
+
+struct NameDecoder
+{
+    Name operator()(const std::string& value) const
+    {
+        return Name{value};
+    }
+};
+
+struct IntDecoder
+{
+    int operator()(const std::string& value) const
+    {
+        return std::atoi(value.c_str());
+    }
+};
+
+} // namespace
+
+TEST(Toolbox, ContainerTransformerLookup)
+{
+    {
+        using set_t = std::set<std::string, std::less<>>;
+        using Transform = std::pair<ProjectingEncoder, NameDecoder>;
+        auto underlying = set_t{};
+        auto set =
+            toolbox::ContainerTransformer<set_t, Transform>(underlying);
+        set.insert(Name{"alice"});
+        set.insert(Name{"bob"});
+        encodings = 0;
+        auto it = set.find(Name{"bob"});
+        ASSERT_NE(set.cend(), it);
+        EXPECT_EQ(Name{"bob"}, *it);
+        EXPECT_EQ(set.cend(), set.find(Name{"carol"}));
+        EXPECT_EQ(1u, set.erase(Name{"alice"}));
+        EXPECT_EQ(0u, set.erase(Name{"alice"}));
+        EXPECT_EQ(0, encodings);
+        EXPECT_EQ((set_t{"bob"}), underlying);
+
+        /** Bulk lookups take the same path */
+        auto names = std::vector<Name>{{"bob"}, {"carol"}};
+        auto found = std::vector<decltype(set)::const_iterator>();
+        set.find_many(names.begin(), names.end(), std::back_inserter(found));
+        ASSERT_EQ(2u, found.size());
+        EXPECT_EQ(Name{"bob"}, *found[0]);
+        EXPECT_EQ(set.cend(), found[1]);
+        EXPECT_EQ(1u, set.erase(names.begin(), names.end()));
+        EXPECT_EQ(0, encodings);
+        EXPECT_TRUE(underlying.empty());
+    }
+    {
+        using set_t = std::set<std::string>;
+        using Transform = std::pair<ScratchEncoder, IntDecoder>;
+        auto underlying = set_t{};
+        auto set =
+            toolbox::ContainerTransformer<set_t, Transform>(underlying);
+        set.insert(12);
+        set.insert(34);
+        encodings = 0;
+        auto it = set.find(34);
+        ASSERT_NE(set.cend(), it);
+        EXPECT_EQ(34, *it);
+        EXPECT_EQ(set.cend(), set.find(56));
+        EXPECT_EQ(1u, set.erase(12));
+        EXPECT_EQ(0, encodings);
+        EXPECT_EQ((set_t{"34"}), underlying);
+        auto keys = std::vector<int>{34, 56};
+        auto found = std::vector<decltype(set)::const_iterator>();
+        set.find_many(keys.begin(), keys.end(), std::back_inserter(found));
+        EXPECT_EQ(34, *found[0]);
+        EXPECT_EQ(1u, set.erase(keys.begin(), keys.end()));
+        EXPECT_EQ(0, encodings);
+    }
+}
+
+namespace
+{
+
+/** Counts the values which were decoded */
+int decodings = 0;
+
+struct CountingDecoder
+{
+    std::string operator()(int value) const
+    {
+        ++decodings;
+        return std::to_string(value);
+    }
+};
+
+struct IntEncoder
+{
+    int operator()(const std::string& value) const
+    {
+        return std::atoi(value.c_str());
+    }
+};
+
+/** A decoder which can only discard values one element at a time */
+struct ElementDecoder
+{
+    std::string operator()(int value) const
+    {
+        return std::to_string(value);
+    }
+
+    void invalidate(const int& stored) const
+    {
+        invalidated->push_back(stored);
+    }
+
+    std::vector<int>* invalidated;
+};
+
+} // namespace
+
+TEST(Toolbox, ContainerTransformerCache)
+{
+    using set_t = std::set<int>;
+    using Transform = toolbox::CachedTransform<
+        std::pair<IntEncoder, CountingDecoder>, int>;
+    auto underlying = set_t{};
+    auto set = toolbox::ContainerTransformer<set_t, Transform>(underlying);
+    const auto& cache = set.cbegin().transform().cache();
+    set.insert("1");
+    set.insert("2");
+    set.insert("3");
+    decodings = 0;
+    auto result = std::vector<std::string>(set.cbegin(), set.cend());
+    EXPECT_EQ((std::vector<std::string>{"1", "2", "3"}), result);
+    EXPECT_EQ(3, decodings);
+    result.assign(set.cbegin(), set.cend());
+    EXPECT_EQ(3, decodings);
+    EXPECT_EQ(3u, cache.size());
+
+    /** References handed out are stable and shared */
+    auto found = set.find("2");
+    const auto& two = *found;
+    EXPECT_EQ(&two, &*std::next(set.cbegin()));
+    EXPECT_EQ(3, decodings);
+
+    EXPECT_EQ(1u, set.erase("2"));
+    EXPECT_EQ(2u, cache.size());
+    set.insert("2");
+    EXPECT_EQ("2", *set.find("2"));
+    EXPECT_EQ(4, decodings);
+    set.clear();
+    EXPECT_EQ(0u, cache.size());
+
+    /** clear() falls back on discarding each element's value */
+    auto invalidated = std::vector<int>();
+    using ElementTransform = std::pair<IntEncoder, ElementDecoder>;
+    auto elements = toolbox::ContainerTransformer<set_t, ElementTransform>(
+        underlying,
+        ElementTransform(IntEncoder(), ElementDecoder{&invalidated}));
+    elements.insert("4");
+    elements.insert("5");
+    invalidated.clear();
+    elements.clear();
+    EXPECT_EQ((std::vector<int>{4, 5}), invalidated);
+    EXPECT_TRUE(underlying.empty());
+
+    /** A dereferenced value outlives its eviction while its iterator does */
+    auto small = toolbox::ContainerTransformer<set_t, Transform>(
+        underlying,
+        Transform(IntEncoder(),
+                  Transform::second_type(CountingDecoder(), 1)));
+    small.insert("1");
+    small.insert("2");
+    auto it = small.find("1");
+    const auto& one = *it;
+    EXPECT_EQ("2", *small.find("2"));
+    EXPECT_EQ(1u, it.transform().cache().size());
+    EXPECT_EQ("1", one);
+}
@@ -0,0 +1,60 @@
+#include "gtest/gtest.h"
+#include <string>
+#include <thread>
+#include <toolbox/DecodeCache.h>
+#include <vector>
+
+TEST(Toolbox, DecodeCache)
+{
+    auto cache = toolbox::DecodeCache<std::string>(2);
+    auto a = 1, b = 2, c = 3;
+    auto decode = [](int value) {
+        return [value]() { return std::to_string(value); };
+    };
+    auto first = cache.get(&a, decode(a));
+    EXPECT_EQ("1", *first);
+    EXPECT_EQ(first, cache.get(&a, decode(0)));
+    auto second = cache.get(&b, decode(b));
+    cache.get(&a, decode(a));
+    cache.get(&c, decode(c)); // evicts b, the least recently used
+    EXPECT_EQ(2u, cache.size());
+    EXPECT_EQ("1", *cache.get(&a, decode(0)));
+    /** An evicted value outlives its entry while referenced */
+    EXPECT_EQ("2", *second);
+    EXPECT_EQ("0", *cache.get(&b, decode(0)));
+    cache.invalidate(&b);
+    EXPECT_EQ(1u, cache.size());
+    cache.invalidate();
+    EXPECT_EQ(0u, cache.size());
+
+    /** A capacity of 0 bounds nothing */
+    auto unbounded = toolbox::DecodeCache<std::string>(0);
+    auto values = std::vector<int>(100);
+    for (auto& value : values)
+    {
+        unbounded.get(&value, decode(value));
+    }
+    EXPECT_EQ(values.size(), unbounded.size());
+    EXPECT_EQ("0", *unbounded.get(&values.front(), decode(1)));
+
+    /** Threads share one cache, evicting values which others hold */
+    auto shared = toolbox::DecodeCache<std::string>(2);
+    auto elements = std::vector<int>{0, 1, 2, 3};
+    auto threads = std::vector<std::thread>();
+    for (auto t = 0; t < 4; ++t)
+    {
+        threads.emplace_back([&shared, &elements, &decode, t] {
+            for (auto i = 0; i < 1000; ++i)
+            {
+                auto& element = elements[(i + t) % elements.size()];
+                auto value = shared.get(&element, decode(element));
+                EXPECT_EQ(std::to_string(element), *value);
+            }
+        });
+    }
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
+    EXPECT_EQ(2u, shared.size());
+}
@@ -0,0 +1,95 @@
+#include "gtest/gtest.h"
+#include <memory_resource>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <toolbox/FieldCodec.h>
+#include <utility>
+#include <vector>
+
+namespace
+{
+
+/** Counts the allocations made through it */
+class CountingResource : public std::pmr::memory_resource
+{
+public:
+    std::size_t allocations = 0;
+
+private:
+    void* do_allocate(std::size_t bytes, std::size_t alignment) override
+    {
+        ++allocations;
+        return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+    }
+
+    void do_deallocate(void* p,
+                       std::size_t bytes,
+                       std::size_t alignment) override
+    {
+        std::pmr::new_delete_resource()->deallocate(p, bytes, alignment);
+    }
+
+    bool do_is_equal(const memory_resource& other) const noexcept override
+    {
+        return this == &other;
+    }
+};
+
+template <typename Codec, typename Input>
+concept Decodable = requires(Codec codec, Input&& input) {
+    codec.decode(std::forward<Input>(input));
+};
+
+} // namespace
+
+TEST(Toolbox, FieldCodec)
+{
+    using namespace std::string_literals;
+    auto codec = toolbox::makeFieldCodec();
+    auto inner = codec.encode(std::vector<std::string>{"x", "yz"});
+    auto fields = std::vector<std::string>{"GET", "", std::string(300, 'a'),
+                                           inner};
+    auto encoded = codec.encode(fields);
+    {
+        auto decoded = codec.decode(encoded);
+        ASSERT_EQ(4u, decoded.size());
+        EXPECT_EQ("GET", decoded[0]);
+        EXPECT_EQ("", decoded[1]);
+        EXPECT_EQ(std::string(300, 'a'), decoded[2]);
+        /** Fields view the input rather than copying it */
+        EXPECT_EQ(encoded.data() + 1, decoded[0].data());
+        auto nested = codec.decode(decoded[3]);
+        EXPECT_EQ((std::vector<std::string_view>{"x", "yz"}), nested);
+        EXPECT_EQ(4u, codec.decoder().size(encoded));
+        EXPECT_TRUE(codec.decode(""s, *std::pmr::new_delete_resource())
+                        .empty());
+    }
+    {
+        /** Views of a temporary would dangle, so only the arena form, which
+         * copies, accepts one */
+        using FieldCodec = decltype(codec);
+        static_assert(Decodable<FieldCodec, const std::string&>);
+        static_assert(!Decodable<FieldCodec, std::string>);
+        static_assert(Decodable<FieldCodec, std::string_view>);
+        EXPECT_EQ("yz", codec.decode(std::string_view(inner))[1]);
+        auto counting = CountingResource();
+        auto arena = std::pmr::monotonic_buffer_resource(&counting);
+        auto decoded = codec.decode(codec.encode(fields), arena);
+        ASSERT_EQ(4u, decoded.size());
+        EXPECT_EQ(std::string(300, 'a'), decoded[2]);
+        EXPECT_EQ("yz", codec.decode(decoded[3])[1]);
+        EXPECT_LE(counting.allocations, 2u);
+        auto many = std::vector<std::string>(1000, "field");
+        auto before = counting.allocations;
+        auto other = codec.decode(codec.encode(many), arena);
+        EXPECT_EQ(1000u, other.size());
+        EXPECT_LE(counting.allocations - before, 2u);
+    }
+    {
+        EXPECT_THROW(codec.decoder()("\x05" "abc"s), std::invalid_argument);
+        EXPECT_THROW(codec.decoder()("\x80"s), std::invalid_argument);
+        auto arena = std::pmr::monotonic_buffer_resource();
+        EXPECT_THROW(codec.decode("\x02" "a"s, arena), std::invalid_argument);
+    }
+}
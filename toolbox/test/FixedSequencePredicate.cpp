@@ -0,0 +1,79 @@
+#include "gtest/gtest.h"
+#include <array>
+#include <cstdint>
+#include <random>
+#include <string>
+#include <toolbox/FixedSequencePredicate.h>
+#include <toolbox/SequencePredicate.h>
+#include <vector>
+
+namespace
+{
+
+/** Count the occurrences of the fixed sequence in input at compile time */
+template <typename Predicate, std::size_t N>
+constexpr int count(const char (&input)[N])
+{
+    auto predicate = Predicate();
+    auto result = 0;
+    for (std::size_t i = 0; i + 1 < N; ++i)
+    {
+        result += predicate(input[i]);
+    }
+    return result;
+}
+
+} // namespace
+
+TEST(Toolbox, FixedSequencePredicate)
+{
+    {
+        /** Pairs advance through the sequence as with SequencePredicate */
+        auto predicate = toolbox::FixedSequencePredicate<2, 3, 5>();
+        EXPECT_FALSE(predicate({1, 2}));
+        EXPECT_TRUE(predicate({2, 3}));
+        EXPECT_FALSE(predicate({2, 3}));
+        EXPECT_TRUE(predicate({3, 5}));
+        EXPECT_FALSE(predicate({5, 8}));
+        EXPECT_EQ(2u, predicate.position());
+        static_assert(toolbox::FixedSequencePredicate<'a', 'b'>()({'a', 'b'}));
+    }
+    {
+        using Predicate = toolbox::FixedStreamingSequencePredicate<'a', 'a'>;
+        static_assert(sizeof(Predicate::state_type) == 1);
+        static_assert(Predicate::mask('a') == 0b11);
+        static_assert(Predicate::mask('b') == 0);
+        static_assert(count<Predicate>("aaab") == 2);
+        auto predicate = Predicate();
+        EXPECT_FALSE(predicate('a'));
+        EXPECT_TRUE(predicate('a'));
+        EXPECT_TRUE(predicate('a'));
+        EXPECT_EQ(1u, predicate.match_position());
+        EXPECT_FALSE(predicate('b'));
+        EXPECT_EQ(0u, predicate.progress());
+        predicate.reset();
+        EXPECT_EQ(Predicate::npos, predicate.match_position());
+    }
+    {
+        /** Agrees with StreamingSequencePredicate on random input */
+        static constexpr auto sequence = std::array<std::uint8_t, 6>{
+            1, 2, 1, 2, 1, 3};
+        auto fixed = toolbox::FixedStreamingSequencePredicateOf<sequence>();
+        auto streaming = toolbox::StreamingSequencePredicate<
+            std::array<std::uint8_t, 6>::const_iterator>(sequence.cbegin(),
+                                                         sequence.cend());
+        auto random = std::mt19937(11);
+        for (auto i = 0; i < 5000; ++i)
+        {
+            auto value = static_cast<std::uint8_t>(1 + random() % 3);
+            ASSERT_EQ(streaming(value), fixed(value)) << i;
+            ASSERT_EQ(streaming.progress(), fixed.progress()) << i;
+        }
+        EXPECT_EQ(streaming.match_position(), fixed.match_position());
+        using Long = toolbox::FixedSequencePredicateOf<std::array<int, 40>{}>;
+        static_assert(Long::size == 40);
+        using Wide = toolbox::FixedStreamingSequencePredicateOf<
+            std::array<int, 40>{}>;
+        static_assert(sizeof(Wide::state_type) == 8);
+    }
+}
@@ -0,0 +1,19 @@
+#include "gtest/gtest.h"
+#include <toolbox/FramePool.h>
+
+TEST(Toolbox, FramePool)
+{
+    using toolbox::FramePool;
+    auto frame = FramePool::allocate(100);
+    FramePool::deallocate(frame, 100);
+    /** A frame in the same size bucket is reused */
+    auto reused = FramePool::allocate(90);
+    EXPECT_EQ(frame, reused);
+    auto other = FramePool::allocate(100);
+    EXPECT_NE(reused, other);
+    FramePool::deallocate(reused, 90);
+    FramePool::deallocate(other, 100);
+    auto large = FramePool::allocate(FramePool::max_size + 1);
+    EXPECT_NE(nullptr, large);
+    FramePool::deallocate(large, FramePool::max_size + 1);
+}
@@ -0,0 +1,85 @@
+#include "gtest/gtest.h"
+#include <cstdint>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <toolbox/Codecs.h>
+#include <toolbox/FramedCodec.h>
+
+TEST(Toolbox, FramedCodec)
+{
+    auto random = std::mt19937(7);
+    auto input = std::string(100000, '\0');
+    for (auto& c : input)
+    {
+        c = static_cast<char>(random());
+    }
+    {
+        auto framed =
+            toolbox::makeFramedCodec(toolbox::makeBase64Codec(), 3000);
+        auto encoded = framed.encode(input);
+        EXPECT_EQ(input, framed.decode(encoded));
+        /** Frames can be decoded individually */
+        auto index = toolbox::FrameIndex(encoded);
+        EXPECT_EQ(34u, index.size());
+        EXPECT_EQ(3000u, index.frame_size());
+        EXPECT_EQ(input.size(), index.decoded_size());
+        EXPECT_EQ(1000u, index.decoded_size(33));
+        EXPECT_EQ(toolbox::Base64Encoder()(input.substr(3000, 3000)),
+                  index.frame(1));
+        auto frame = index.frame_at(50000);
+        EXPECT_EQ(16u, frame);
+        EXPECT_EQ(input.substr(48000, 3000), framed.decode(index, frame));
+        EXPECT_EQ(input.substr(99000), framed.decode(index, 33));
+        EXPECT_THROW(index.frame(34), std::out_of_range);
+        EXPECT_THROW(index.decoded_size(34), std::out_of_range);
+        EXPECT_THROW(framed.decode(index, 34), std::out_of_range);
+        EXPECT_THROW(framed.decode(index, std::size_t(-1)), std::out_of_range);
+    }
+    {
+        auto framed = toolbox::makeFramedCodec(toolbox::makeHexCodec(), 1);
+        EXPECT_EQ("", framed.decode(framed.encode("")));
+        EXPECT_EQ("abc", framed.decode(framed.encode("abc")));
+    }
+    {
+        auto framed = toolbox::makeFramedCodec(toolbox::makeHexCodec(), 4096);
+        auto encoded = framed.encode(input);
+        EXPECT_THROW(framed.decode(encoded.substr(0, 20)),
+                     std::invalid_argument);
+        EXPECT_THROW(framed.decode(encoded.substr(0, encoded.size() - 1)),
+                     std::invalid_argument);
+        /** A frame whose encoding is damaged fails to decode */
+        encoded[toolbox::FrameIndex::header_size +
+                25 * toolbox::FrameIndex::entry_size + 10] = 'z';
+        EXPECT_THROW(framed.decode(encoded), std::invalid_argument);
+    }
+    {
+        /** Headers claiming huge outputs fail before anything is allocated */
+        auto header = [](std::uint64_t frame_size,
+                         std::uint64_t decoded_size,
+                         std::uint64_t size) {
+            auto result = std::string();
+            toolbox::FrameIndex::put(result, toolbox::FrameIndex::magic);
+            toolbox::FrameIndex::put(result, frame_size);
+            toolbox::FrameIndex::put(result, decoded_size);
+            toolbox::FrameIndex::put(result, size);
+            return result;
+        };
+        auto framed = toolbox::makeFramedCodec(toolbox::makeHexCodec());
+        auto huge = header(1ull << 40, 1ull << 40, 1);
+        toolbox::FrameIndex::put(huge, 0);
+        toolbox::FrameIndex::put(huge, 0);
+        EXPECT_EQ(48u, huge.size());
+        EXPECT_THROW(framed.decode(huge), std::invalid_argument);
+        /** Rounding the frame count up mustn't overflow to 0 frames */
+        EXPECT_THROW(framed.decode(header(2, ~0ull, 0)),
+                     std::invalid_argument);
+        auto limited =
+            toolbox::makeFramedCodec(toolbox::makeHexCodec(), 4096, 1000);
+        EXPECT_EQ(1000u, limited.max_decoded_size());
+        EXPECT_EQ(input.substr(0, 1000),
+                  limited.decode(limited.encode(input.substr(0, 1000))));
+        EXPECT_THROW(limited.decode(limited.encode(input.substr(0, 1001))),
+                     std::invalid_argument);
+    }
+}
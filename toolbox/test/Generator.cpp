@@ -0,0 +1,104 @@
+#include "gtest/gtest.h"
+#include <stdexcept>
+#include <string>
+#include <toolbox/Generator.h>
+#include <toolbox/IteratorFilter.h>
+#include <toolbox/IteratorRecorder.h>
+#include <toolbox/IteratorTransformer.h>
+#include <vector>
+
+namespace
+{
+
+toolbox::Generator<int> count(int n)
+{
+    for (auto i = 0; i < n; ++i)
+    {
+        co_yield i;
+    }
+}
+
+toolbox::Generator<const std::string&> words()
+{
+    auto word = std::string("alpha");
+    co_yield word;
+    word = "beta";
+    co_yield word;
+}
+
+toolbox::Generator<int> fail()
+{
+    co_yield 1;
+    throw std::runtime_error("fail");
+}
+
+struct Double
+{
+    int operator()(int value) const
+    {
+        return value * 2;
+    }
+};
+
+struct IsOdd
+{
+    bool operator()(int value) const
+    {
+        return value % 2 != 0;
+    }
+};
+
+} // namespace
+
+TEST(Toolbox, Generator)
+{
+    using Input = std::vector<int>;
+    {
+        auto generator = count(4);
+        auto result = Input{};
+        for (auto value : generator)
+        {
+            result.push_back(value);
+        }
+        EXPECT_EQ((Input{0, 1, 2, 3}), result);
+    }
+    {
+        auto generator = words();
+        auto result = std::vector<std::string>{};
+        std::copy(generator.begin(), generator.end(),
+                  std::back_inserter(result));
+        EXPECT_EQ((std::vector<std::string>{"alpha", "beta"}), result);
+    }
+    {
+        using Iterator = toolbox::Generator<int>::iterator;
+        using Filter = toolbox::IteratorFilter<IsOdd, Iterator>;
+        using Transformer = toolbox::IteratorTransformer<Double, Filter>;
+        auto generator = count(6);
+        auto end = generator.end();
+        auto begin = Transformer(Filter(generator.begin(), end));
+        auto result = Input{};
+        std::copy(begin, Transformer(Filter(end, end)),
+                  std::back_inserter(result));
+        EXPECT_EQ((Input{2, 6, 10}), result);
+    }
+    {
+        using Recorder =
+            toolbox::IteratorRecorder<toolbox::Generator<int>::iterator>;
+        auto generator = count(3);
+        auto recorder = Recorder(generator.begin());
+        EXPECT_EQ(0, *recorder);
+        EXPECT_EQ(1, *(++recorder));
+        EXPECT_EQ(0, *(--recorder));
+    }
+    {
+        auto generator = fail();
+        auto it = generator.begin();
+        EXPECT_EQ(1, *it);
+        EXPECT_THROW(++it, std::runtime_error);
+        EXPECT_EQ(generator.end(), it);
+    }
+    {
+        auto generator = toolbox::Generator<int>();
+        EXPECT_EQ(generator.end(), generator.begin());
+    }
+}
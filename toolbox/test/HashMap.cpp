@@ -1,6 +1,9 @@
 #include "HashMap.h"
 #include "gtest/gtest.h"
 #include <algorithm>
+#include <iterator>
+#include <numeric>
+#include <vector>
 
 unsigned char CharHash::operator()(const std::string& input) const
 {
@@ -3,6 +3,9 @@
 #include <toolbox/HashMap.h>
 #include <string>
 
+namespace
+{
+
 struct CharHash
 {
     using result_type = unsigned char;
@@ -12,3 +15,5 @@ struct CharHash
 };
 
 using hash_map_t = toolbox::HashMap<std::string, CharHash>;
+
+} // namespace
@@ -0,0 +1,86 @@
+#include "gtest/gtest.h"
+#include <map>
+#include <string>
+#include <thread>
+#include <toolbox/InternTable.h>
+#include <unordered_set>
+#include <vector>
+
+TEST(Toolbox, InternTable)
+{
+    using Config = std::vector<std::string>;
+    struct ConfigHash
+    {
+        std::size_t operator()(const Config& config) const
+        {
+            auto result = std::size_t(0);
+            for (const auto& entry : config)
+            {
+                result = result * 31 + std::hash<std::string>()(entry);
+            }
+            return result;
+        }
+    };
+    {
+        auto table = toolbox::InternTable<Config, ConfigHash>(4);
+        auto config = Config{"host=a", "port=1"};
+        auto a = table.intern(config);
+        auto b = table.intern(Config(config));
+        auto c = table.emplace(1, "host=b");
+        EXPECT_EQ(a, b);
+        EXPECT_EQ(a.get(), b.get());
+        EXPECT_NE(a, c);
+        EXPECT_EQ(config, *a);
+        EXPECT_EQ("host=b", c->front());
+        EXPECT_EQ(2u, table.size());
+        auto found = table.find(config);
+        ASSERT_TRUE(found);
+        EXPECT_EQ(a, *found);
+        EXPECT_FALSE(table.find(Config{"port=2"}));
+
+        /** Values hash by identity, so sets of them never compare configs */
+        auto set = std::unordered_set<decltype(a)>{a, b, c};
+        EXPECT_EQ(2u, set.size());
+
+        set.clear();
+        c = decltype(c)();
+        EXPECT_EQ(1u, table.collect());
+        EXPECT_EQ(1u, table.size());
+        EXPECT_EQ(a, table.intern(config));
+    }
+    {
+        /** Threads interning overlapping objects share one of each */
+        auto table = toolbox::InternTable<std::string>();
+        auto results =
+            std::vector<std::vector<toolbox::Value<std::shared_ptr<
+                const std::string>>>>(8);
+        auto threads = std::vector<std::thread>();
+        for (auto t = 0u; t < results.size(); ++t)
+        {
+            threads.emplace_back([&table, &result = results[t], t] {
+                for (auto i = 0u; i < 1000; ++i)
+                {
+                    result.push_back(
+                        table.intern(std::to_string((i * 7 + t) % 500)));
+                }
+            });
+        }
+        for (auto& thread : threads)
+        {
+            thread.join();
+        }
+        EXPECT_EQ(500u, table.size());
+        auto canonical = std::map<std::string, const std::string*>();
+        for (const auto& result : results)
+        {
+            for (const auto& value : result)
+            {
+                auto [it, inserted] = canonical.emplace(*value, value.get());
+                EXPECT_EQ(it->second, value.get());
+            }
+        }
+        EXPECT_EQ(0u, table.collect());
+        results.clear();
+        EXPECT_EQ(500u, table.collect());
+    }
+}
@@ -0,0 +1,177 @@
+#include "gtest/gtest.h"
+#include <thread>
+#include <toolbox/IntrusivePointer.h>
+#include <toolbox/Value.h>
+#include <unordered_set>
+#include <vector>
+
+namespace
+{
+
+struct Node : toolbox::RefCounted<Node>
+{
+    static inline int instances = 0;
+
+    explicit Node(int id) : id(id)
+    {
+        ++instances;
+    }
+
+    /** Virtual, since RefCounted<Node> deletes Leafs as Nodes */
+    virtual ~Node()
+    {
+        --instances;
+    }
+
+    int id;
+    std::vector<toolbox::IntrusivePointer<Node>> children;
+};
+
+struct Leaf : Node
+{
+    static inline int destroyed = 0;
+
+    Leaf() : Node(-1)
+    {
+    }
+
+    ~Leaf()
+    {
+        ++destroyed;
+    }
+};
+
+/** Deleted as a Flat, so a class derived from it couldn't be counted */
+struct Flat : toolbox::RefCounted<Flat>
+{
+};
+
+struct Deeper : Flat
+{
+};
+
+struct Local : toolbox::RefCounted<Local, false>
+{
+    int value = 5;
+};
+
+/** A user handle, which resolves an index into a table */
+struct Handle
+{
+    using element_type = int;
+
+    int& operator*() const
+    {
+        return (*table)[index];
+    }
+
+    std::vector<int>* table;
+    std::size_t index;
+};
+
+} // namespace
+
+template <>
+struct toolbox::enable_smart_pointer<Handle> : std::true_type
+{
+};
+
+TEST(Toolbox, IntrusivePointer)
+{
+    static_assert(sizeof(toolbox::IntrusivePointer<Node>) == sizeof(Node*));
+    static_assert(toolbox::detail::is_intrusively_deletable<Leaf>::value);
+    static_assert(toolbox::detail::is_intrusively_deletable<Flat>::value);
+    static_assert(!toolbox::detail::is_intrusively_deletable<Deeper>::value);
+    {
+        auto root = toolbox::makeIntrusivePointer<Node>(0);
+        EXPECT_EQ(1u, root->use_count());
+        auto child = toolbox::makeIntrusivePointer<Node>(1);
+        root->children.push_back(child);
+        root->children.push_back(child);
+        EXPECT_EQ(3u, child->use_count());
+        /** Another pointer to the same object shares its count */
+        auto again = toolbox::IntrusivePointer<Node>(child.get());
+        EXPECT_EQ(4u, child->use_count());
+        EXPECT_EQ(again, child);
+        child.reset();
+        again = nullptr;
+        EXPECT_EQ(2u, root->children[0]->use_count());
+        EXPECT_EQ(2, Node::instances);
+
+        toolbox::IntrusivePointer<Node> leaf =
+            toolbox::makeIntrusivePointer<Leaf>();
+        EXPECT_EQ(-1, leaf->id);
+        auto moved = std::move(leaf);
+        EXPECT_FALSE(leaf);
+        EXPECT_TRUE(leaf == nullptr);
+        EXPECT_EQ(1u, moved->use_count());
+
+        auto set = std::unordered_set<toolbox::IntrusivePointer<Node>>{
+            root, root->children[0], root->children[1], moved};
+        EXPECT_EQ(3u, set.size());
+        EXPECT_EQ(3, Node::instances);
+    }
+    EXPECT_EQ(0, Node::instances);
+    {
+        /** A Leaf held only as a Leaf is still deleted as one */
+        auto destroyed = Leaf::destroyed;
+        auto leaf = toolbox::makeIntrusivePointer<Leaf>();
+        auto other = leaf;
+        EXPECT_EQ(2u, leaf->use_count());
+        leaf.reset();
+        EXPECT_EQ(destroyed, Leaf::destroyed);
+        other.reset();
+        EXPECT_EQ(destroyed + 1, Leaf::destroyed);
+        EXPECT_EQ(0, Node::instances);
+    }
+    {
+        /** Value holds intrusive pointers and compares them by address */
+        auto node = toolbox::makeIntrusivePointer<Node>(7);
+        auto a = toolbox::Value<toolbox::IntrusivePointer<Node>>(node);
+        auto b = a;
+        EXPECT_EQ(a, b);
+        EXPECT_EQ(7, a->id);
+        EXPECT_EQ(3u, node->use_count());
+        auto c = toolbox::Value<toolbox::IntrusivePointer<Node>>(
+            toolbox::makeIntrusivePointer<Node>(7));
+        EXPECT_NE(a, c);
+        EXPECT_EQ(a < c, node.get() < c.get());
+
+        auto local = toolbox::Value<toolbox::IntrusivePointer<Local>>(
+            toolbox::makeIntrusivePointer<Local>());
+        EXPECT_EQ(5, local->value);
+        EXPECT_EQ(1u, local->use_count());
+    }
+    EXPECT_EQ(0, Node::instances);
+    {
+        /** Threads sharing a node agree on its count */
+        auto node = toolbox::makeIntrusivePointer<Node>(0);
+        auto threads = std::vector<std::thread>();
+        for (auto t = 0; t < 4; ++t)
+        {
+            threads.emplace_back([node] {
+                auto copies = std::vector<toolbox::IntrusivePointer<Node>>();
+                for (auto i = 0; i < 1000; ++i)
+                {
+                    copies.push_back(node);
+                }
+            });
+        }
+        for (auto& thread : threads)
+        {
+            thread.join();
+        }
+        EXPECT_EQ(1u, node->use_count());
+    }
+    EXPECT_EQ(0, Node::instances);
+    {
+        /** User handles and raw pointers dereference too */
+        auto table = std::vector<int>{1, 2, 3};
+        auto handle = toolbox::Value<Handle>(Handle{&table, 1});
+        EXPECT_EQ(2, *handle);
+        *handle = 4;
+        EXPECT_EQ(4, table[1]);
+        auto raw = toolbox::Value<int*>(&table[2]);
+        EXPECT_EQ(3, *raw);
+    }
+}
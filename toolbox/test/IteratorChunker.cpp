@@ -0,0 +1,54 @@
+#include "gtest/gtest.h"
+#include <numeric>
+#include <toolbox/IteratorChunker.h>
+#include <toolbox/IteratorTransformer.h>
+#include <vector>
+
+namespace
+{
+
+struct Sum
+{
+    template <typename Range>
+    int operator()(const Range& range) const
+    {
+        return std::accumulate(range.begin(), range.end(), 0);
+    }
+};
+
+} // namespace
+
+TEST(Toolbox, IteratorChunker)
+{
+    using Input = std::vector<int>;
+    using Chunker = toolbox::IteratorChunker<Input::const_iterator>;
+    auto input = Input{1, 2, 3, 4, 5, 6, 7};
+    {
+        auto it = Chunker(input.cbegin(), input.cend(), 3);
+        auto end = Chunker(input.cend(), input.cend(), 3);
+        auto chunk = *it;
+        EXPECT_EQ(input.cbegin(), chunk.begin());
+        EXPECT_EQ(std::next(input.cbegin(), 3), chunk.end());
+        auto sizes = std::vector<std::ptrdiff_t>{};
+        for (; it != end; ++it)
+        {
+            sizes.push_back(std::distance((*it).begin(), (*it).end()));
+        }
+        EXPECT_EQ((std::vector<std::ptrdiff_t>{3, 3, 1}), sizes);
+    }
+    {
+        using Transformer = toolbox::IteratorTransformer<Sum, Chunker>;
+        auto begin = Transformer(Chunker(input.cbegin(), input.cend(), 2));
+        auto end = Transformer(Chunker(input.cend(), input.cend(), 2));
+        auto result = Input{};
+        std::copy(begin, end, std::back_inserter(result));
+        EXPECT_EQ((Input{3, 7, 11, 7}), result);
+    }
+    {
+        /** A size of 0 would never reach the end, so batches by 1 */
+        using Transformer = toolbox::IteratorTransformer<Sum, Chunker>;
+        auto begin = Transformer(Chunker(input.cbegin(), input.cend(), 0));
+        auto end = Transformer(Chunker(input.cend(), input.cend(), 0));
+        EXPECT_EQ(input, Input(begin, end));
+    }
+}
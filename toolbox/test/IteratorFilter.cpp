@@ -0,0 +1,59 @@
+#include "gtest/gtest.h"
+#include <toolbox/IteratorFilter.h>
+#include <toolbox/IteratorTransformer.h>
+#include <vector>
+
+namespace
+{
+
+struct IsEven
+{
+    bool operator()(int value) const
+    {
+        return value % 2 == 0;
+    }
+};
+
+struct Square
+{
+    int operator()(int value) const
+    {
+        return value * value;
+    }
+};
+
+} // namespace
+
+TEST(Toolbox, IteratorFilter)
+{
+    using Input = std::vector<int>;
+    using Filter = toolbox::IteratorFilter<IsEven, Input::const_iterator>;
+    auto input = Input{1, 2, 3, 4, 5, 6, 7};
+    {
+        auto begin = Filter(input.cbegin(), input.cend());
+        auto end = Filter(input.cend(), input.cend());
+        EXPECT_EQ(2, *begin);
+        EXPECT_EQ(std::next(input.cbegin()), begin.get());
+        auto result = Input{};
+        std::copy(begin, end, std::back_inserter(result));
+        EXPECT_EQ((Input{2, 4, 6}), result);
+    }
+    {
+        using Transformer = toolbox::IteratorTransformer<Square, Filter>;
+        auto begin = Transformer(Filter(input.cbegin(), input.cend()));
+        auto end = Transformer(Filter(input.cend(), input.cend()));
+        auto result = Input{};
+        std::copy(begin, end, std::back_inserter(result));
+        EXPECT_EQ((Input{4, 16, 36}), result);
+    }
+    {
+        auto odd = [](int value) { return value % 2 != 0; };
+        auto begin = toolbox::makeIteratorFilter(input.cbegin(), input.cend(),
+                                                 odd);
+        auto end = toolbox::makeIteratorFilter(input.cend(), input.cend(),
+                                               odd);
+        auto result = Input{};
+        std::copy(begin, end, std::back_inserter(result));
+        EXPECT_EQ((Input{1, 3, 5, 7}), result);
+    }
+}
@@ -0,0 +1,40 @@
+#include "gtest/gtest.h"
+#include <toolbox/Iterator.h>
+#include <toolbox/IteratorFlattener.h>
+#include <vector>
+
+TEST(Toolbox, IteratorFlattener)
+{
+    using Input = std::vector<int>;
+    {
+        using Nested = std::vector<Input>;
+        auto input = Nested{{1, 2}, {}, {3}, {}, {4, 5, 6}, {}};
+        auto identity = [](const Input& value) -> const Input& {
+            return value;
+        };
+        auto begin = toolbox::makeIteratorFlattener(input.cbegin(),
+                                                    input.cend(), identity);
+        auto end = toolbox::makeIteratorFlattener(input.cend(), input.cend(),
+                                                  identity);
+        EXPECT_EQ(1, *begin);
+        auto result = Input{};
+        std::copy(begin, end, std::back_inserter(result));
+        EXPECT_EQ((Input{1, 2, 3, 4, 5, 6}), result);
+    }
+    {
+        /** Map each length to the prefix of a buffer of that length */
+        auto buffer = Input{7, 8, 9};
+        auto lengths = Input{2, 0, 3};
+        auto prefix = [&buffer](int length) {
+            return toolbox::makeRange(buffer.cbegin(),
+                                      std::next(buffer.cbegin(), length));
+        };
+        auto begin = toolbox::makeIteratorFlattener(lengths.cbegin(),
+                                                    lengths.cend(), prefix);
+        auto end = toolbox::makeIteratorFlattener(lengths.cend(),
+                                                  lengths.cend(), prefix);
+        auto result = Input{};
+        std::copy(begin, end, std::back_inserter(result));
+        EXPECT_EQ((Input{7, 8, 7, 8, 9}), result);
+    }
+}
@@ -0,0 +1,27 @@
+#include "gtest/gtest.h"
+#include <toolbox/Iterator.h>
+#include <toolbox/IteratorLimiter.h>
+#include <vector>
+
+TEST(Toolbox, IteratorLimiter)
+{
+    using Input = std::vector<int>;
+    auto input = Input{1, 2, 3, 10, 4, 5};
+    auto small = [](int value) { return value < 10; };
+    {
+        auto begin = toolbox::makeIteratorLimiter(input.cbegin(), input.cend(),
+                                                  small);
+        auto end = toolbox::makeIteratorLimiter(input.cend(), input.cend(),
+                                                small);
+        auto result = Input{};
+        std::copy(begin, end, std::back_inserter(result));
+        EXPECT_EQ((Input{1, 2, 3}), result);
+    }
+    {
+        auto begin = toolbox::dropWhile(input.cbegin(), input.cend(), small);
+        EXPECT_EQ(10, *begin);
+        auto result = Input{};
+        std::copy(begin, input.cend(), std::back_inserter(result));
+        EXPECT_EQ((Input{10, 4, 5}), result);
+    }
+}
@@ -0,0 +1,31 @@
+#include "gtest/gtest.h"
+#include <toolbox/IteratorStrider.h>
+#include <vector>
+
+TEST(Toolbox, IteratorStrider)
+{
+    using Input = std::vector<int>;
+    using Strider = toolbox::IteratorStrider<Input::const_iterator>;
+    auto input = Input{0, 1, 2, 3, 4, 5, 6, 7};
+    {
+        auto begin = Strider(input.cbegin(), input.cend(), 3);
+        auto end = Strider(input.cend(), input.cend(), 3);
+        auto result = Input{};
+        std::copy(begin, end, std::back_inserter(result));
+        EXPECT_EQ((Input{0, 3, 6}), result);
+    }
+    {
+        auto begin = toolbox::makeIteratorStrider(input.cbegin(), input.cend(),
+                                                  2);
+        auto end = toolbox::makeIteratorStrider(input.cend(), input.cend(), 2);
+        auto result = Input{};
+        std::copy(begin, end, std::back_inserter(result));
+        EXPECT_EQ((Input{0, 2, 4, 6}), result);
+    }
+    {
+        /** A stride of 0 would never reach the end, so steps by 1 */
+        auto begin = Strider(input.cbegin(), input.cend(), 0);
+        auto end = Strider(input.cend(), input.cend(), 0);
+        EXPECT_EQ(input, Input(begin, end));
+    }
+}
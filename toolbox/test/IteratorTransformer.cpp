@@ -35,4 +35,35 @@ TEST(Toolbox, IteratorTransformer)
         std::copy(begin, end, std::back_inserter(result));
         EXPECT_EQ(output, result);
     }
+    {
+        using Input = std::vector<int>;
+        using Output = std::vector<std::string>;
+        using Iterator = Input::const_iterator;
+        using Inner = toolbox::IteratorTransformer<Transform, Iterator>;
+        using Middle = toolbox::IteratorTransformer<Transform, Inner>;
+        using Outer = toolbox::IteratorTransformer<Transform, Middle>;
+        using Fused = toolbox::IteratorTransformer<
+            toolbox::Composition<toolbox::Composition<Transform, Transform>,
+                                 Transform>,
+            Iterator>;
+        static_assert(std::is_same<Fused, decltype(toolbox::fuse(
+                                              std::declval<Outer>()))>::value,
+                      "nested transformers are not fused");
+        auto input = Input{1, 2, 3, 4};
+        auto output = Output{"10", "20", "30", "40"};
+        auto nested_begin = Outer(Middle(Inner(input.cbegin())));
+        auto nested_end = Outer(Middle(Inner(input.cend())));
+        auto begin = toolbox::fuse(nested_begin);
+        auto end = toolbox::fuse(nested_end);
+        EXPECT_EQ(input.cbegin(), begin.get());
+        EXPECT_EQ("10", *begin);
+        auto result = Output{};
+        std::copy(begin, end, std::back_inserter(result));
+        EXPECT_EQ(output, result);
+        auto middle = Middle(Inner(input.cbegin()));
+        auto it = toolbox::makeIteratorTransformer(middle, Transform());
+        EXPECT_EQ(input.cbegin(), it.get());
+        EXPECT_EQ("10", *it);
+        EXPECT_EQ("20", *(++it));
+    }
 }
@@ -0,0 +1,25 @@
+#include "gtest/gtest.h"
+#include <string>
+#include <toolbox/IteratorZipper.h>
+#include <vector>
+
+TEST(Toolbox, IteratorZipper)
+{
+    using Numbers = std::vector<int>;
+    using Names = std::vector<std::string>;
+    auto numbers = Numbers{1, 2, 3, 4};
+    auto names = Names{"one", "two", "three"};
+    auto begin = toolbox::makeIteratorZipper(numbers.begin(), names.cbegin());
+    auto end = toolbox::makeIteratorZipper(numbers.end(), names.cend());
+    EXPECT_EQ(1, std::get<0>(*begin));
+    EXPECT_EQ("one", std::get<1>(*begin));
+    auto result = std::vector<std::string>{};
+    for (auto it = begin; it != end; ++it)
+    {
+        auto value = *it;
+        std::get<0>(value) *= 10;
+        result.push_back(std::get<1>(value));
+    }
+    EXPECT_EQ((Names{"one", "two", "three"}), result);
+    EXPECT_EQ((Numbers{10, 20, 30, 4}), numbers);
+}
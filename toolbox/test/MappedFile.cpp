@@ -0,0 +1,31 @@
+#include "gtest/gtest.h"
+#include <filesystem>
+#include <fstream>
+#include <system_error>
+#include <toolbox/MappedFile.h>
+
+TEST(Toolbox, MappedFile)
+{
+    auto path = std::filesystem::temp_directory_path() / "toolbox_mapped_file";
+    {
+        std::ofstream(path) << "hello\nworld";
+    }
+    {
+        auto file = toolbox::MappedFile(path.string());
+        EXPECT_EQ(11u, file.size());
+        EXPECT_EQ("hello\nworld", file.view());
+        EXPECT_EQ(std::byte('h'), file.bytes()[0]);
+        file.advise(toolbox::MappedFile::Advice::random);
+        auto moved = std::move(file);
+        EXPECT_TRUE(file.empty());
+        EXPECT_EQ("hello\nworld", moved.view());
+    }
+    {
+        std::ofstream(path, std::ios::trunc);
+        auto file = toolbox::MappedFile(path.string());
+        EXPECT_TRUE(file.empty());
+        EXPECT_EQ("", file.view());
+    }
+    std::filesystem::remove(path);
+    EXPECT_THROW(toolbox::MappedFile(path.string()), std::system_error);
+}
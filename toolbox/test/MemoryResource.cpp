@@ -0,0 +1,135 @@
+#include "gtest/gtest.h"
+#include <cstdint>
+#include <memory_resource>
+#include <string>
+#include <toolbox/HashMap.h>
+#include <toolbox/IteratorRecorder.h>
+#include <toolbox/MemoryResource.h>
+#include <toolbox/Value.h>
+#include <vector>
+
+namespace
+{
+
+class CountingResource : public std::pmr::memory_resource
+{
+public:
+    std::size_t allocations = 0;
+    std::size_t outstanding = 0;
+
+private:
+    void* do_allocate(std::size_t bytes, std::size_t alignment) override
+    {
+        ++allocations;
+        ++outstanding;
+        return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+    }
+
+    void do_deallocate(void* p,
+                       std::size_t bytes,
+                       std::size_t alignment) override
+    {
+        --outstanding;
+        std::pmr::new_delete_resource()->deallocate(p, bytes, alignment);
+    }
+
+    bool do_is_equal(const memory_resource& other) const noexcept override
+    {
+        return this == &other;
+    }
+};
+
+bool aligned(const void* pointer, std::size_t alignment)
+{
+    return reinterpret_cast<std::uintptr_t>(pointer) % alignment == 0;
+}
+
+} // namespace
+
+TEST(Toolbox, MemoryResource)
+{
+    auto counting = CountingResource();
+    {
+        auto arena = toolbox::ArenaResource(256, &counting);
+        auto a = arena.allocate(3, 1);
+        auto b = arena.allocate(8, 64);
+        EXPECT_TRUE(aligned(b, 64));
+        EXPECT_GT(static_cast<char*>(b), static_cast<char*>(a));
+        auto big = arena.allocate(1000, 8);
+        EXPECT_TRUE(aligned(big, 8));
+        EXPECT_EQ(2u, counting.allocations);
+        EXPECT_EQ(1011u, arena.allocated());
+        /** Once reset, the same work fits in the one chunk it keeps */
+        arena.reset();
+        EXPECT_EQ(1u, counting.outstanding);
+        EXPECT_EQ(0u, arena.allocated());
+        for (auto round = 0; round < 2; ++round)
+        {
+            EXPECT_NE(nullptr, arena.allocate(3, 1));
+            EXPECT_TRUE(aligned(arena.allocate(8, 64), 64));
+            EXPECT_NE(nullptr, arena.allocate(1000, 8));
+            arena.reset();
+        }
+        EXPECT_EQ(3u, counting.allocations);
+        EXPECT_EQ(1u, counting.outstanding);
+        arena.release();
+        EXPECT_EQ(0u, counting.outstanding);
+        EXPECT_EQ(0u, arena.capacity());
+    }
+    {
+        char buffer[64];
+        auto arena = toolbox::ArenaResource(buffer, sizeof(buffer), &counting);
+        auto a = static_cast<char*>(arena.allocate(32, 8));
+        EXPECT_TRUE(a >= buffer && a < buffer + sizeof(buffer));
+        EXPECT_NE(nullptr, arena.allocate(64, 8));
+        EXPECT_EQ(1u, counting.outstanding);
+    }
+    EXPECT_EQ(0u, counting.outstanding);
+    counting.allocations = 0;
+    {
+        auto pool = toolbox::PoolResource(20, 4, &counting);
+        EXPECT_EQ(32u, pool.block_size());
+        auto blocks = std::vector<void*>();
+        for (auto i = 0; i < 5; ++i)
+        {
+            blocks.push_back(pool.allocate(24, 8));
+            EXPECT_TRUE(aligned(blocks.back(), alignof(std::max_align_t)));
+        }
+        EXPECT_EQ(2u, counting.allocations);
+        EXPECT_EQ(5u, pool.used());
+        pool.deallocate(blocks[1], 24, 8);
+        EXPECT_EQ(blocks[1], pool.allocate(16, 8));
+        auto large = pool.allocate(100, 8);
+        EXPECT_EQ(3u, counting.allocations);
+        pool.deallocate(large, 100, 8);
+        EXPECT_EQ(2u, counting.outstanding);
+    }
+    EXPECT_EQ(0u, counting.outstanding);
+    counting.allocations = 0;
+    {
+        /** A whole request's structures, allocated from one arena */
+        auto arena = toolbox::ArenaResource(1024, &counting);
+        auto map = toolbox::pmr::HashMap<std::string>(&arena);
+        auto values = std::pmr::vector<toolbox::Value<std::pmr::string>>(
+            &arena);
+        for (auto i = 0; i < 100; ++i)
+        {
+            auto text = std::string(40, static_cast<char>('a' + i % 26)) +
+                        std::to_string(i);
+            map.insert(text);
+            values.emplace_back(std::pmr::string(text));
+        }
+        EXPECT_EQ(100u, map.size());
+        EXPECT_EQ(&arena, map.get_allocator().resource());
+        EXPECT_EQ(&arena, values[99]->get_allocator().resource());
+        EXPECT_EQ('v', (*values[99])[0]);
+
+        auto input = std::vector<int>{1, 2, 3};
+        auto recorder = toolbox::IteratorRecorder<std::vector<int>::iterator>(
+            input.begin(), arena);
+        ++recorder;
+        EXPECT_EQ(1, *--recorder);
+        EXPECT_LE(counting.allocations, 8u);
+    }
+    EXPECT_EQ(0u, counting.outstanding);
+}
@@ -0,0 +1,110 @@
+#include "gtest/gtest.h"
+#include <algorithm>
+#include <random>
+#include <string>
+#include <toolbox/MultiSequencePredicate.h>
+#include <vector>
+
+TEST(Toolbox, MultiSequencePredicate)
+{
+    using Matches = std::vector<std::size_t>;
+    auto matches = [](const auto& predicate) {
+        auto found = predicate.matches();
+        return Matches(found.begin(), found.end());
+    };
+    {
+        auto paths = std::vector<std::vector<std::string>>{
+            {"/", "home"}, {"home", "/", "user"}, {"/", "user"}};
+        auto predicate = toolbox::makeMultiSequencePredicate(paths);
+        EXPECT_EQ(3u, predicate.size());
+        EXPECT_FALSE(predicate("/"));
+        EXPECT_TRUE(predicate.advanced());
+        EXPECT_EQ((Matches{0, 2}), predicate.advancing());
+        EXPECT_TRUE(predicate("home"));
+        EXPECT_EQ(Matches{0}, matches(predicate));
+        EXPECT_EQ(2u, predicate.depth());
+        /** Shorter partial matches count as well as the longest */
+        EXPECT_EQ((Matches{0, 1}), predicate.advancing());
+        EXPECT_FALSE(predicate("/"));
+        EXPECT_EQ((Matches{0, 1, 2}), predicate.advancing());
+        EXPECT_TRUE(predicate("user"));
+        EXPECT_EQ((Matches{1, 2}), matches(predicate));
+        EXPECT_FALSE(predicate("etc"));
+        EXPECT_FALSE(predicate.advanced());
+        EXPECT_TRUE(predicate.advancing().empty());
+        EXPECT_TRUE(predicate.dense());
+        predicate("/");
+        predicate.reset();
+        EXPECT_FALSE(predicate("home"));
+        EXPECT_EQ(1u, predicate.depth());
+    }
+    {
+        /** The classic example, whose matches overlap */
+        for (auto limit : {std::size_t(1) << 20, std::size_t(0)})
+        {
+            auto predicate = toolbox::MultiSequencePredicate<char>(limit);
+            for (auto word : {"he", "she", "his", "hers"})
+            {
+                predicate.add(std::string(word));
+            }
+            auto found = std::vector<Matches>();
+            for (auto c : std::string("ushers"))
+            {
+                predicate(c);
+                found.push_back(matches(predicate));
+            }
+            EXPECT_EQ((std::vector<Matches>{{}, {}, {}, {1, 0}, {}, {3}}),
+                      found);
+            EXPECT_EQ(limit != 0, predicate.dense());
+        }
+    }
+    {
+        /** Dense and sparse agree with a naive search */
+        auto random = std::mt19937(3);
+        auto letters = std::uniform_int_distribution<int>('a', 'c');
+        auto words = std::vector<std::string>();
+        for (auto i = 0; i < 50; ++i)
+        {
+            words.emplace_back(1 + random() % 5, 'a');
+            for (auto& c : words.back())
+            {
+                c = static_cast<char>(letters(random));
+            }
+        }
+        auto dense = toolbox::MultiSequencePredicate<char>(words);
+        auto sparse = toolbox::MultiSequencePredicate<char>(words, 0);
+        auto text = std::string();
+        for (auto i = 0; i < 2000; ++i)
+        {
+            text += static_cast<char>(letters(random) + (i % 97 == 0));
+            dense(text.back());
+            sparse(text.back());
+            auto expected = Matches();
+            for (std::size_t w = 0; w < words.size(); ++w)
+            {
+                if (text.ends_with(words[w]))
+                {
+                    expected.push_back(w);
+                }
+            }
+            auto a = matches(dense);
+            auto b = matches(sparse);
+            std::sort(a.begin(), a.end());
+            std::sort(b.begin(), b.end());
+            ASSERT_EQ(expected, a);
+            ASSERT_EQ(expected, b);
+        }
+    }
+    {
+        /** An empty sequence matches every input, and sequences can be
+         * added after matching has begun */
+        auto predicate = toolbox::MultiSequencePredicate<int>();
+        predicate.add(std::vector<int>());
+        EXPECT_TRUE(predicate(1));
+        EXPECT_EQ(Matches{0}, matches(predicate));
+        predicate.add(std::vector<int>{1, 2});
+        EXPECT_TRUE(predicate(1));
+        EXPECT_TRUE(predicate(2));
+        EXPECT_EQ((Matches{1, 0}), matches(predicate));
+    }
+}
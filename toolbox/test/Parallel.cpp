@@ -0,0 +1,35 @@
+#include "gtest/gtest.h"
+#include <numeric>
+#include <stdexcept>
+#include <toolbox/Parallel.h>
+#include <vector>
+
+TEST(Toolbox, Parallel)
+{
+    auto input = std::vector<int>(10000);
+    std::iota(input.begin(), input.end(), 0);
+    auto square = [](int value) { return value * value; };
+    {
+        auto output = std::vector<int>(input.size());
+        auto end = toolbox::parallelTransform(input.begin(), input.end(),
+                                              output.begin(), square, 100);
+        EXPECT_EQ(output.end(), end);
+        for (auto i = 0u; i < input.size(); ++i)
+        {
+            EXPECT_EQ(square(input[i]), output[i]);
+        }
+    }
+    {
+        auto output = std::vector<int>(input.size());
+        auto fail = [](int value) {
+            if (value == 9999)
+            {
+                throw std::runtime_error("fail");
+            }
+            return value;
+        };
+        EXPECT_THROW(toolbox::parallelTransform(input.begin(), input.end(),
+                                                output.begin(), fail, 100),
+                     std::runtime_error);
+    }
+}
@@ -0,0 +1,137 @@
+#include "gtest/gtest.h"
+#include <array>
+#include <memory>
+#include <stdexcept>
+#include <toolbox/PolymorphicValue.h>
+#include <toolbox/Value.h>
+#include <type_traits>
+#include <vector>
+
+namespace
+{
+
+struct Shape
+{
+    static inline int instances = 0;
+
+    Shape()
+    {
+        ++instances;
+    }
+
+    Shape(const Shape&) noexcept
+    {
+        ++instances;
+    }
+
+    virtual ~Shape()
+    {
+        --instances;
+    }
+
+    virtual double area() const = 0;
+};
+
+struct Square : Shape
+{
+    explicit Square(double side) : side(side)
+    {
+    }
+
+    double area() const override
+    {
+        return side * side;
+    }
+
+    double side;
+};
+
+/** Too big to hold inline */
+struct Polygon : Shape
+{
+    double area() const override
+    {
+        return points[0];
+    }
+
+    std::array<double, 16> points = {2};
+};
+
+struct Owned : Shape
+{
+    double area() const override
+    {
+        return *side;
+    }
+
+    std::unique_ptr<double> side = std::make_unique<double>(3);
+};
+
+} // namespace
+
+TEST(Toolbox, PolymorphicValue)
+{
+    using Value = toolbox::PolymorphicValue<Shape>;
+    static_assert(sizeof(Value) == 64);
+    static_assert(Value::fits_inline<Square>);
+    static_assert(!Value::fits_inline<Polygon>);
+    {
+        auto empty = Value();
+        EXPECT_FALSE(empty);
+        EXPECT_FALSE(empty.inlined());
+        EXPECT_EQ(nullptr, empty.get());
+
+        Value square = Square(2);
+        EXPECT_TRUE(square.inlined());
+        EXPECT_EQ(4, square->area());
+        auto copy = square;
+        static_cast<Square&>(*copy).side = 3;
+        EXPECT_EQ(4, square->area());
+        EXPECT_EQ(9, copy->area());
+
+        auto moved = std::move(copy);
+        EXPECT_FALSE(copy);
+        EXPECT_TRUE(moved.inlined());
+        EXPECT_EQ(9, moved->area());
+        EXPECT_EQ(static_cast<const void*>(moved.get()),
+                  static_cast<const void*>(&moved));
+
+        auto polygon = toolbox::makePolymorphicValue<Shape, Polygon>();
+        EXPECT_FALSE(polygon.inlined());
+        const auto* object = polygon.get();
+        auto stolen = std::move(polygon);
+        EXPECT_EQ(object, stolen.get());
+        EXPECT_EQ(2, stolen->area());
+        auto copied = stolen;
+        EXPECT_NE(object, copied.get());
+        EXPECT_EQ(2, copied->area());
+
+        moved = copied;
+        EXPECT_FALSE(moved.inlined());
+        copied = square;
+        EXPECT_TRUE(copied.inlined());
+        copied.emplace<Square>(5).side = 6;
+        EXPECT_EQ(36, copied->area());
+
+        Value owned = Owned();
+        EXPECT_EQ(3, owned->area());
+        EXPECT_THROW(Value{owned}, std::logic_error);
+        auto vector = std::vector<Value>();
+        vector.push_back(std::move(owned));
+        vector.emplace_back(Square(1));
+        vector.resize(100);
+        EXPECT_EQ(3, vector[0]->area());
+        EXPECT_EQ(1, vector[1]->area());
+    }
+    EXPECT_EQ(0, Shape::instances);
+    {
+        /** Constness is deep through Value too */
+        auto value = toolbox::Value<toolbox::PolymorphicValue<Shape>>(
+            toolbox::PolymorphicValue<Shape>(Square(3)));
+        EXPECT_EQ(9, value->area());
+        const auto& constant = value;
+        static_assert(std::is_same_v<const Shape*, decltype(constant.get())>);
+        EXPECT_EQ(9, (*constant).area());
+    }
+    EXPECT_EQ(0, Shape::instances);
+}
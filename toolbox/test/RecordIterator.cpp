@@ -0,0 +1,70 @@
+#include "gtest/gtest.h"
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <toolbox/IteratorTransformer.h>
+#include <toolbox/RecordIterator.h>
+#include <vector>
+
+namespace
+{
+
+struct Length
+{
+    std::size_t operator()(std::string_view value) const
+    {
+        return value.size();
+    }
+};
+
+} // namespace
+
+TEST(Toolbox, RecordIterator)
+{
+    using Records = std::vector<std::string_view>;
+    {
+        auto text = std::string(40, 'x') + "\n\nshort\nlast";
+        auto lines = toolbox::makeLineRange(text);
+        auto result = Records(lines.begin(), lines.end());
+        EXPECT_EQ((Records{std::string_view(text).substr(0, 40), "", "short",
+                           "last"}),
+                  result);
+        EXPECT_EQ(text.data(), result[0].data());
+    }
+    {
+        auto lines = toolbox::makeLineRange("a\nb\n");
+        EXPECT_EQ((Records{"a", "b"}), Records(lines.begin(), lines.end()));
+        EXPECT_TRUE(toolbox::makeLineRange("").empty());
+    }
+    {
+        using Transformer =
+            toolbox::IteratorTransformer<Length,
+                                         toolbox::DelimitedRecordIterator>;
+        auto fields = toolbox::makeDelimitedRange("one,three,,five", ',');
+        auto result = std::vector<std::size_t>();
+        std::copy(Transformer(fields.begin()), Transformer(fields.end()),
+                  std::back_inserter(result));
+        EXPECT_EQ((std::vector<std::size_t>{3, 5, 0, 4}), result);
+    }
+    {
+        auto values = std::vector<std::uint32_t>{1, 2, 3};
+        auto bytes = std::as_bytes(std::span<const std::uint32_t>(values));
+        auto records = toolbox::makeFixedRecordRange(
+            bytes.first(bytes.size() - 1), sizeof(std::uint32_t));
+        auto result = std::vector<std::uint32_t>();
+        for (auto record : records)
+        {
+            auto value = std::uint32_t();
+            std::memcpy(&value, record.data(), record.size());
+            result.push_back(value);
+        }
+        EXPECT_EQ((std::vector<std::uint32_t>{1, 2}), result);
+    }
+    {
+        auto text = std::string(100, 'a') + ";";
+        EXPECT_EQ(text.data() + 100,
+                  toolbox::findDelimiter(text.data(), text.data() + 101, ';'));
+        EXPECT_EQ(text.data() + 100,
+                  toolbox::findDelimiter(text.data(), text.data() + 100, ';'));
+    }
+}
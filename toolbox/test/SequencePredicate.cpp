@@ -1,5 +1,8 @@
 #include "gtest/gtest.h"
+#include <cctype>
+#include <string>
 #include <toolbox/SequencePredicate.h>
+#include <vector>
 
 TEST(Toolbox, SequencePredicate)
 {
@@ -32,3 +35,66 @@ TEST(Toolbox, SequencePredicate)
     EXPECT_TRUE(pred(std::make_pair(two, three)));
     EXPECT_TRUE(pred(std::make_pair(three, five)));
 }
+
+TEST(Toolbox, SequencePredicateStreaming)
+{
+    using Predicate =
+        toolbox::StreamingSequencePredicate<std::string::const_iterator>;
+    {
+        /** Overlapping occurrences are all found */
+        auto sequence = std::string("aa");
+        auto predicate = Predicate(sequence.cbegin(), sequence.cend());
+        auto results = std::vector<bool>();
+        for (auto c : std::string("aaab"))
+        {
+            results.push_back(predicate(c));
+        }
+        EXPECT_EQ((std::vector<bool>{false, true, true, false}), results);
+        EXPECT_FALSE(predicate.matched());
+        EXPECT_EQ(4u, predicate.position());
+        EXPECT_EQ(1u, predicate.match_position());
+        predicate.reset();
+        EXPECT_EQ(0u, predicate.position());
+        EXPECT_EQ(Predicate::npos, predicate.match_position());
+    }
+    {
+        /** A mismatch resumes from the longest partial match which remains
+         * possible, rather than from the start */
+        auto sequence = std::string("abab");
+        auto predicate = Predicate(sequence.cbegin(), sequence.cend());
+        for (auto c : std::string("ababa"))
+        {
+            predicate(c);
+        }
+        EXPECT_EQ(3u, predicate.progress());
+        EXPECT_TRUE(predicate('b'));
+        EXPECT_EQ(2u, predicate.match_position());
+        EXPECT_FALSE(predicate('b'));
+        EXPECT_EQ(0u, predicate.progress());
+    }
+    {
+        /** Agrees with a naive search, under a custom comparison */
+        auto sequence = std::string("aAbaa");
+        auto predicate = toolbox::makeStreamingSequencePredicate(
+            sequence.cbegin(), sequence.cend(), [](char lhs, char rhs) {
+                return std::tolower(lhs) < std::tolower(rhs);
+            });
+        auto input = std::string("aabaabaaabAABAaba");
+        for (std::size_t i = 0; i < input.size(); ++i)
+        {
+            auto end = i + 1;
+            auto expected = end >= sequence.size();
+            for (std::size_t j = 0; expected && j < sequence.size(); ++j)
+            {
+                expected = std::tolower(input[end - sequence.size() + j]) ==
+                           std::tolower(sequence[j]);
+            }
+            EXPECT_EQ(expected, predicate(input[i])) << i;
+        }
+    }
+    {
+        auto predicate = Predicate();
+        EXPECT_TRUE(predicate('x'));
+        EXPECT_EQ(1u, predicate.match_position());
+    }
+}
@@ -0,0 +1,108 @@
+#include "gtest/gtest.h"
+#include <cstdint>
+#include <random>
+#include <string>
+#include <toolbox/SequencePredicate.h>
+#include <toolbox/SequenceScan.h>
+#include <toolbox/Simd.h>
+#include <vector>
+
+namespace
+{
+
+template <typename T>
+std::vector<std::size_t> naiveScan(const std::vector<T>& input,
+                                   const std::vector<T>& sequence)
+{
+    auto result = std::vector<std::size_t>();
+    for (std::size_t i = 0; i + sequence.size() <= input.size(); ++i)
+    {
+        if (std::equal(sequence.begin(), sequence.end(), input.begin() + i))
+        {
+            result.push_back(i);
+        }
+    }
+    return result;
+}
+
+/** Scan random inputs over a few values, so that candidates are common,
+ * for sequences long and short, taken from the input so that they occur */
+template <typename T>
+void expectScansLikeNaive(std::mt19937& random)
+{
+    for (auto size : {0, 1, 15, 16, 17, 63, 200, 1000})
+    {
+        auto input = std::vector<T>(static_cast<std::size_t>(size));
+        for (auto& value : input)
+        {
+            /** Include values whose high bits are set */
+            value = static_cast<T>(random() % 3 * 0x41414141u);
+        }
+        for (std::size_t length : {1, 2, 3, 5, 17, 40})
+        {
+            auto sequence = std::vector<T>(length, T(0));
+            if (length <= input.size())
+            {
+                auto from = random() % (input.size() - length + 1);
+                sequence.assign(input.begin() + from,
+                                input.begin() + from + length);
+            }
+            auto result = toolbox::scanSequence(
+                std::span<const T>(input), std::span<const T>(sequence));
+            EXPECT_EQ(naiveScan(input, sequence), result)
+                << "size " << size << " length " << length << " value size "
+                << sizeof(T);
+        }
+    }
+}
+
+} // namespace
+
+TEST(Toolbox, SequenceScan)
+{
+    {
+        EXPECT_EQ((std::vector<std::size_t>{1, 4}),
+                  toolbox::scanSequence("abcabca", "bca"));
+        EXPECT_EQ((std::vector<std::size_t>{0, 1, 2}),
+                  toolbox::scanSequence("aaaa", "aa"));
+        EXPECT_EQ((std::vector<std::size_t>{0, 1, 2}),
+                  toolbox::scanSequence("ab", ""));
+        EXPECT_TRUE(toolbox::scanSequence("ab", "abc").empty());
+    }
+    {
+        auto detected = toolbox::detectSimdLevel();
+        auto random = std::mt19937(7);
+        for (auto level :
+             {toolbox::SimdLevel::scalar, toolbox::SimdLevel::ssse3,
+              toolbox::SimdLevel::avx2})
+        {
+            if (level > detected)
+            {
+                continue;
+            }
+            toolbox::simdLevel(level);
+            expectScansLikeNaive<std::uint8_t>(random);
+            expectScansLikeNaive<std::int16_t>(random);
+            expectScansLikeNaive<std::uint32_t>(random);
+        }
+        toolbox::simdLevel(detected);
+    }
+    {
+        /** Scanning agrees with feeding the stream, whether or not it can
+         * take the vectorised path */
+        auto input = std::vector<int>{1, 2, 1, 2, 1, 3, 1, 2, 1};
+        auto sequence = std::vector<int>{1, 2, 1};
+        auto predicate = toolbox::StreamingSequencePredicate(sequence.cbegin(),
+                                                             sequence.cend());
+        predicate(1);
+        EXPECT_EQ((std::vector<std::size_t>{0, 2, 6}), predicate.scan(input));
+        EXPECT_EQ(1u, predicate.position());
+        auto greater = toolbox::makeStreamingSequencePredicate(
+            sequence.cbegin(), sequence.cend(), std::greater<int>());
+        EXPECT_EQ((std::vector<std::size_t>{0, 2, 6}), greater.scan(input));
+        auto empty = toolbox::StreamingSequencePredicate(sequence.cend(),
+                                                         sequence.cend());
+        EXPECT_EQ((std::vector<std::size_t>{1, 2, 3}),
+                  empty.scan(std::span<const int>(input).first(3)));
+    }
+}
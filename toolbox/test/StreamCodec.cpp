@@ -0,0 +1,119 @@
+#include "gtest/gtest.h"
+#include <algorithm>
+#include <string>
+#include <string_view>
+#include <toolbox/BufferPool.h>
+#include <toolbox/Codec.h>
+#include <toolbox/StreamCodec.h>
+
+namespace
+{
+
+/** Encodes each byte as two hex digits, appending in place */
+struct HexEncoder
+{
+    void operator()(std::string_view input, std::string& output) const
+    {
+        static const char digits[] = "0123456789abcdef";
+        for (auto c : input)
+        {
+            auto byte = static_cast<unsigned char>(c);
+            output += digits[byte >> 4];
+            output += digits[byte & 0xf];
+        }
+    }
+
+    std::size_t max_size(std::size_t size) const
+    {
+        return 2 * size;
+    }
+};
+
+/** Decodes pairs of hex digits, returning a new string */
+struct HexDecoder
+{
+    std::string operator()(std::string_view input) const
+    {
+        auto value = [](char c) { return c <= '9' ? c - '0' : c - 'a' + 10; };
+        auto result = std::string();
+        for (std::size_t i = 0; i + 1 < input.size(); i += 2)
+        {
+            result += static_cast<char>(value(input[i]) << 4 |
+                                        value(input[i + 1]));
+        }
+        return result;
+    }
+};
+
+} // namespace
+
+TEST(Toolbox, StreamCodec)
+{
+    using namespace std::string_literals;
+    {
+        auto encoder = toolbox::makeChunkStream(HexEncoder());
+        EXPECT_EQ(8u, encoder.estimate(4));
+        auto output = std::string();
+        encoder.update("ab"s, output);
+        encoder.update("c"s, output);
+        encoder.finish(output);
+        EXPECT_EQ("616263", output);
+    }
+    {
+        /** Pieces which split a block are held back until it completes */
+        auto decoder = toolbox::makeChunkStream(HexDecoder(), 2);
+        auto output = std::string();
+        decoder.update("616"s, output);
+        EXPECT_EQ("a", output);
+        EXPECT_EQ(1u, decoder.pending());
+        decoder.update("2"s, output);
+        EXPECT_EQ(0u, decoder.pending());
+        decoder.update("63"s, output);
+        decoder.finish(output);
+        EXPECT_EQ("abc", output);
+    }
+    {
+        /** Whole-message functors see the concatenated input on finish */
+        auto reverse = [](std::string_view input) {
+            return std::string(input.rbegin(), input.rend());
+        };
+        auto stream = toolbox::makeMessageStream(reverse);
+        auto output = std::string();
+        stream.update("abc"s, output);
+        stream.update("def"s, output);
+        EXPECT_TRUE(output.empty());
+        EXPECT_EQ(6u, stream.pending());
+        stream.finish(output);
+        EXPECT_EQ("fedcba", output);
+        output.clear();
+        toolbox::process(stream, "xy"s, output);
+        EXPECT_EQ("yx", output);
+    }
+    {
+        /** Streams compose with Codec */
+        auto codec = makeCodec(toolbox::makeChunkStream(HexEncoder()),
+                               toolbox::makeChunkStream(HexDecoder(), 2));
+        auto encoded = std::string();
+        toolbox::process(codec.encoder(), "hello"s, encoded);
+        auto decoded = std::string();
+        toolbox::process(codec.decoder(), encoded, decoded);
+        EXPECT_EQ("hello", decoded);
+    }
+    {
+        /** Pooled buffers keep their capacity between borrowers */
+        const char* data = nullptr;
+        {
+            auto buffer = toolbox::BufferPool::acquire();
+            EXPECT_TRUE(buffer->empty());
+            buffer->assign(1000, 'x');
+            data = buffer->data();
+        }
+        auto buffer = toolbox::BufferPool::acquire();
+        EXPECT_TRUE(buffer->empty());
+        EXPECT_GE(buffer->capacity(), 1000u);
+        EXPECT_EQ(data, buffer->data());
+        auto encoder = toolbox::makeChunkStream(HexEncoder());
+        toolbox::process(encoder, "z"s, *buffer);
+        EXPECT_EQ("7a", *buffer);
+    }
+}
@@ -0,0 +1,183 @@
+#include "gtest/gtest.h"
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <toolbox/StructCodec.h>
+#include <vector>
+
+namespace
+{
+
+struct Point
+{
+    double x = 0;
+    double y = 0;
+};
+
+struct Line
+{
+    std::uint8_t colour = 0;
+    std::uint64_t id = 0;
+    std::int32_t width = 0;
+    std::int32_t style = 0;
+    std::string label;
+    std::vector<Point> points;
+    std::vector<std::string> tags;
+    Point origin;
+};
+
+TOOLBOX_FIELDS(Line, colour, id, width, style, label, points, tags, origin)
+
+struct Shape
+{
+    Line outline;
+    std::vector<Line> lines;
+};
+
+TOOLBOX_FIELDS(Shape, outline, lines)
+
+struct OrderV1
+{
+    std::uint64_t id = 0;
+    std::int64_t quantity = 0;
+};
+
+constexpr auto toolbox_fields(const OrderV1*)
+{
+    using namespace toolbox;
+    return std::tuple<Field<&OrderV1::id>,
+                      Field<&OrderV1::quantity, 1, FieldEncoding::varint>>();
+}
+
+struct OrderV2
+{
+    std::uint64_t id = 0;
+    std::int64_t quantity = 0;
+    std::string note = "none";
+    std::uint32_t flags = 7;
+};
+
+constexpr auto toolbox_fields(const OrderV2*)
+{
+    using namespace toolbox;
+    return std::tuple<Field<&OrderV2::id>,
+                      Field<&OrderV2::quantity, 1, FieldEncoding::varint>,
+                      Field<&OrderV2::note, 2>,
+                      Field<&OrderV2::flags, 2>>();
+}
+
+struct Request
+{
+    std::string_view method;
+    std::string_view path;
+};
+
+TOOLBOX_FIELDS(Request, method, path)
+
+enum class Kind : std::uint8_t
+{
+    plain,
+    bold
+};
+
+struct Style
+{
+    bool visible = false;
+    Kind kind = Kind::plain;
+    std::int8_t level = 0;
+};
+
+constexpr auto toolbox_fields(const Style*)
+{
+    using namespace toolbox;
+    return std::tuple<Field<&Style::visible>,
+                      Field<&Style::kind>,
+                      Field<&Style::level, 1, FieldEncoding::varint>>();
+}
+
+} // namespace
+
+TEST(Toolbox, StructCodec)
+{
+    auto line = Line{3, 42, -5, 9, "main", {{1, 2}, {3, 4}}, {"a", "bc"},
+                     {0.5, -0.5}};
+    {
+        auto codec = toolbox::makeStructCodec<Line>();
+        auto encoded = codec.encode(line);
+        EXPECT_EQ(codec.encoder().size(line), encoded.size());
+        /** Version, colour, then id to style copied as one run */
+        EXPECT_EQ(1 + 1 + 8 + 4 + 4 + 5 + 1 + 32 + 1 + 2 + 3 + 16,
+                  static_cast<int>(encoded.size()));
+        auto decoded = codec.decode(encoded);
+        EXPECT_EQ(line.colour, decoded.colour);
+        EXPECT_EQ(line.id, decoded.id);
+        EXPECT_EQ(line.width, decoded.width);
+        EXPECT_EQ(line.style, decoded.style);
+        EXPECT_EQ(line.label, decoded.label);
+        ASSERT_EQ(2u, decoded.points.size());
+        EXPECT_EQ(4, decoded.points[1].y);
+        EXPECT_EQ(line.tags, decoded.tags);
+        EXPECT_EQ(-0.5, decoded.origin.y);
+        EXPECT_THROW(codec.decode(encoded.substr(0, encoded.size() - 1)),
+                     std::invalid_argument);
+        EXPECT_THROW(codec.decode(std::string()), std::invalid_argument);
+    }
+    {
+        auto shape = Shape{line, {line, Line()}};
+        auto codec = toolbox::makeStructCodec<Shape>();
+        auto encoded = std::string("prefix");
+        codec.encoder()(shape, encoded);
+        auto decoded = Shape();
+        codec.decoder()(std::string_view(encoded).substr(6), decoded);
+        EXPECT_EQ("main", decoded.outline.label);
+        ASSERT_EQ(2u, decoded.lines.size());
+        EXPECT_EQ(42u, decoded.lines[0].id);
+        EXPECT_TRUE(decoded.lines[1].label.empty());
+    }
+    {
+        /** Old data leaves new fields at their defaults, and old code skips
+         * fields appended since */
+        auto v1 = toolbox::makeStructCodec<OrderV1>();
+        auto v2 = toolbox::makeStructCodec<OrderV2>();
+        auto old = v1.encode(OrderV1{5, -3});
+        EXPECT_EQ(1u + 8 + 1, old.size());
+        auto upgraded = v2.decode(old);
+        EXPECT_EQ(5u, upgraded.id);
+        EXPECT_EQ(-3, upgraded.quantity);
+        EXPECT_EQ("none", upgraded.note);
+        EXPECT_EQ(7u, upgraded.flags);
+        auto downgraded = v1.decode(v2.encode(OrderV2{6, 1000000, "x", 1}));
+        EXPECT_EQ(6u, downgraded.id);
+        EXPECT_EQ(1000000, downgraded.quantity);
+    }
+    {
+        auto codec = toolbox::makeStructCodec<Request>();
+        static_assert(decltype(codec)::decoder_type::views_input);
+        static_assert(!toolbox::StructDecoder<Line>::views_input);
+        auto encoded = codec.encode(Request{"GET", "/index.html"});
+        auto decoded = codec.decode(encoded);
+        EXPECT_EQ("GET", decoded.method);
+        EXPECT_EQ("/index.html", decoded.path);
+        EXPECT_GE(decoded.path.data(), encoded.data());
+        EXPECT_LT(decoded.path.data(), encoded.data() + encoded.size());
+    }
+    {
+        /** Bools and varints are checked as they are read */
+        using namespace std::string_literals;
+        auto codec = toolbox::makeStructCodec<Style>();
+        auto encoded = codec.encode(Style{true, Kind::bold, -2});
+        EXPECT_EQ("\x01\x01\x01\x03"s, encoded);
+        auto decoded = codec.decode(encoded);
+        EXPECT_TRUE(decoded.visible);
+        EXPECT_EQ(Kind::bold, decoded.kind);
+        EXPECT_EQ(-2, decoded.level);
+        EXPECT_THROW(codec.decode("\x01\x02\x01\x03"s),
+                     std::invalid_argument);
+        /** 300 doesn't fit an int8_t */
+        EXPECT_THROW(codec.decode("\x01\x01\x01\xd8\x04"s),
+                     std::invalid_argument);
+        auto overlong = "\x01\x01\x01"s + std::string(9, '\xff') + "\x02";
+        EXPECT_THROW(codec.decode(overlong), std::invalid_argument);
+    }
+}
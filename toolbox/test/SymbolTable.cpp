@@ -0,0 +1,74 @@
+#include "gtest/gtest.h"
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <toolbox/SequencePredicate.h>
+#include <toolbox/SymbolTable.h>
+#include <vector>
+
+TEST(Toolbox, SymbolTable)
+{
+    {
+        auto table = toolbox::SymbolTable(4);
+        EXPECT_EQ(0u, table.intern("home"));
+        EXPECT_EQ(1u, table.intern("user"));
+        EXPECT_EQ(0u, table.intern(std::string("home")));
+        EXPECT_EQ(1u, table.find("user"));
+        EXPECT_EQ(toolbox::SymbolTable::npos, table.find("etc"));
+        EXPECT_EQ(2u, table.size());
+        EXPECT_EQ("user", table.name(1));
+        EXPECT_THROW(table.name(2), std::out_of_range);
+    }
+    {
+        /** Patterns and inputs interned once match with integer compares */
+        auto table = toolbox::SymbolTable();
+        auto pattern = std::vector<std::string>{"/", "home", "/", "user"};
+        auto symbols = table.intern(pattern.begin(), pattern.end());
+        auto input = std::vector<std::string>{"/", "etc", "/", "home", "/",
+                                              "user", "/"};
+        auto stream = table.find(input.begin(), input.end());
+        EXPECT_EQ(toolbox::SymbolTable::npos, stream[1]);
+        auto predicate = toolbox::StreamingSequencePredicate<
+            std::vector<toolbox::Symbol>::const_iterator>(symbols.cbegin(),
+                                                          symbols.cend());
+        auto found = std::vector<std::size_t>();
+        for (auto symbol : stream)
+        {
+            if (predicate(symbol))
+            {
+                found.push_back(predicate.match_position());
+            }
+        }
+        EXPECT_EQ(std::vector<std::size_t>{2}, found);
+        EXPECT_EQ(3u, table.size());
+    }
+    {
+        /** Threads interning overlapping tokens agree on their symbols */
+        auto table = toolbox::SymbolTable();
+        auto results = std::vector<std::vector<toolbox::Symbol>>(8);
+        auto threads = std::vector<std::thread>();
+        for (auto t = 0u; t < results.size(); ++t)
+        {
+            threads.emplace_back([&table, &results, t] {
+                for (auto i = 0; i < 2000; ++i)
+                {
+                    auto token = std::to_string((i * (t + 1)) % 1000);
+                    results[t].push_back(table.intern(token));
+                }
+            });
+        }
+        for (auto& thread : threads)
+        {
+            thread.join();
+        }
+        EXPECT_EQ(1000u, table.size());
+        for (auto t = 0u; t < results.size(); ++t)
+        {
+            for (auto i = 0; i < 2000; ++i)
+            {
+                auto token = std::to_string((i * (t + 1)) % 1000);
+                ASSERT_EQ(token, table.name(results[t][i]));
+            }
+        }
+    }
+}